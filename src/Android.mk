@@ -29,8 +29,10 @@ LOCAL_SRC_FILES :=      am_map.c \
                         m_fixed.c \
                         m_menu.c \
                         m_misc.c \
+                        m_perfstats.c \
                         m_queue.c \
                         m_random.c \
+                        m_trace.c \
                         md5.c \
                         mserv.c \
                         p_ceilng.c \
@@ -58,6 +60,7 @@ LOCAL_SRC_FILES :=      am_map.c \
                         r_segs.c \
                         r_sky.c \
                         r_splats.c \
+                        r_fps.c \
                         r_things.c \
                         s_sound.c \
                         screen.c \
@@ -44,6 +44,7 @@
 #include "lua_script.h"
 #include "lua_hook.h"
 #include "md5.h"
+#include "m_trace.h"
 
 #ifndef NONET
 // cl loading screen
@@ -5382,6 +5383,8 @@ static void SV_Maketic(void)
 
 void TryRunTics(tic_t realtics)
 {
+	TRACE_BEGIN("TryRunTics");
+
 	// the machine has lagged but it is not so bad
 	if (realtics > TICRATE/7) // FIXME: consistency failure!!
 	{
@@ -5426,7 +5429,10 @@ void TryRunTics(tic_t realtics)
 #endif
 
 	if (player_joining)
+	{
+		TRACE_END();
 		return;
+	}
 
 	if (neededtic > gametic && !resynch_local_inprogress)
 	{
@@ -5444,12 +5450,14 @@ void TryRunTics(tic_t realtics)
 				DEBFILE(va("============ Running tic %d (local %d)\n", gametic, localgametic));
 
 				rs_tictime = I_GetTimeMicros();
+				TRACE_BEGIN("G_Ticker");
 
 				G_Ticker((gametic % NEWTICRATERATIO) == 0);
 				ExtraDataTicker();
 				gametic++;
 				consistancy[gametic%BACKUPTICS] = Consistancy();
 
+				TRACE_END();
 				rs_tictime = I_GetTimeMicros() - rs_tictime;
 
 				// Leave a certain amount of tics present in the net buffer as long as we've ran at least one tic this frame.
@@ -5457,6 +5465,8 @@ void TryRunTics(tic_t realtics)
 					break;
 			}
 	}
+
+	TRACE_END();
 }
 
 /*
@@ -5554,6 +5564,8 @@ void NetUpdate(void)
 
 	if (realtics <= 0) // nothing new to update
 		return;
+
+	TRACE_BEGIN("NetUpdate");
 	if (realtics > 5)
 	{
 		if (server)
@@ -5676,6 +5688,8 @@ void NetUpdate(void)
 	}
 
 	FileSendTicker();
+
+	TRACE_END();
 }
 
 /** Returns the number of players playing.
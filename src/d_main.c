@@ -30,11 +30,13 @@
 #endif
 
 #include <time.h>
+#include <math.h> // sqrt
 
 #include "doomdef.h"
 #include "am_map.h"
 #include "console.h"
 #include "d_net.h"
+#include "i_net.h" // I_NetWait
 #include "f_finale.h"
 #include "g_game.h"
 #include "hu_stuff.h"
@@ -49,6 +51,7 @@
 #include "p_saveg.h"
 #include "r_main.h"
 #include "r_local.h"
+#include "r_fps.h"
 #include "s_sound.h"
 #include "st_stuff.h"
 #include "v_video.h"
@@ -87,6 +90,7 @@
 #endif
 
 #include "lua_script.h"
+#include "m_trace.h"
 
 // Version numbers for netplay :upside_down_face:
 int    VERSION;
@@ -113,6 +117,15 @@ INT32 postimgparam;
 postimg_t postimgtype2 = postimg_none;
 INT32 postimgparam2;
 
+// How late each tic was started after it was due, for "ticjitter"
+static struct
+{
+	UINT32 count;
+	double sum, sumsq; // microseconds
+	int last, worst;
+	UINT32 numlate; // more than a millisecond late
+} ticjitter;
+
 // These variables are in effect
 // whether the respective sound system is disabled
 // or they're init'ed, but the player just toggled them
@@ -247,6 +260,8 @@ static void D_Display(void)
 	if (nodrawers)
 		return; // for comparative timing/profiling
 
+	TRACE_BEGIN("D_Display");
+
 	// Lactozilla: Switching renderers works by checking
 	// if the game has to do it right when the frame
 	// needs to render. If so, five things will happen:
@@ -436,6 +451,7 @@ static void D_Display(void)
 			if (!automapactive && !dedicated && cv_renderview.value)
 			{
 				rs_rendercalltime = I_GetTimeMicros();
+				R_ApplyLevelInterpolators();
 				if (players[displayplayer].mo || players[displayplayer].playerstate == PST_DEAD)
 				{
 					topleft = screens[0] + viewwindowy*vid.width + viewwindowx;
@@ -470,6 +486,7 @@ static void D_Display(void)
 						M_Memcpy(ylookup, ylookup1, viewheight*sizeof (ylookup[0]));
 					}
 				}
+				R_RestoreLevelInterpolators();
 
 				// Image postprocessing effect
 				if (rendermode == render_soft)
@@ -483,6 +500,9 @@ static void D_Display(void)
 						V_DoPostProcessor(1, postimgtype2, postimgparam2);
 				}
 				rs_rendercalltime = I_GetTimeMicros() - rs_rendercalltime;
+
+				if (renderingdemo)
+					G_HashRenderDemoFrame();
 			}
 
 			if (lastdraw)
@@ -704,22 +724,32 @@ static void D_Display(void)
 				V_DrawThinString(30, 50, V_MONOSPACE | V_YELLOWMAP, s);
 				snprintf(s, sizeof s - 1, "mskd %d", rs_sw_maskedtime / divisor);
 				V_DrawThinString(30, 60, V_MONOSPACE | V_YELLOWMAP, s);
-				snprintf(s, sizeof s - 1, "ui   %d", rs_uitime / divisor);
+				snprintf(s, sizeof s - 1, "ssrt %d", rs_sw_spritesorttime / divisor);
 				V_DrawThinString(30, 70, V_MONOSPACE | V_YELLOWMAP, s);
-				snprintf(s, sizeof s - 1, "fin  %d", rs_swaptime / divisor);
+				snprintf(s, sizeof s - 1, "ui   %d", rs_uitime / divisor);
 				V_DrawThinString(30, 80, V_MONOSPACE | V_YELLOWMAP, s);
+				snprintf(s, sizeof s - 1, "fin  %d", rs_swaptime / divisor);
+				V_DrawThinString(30, 90, V_MONOSPACE | V_YELLOWMAP, s);
 				snprintf(s, sizeof s - 1, "tic  %d", rs_tictime / divisor);
-				V_DrawThinString(30, 95, V_MONOSPACE | V_GRAYMAP, s);
+				V_DrawThinString(30, 105, V_MONOSPACE | V_GRAYMAP, s);
 			}
+			snprintf(s, sizeof s - 1, "late %d", ticjitter.last / divisor);
+			V_DrawThinString(30, 115, V_MONOSPACE | V_GRAYMAP, s);
 		}
 
 		rs_swaptime = I_GetTimeMicros();
-		I_FinishUpdate(); // page flip or blit buffer
+		if (!noblit)
+			I_FinishUpdate(); // page flip or blit buffer
 		rs_swaptime = I_GetTimeMicros() - rs_swaptime;
 	}
 
+	if (renderingdemo)
+		G_AddRenderDemoFrame();
+
 	needpatchflush = false;
 	needpatchrecache = false;
+
+	TRACE_END();
 }
 
 // Check the renderer's state
@@ -745,9 +775,109 @@ void D_CheckRendererState(void)
 
 tic_t rendergametic;
 
+static int lastframetime = 0; // when the last frame under the framerate cap was started
+
+// Whether it's time to draw another frame under the framerate cap
+static boolean D_FrameDue(void)
+{
+	const UINT32 cap = R_GetFramerateCap();
+	int now;
+
+	if (!cap)
+		return true;
+
+	now = I_GetTimeMicros();
+	if ((UINT32)(now - lastframetime) < 1000000 / cap)
+		return false;
+
+	lastframetime = now;
+	return true;
+}
+
+// When a tic is due, on the I_GetTimeMicros clock
+static int D_TicStartMicros(tic_t tic)
+{
+	return (int)(((UINT64)tic * 1000000 + NEWTICRATE - 1) / NEWTICRATE);
+}
+
+static void D_CountTicJitter(tic_t tic)
+{
+	INT32 late = (INT32)((UINT32)I_GetTimeMicros() - (UINT32)D_TicStartMicros(tic));
+
+	if (late < 0) // the clocks are read apart, so this can come out just under
+		late = 0;
+
+	ticjitter.count++;
+	ticjitter.sum += late;
+	ticjitter.sumsq += (double)late * late;
+	ticjitter.last = late;
+	if (late > ticjitter.worst)
+		ticjitter.worst = late;
+	if (late > 1000)
+		ticjitter.numlate++;
+}
+
+void Command_TicJitter_f(void)
+{
+	double mean, dev;
+
+	if (COM_Argc() > 1 && !strcasecmp(COM_Argv(1), "reset"))
+	{
+		memset(&ticjitter, 0, sizeof ticjitter);
+		CONS_Printf(M_GetText("Tic jitter stats reset.\n"));
+		return;
+	}
+
+	if (!ticjitter.count)
+	{
+		CONS_Printf(M_GetText("No tics counted yet.\n"));
+		return;
+	}
+
+	mean = ticjitter.sum / ticjitter.count;
+	dev = ticjitter.sumsq / ticjitter.count - mean * mean;
+	dev = (dev > 0.0) ? sqrt(dev) : 0.0;
+
+	CONS_Printf(M_GetText("Tic delivery over %u tics, in microseconds after each was due:\n"), ticjitter.count);
+	CONS_Printf(M_GetText("  mean %.1f, std dev %.1f, worst %d\n"), mean, dev, ticjitter.worst);
+	CONS_Printf(M_GetText("  %u tics (%.2f%%) over 1 ms late\n"), ticjitter.numlate, 100.0 * ticjitter.numlate / ticjitter.count);
+}
+
+// Sleeps until the next tic is due, or the next frame under the framerate
+// cap. Dedicated servers wait on their sockets instead, and return true
+// when a packet comes in so that it is handled right away.
+static boolean D_WaitForNextTic(tic_t entertic, boolean interp)
+{
+	int deadline = D_TicStartMicros(entertic + 1);
+	const UINT32 cap = R_GetFramerateCap();
+	INT32 left;
+
+	if (cv_sleep.value == -1) // never sleep
+		return false;
+
+	if (interp && cap)
+	{
+		int framedeadline = (int)((UINT32)lastframetime + 1000000 / cap);
+		if ((INT32)((UINT32)framedeadline - (UINT32)deadline) < 0)
+			deadline = framedeadline;
+	}
+
+	left = (INT32)((UINT32)deadline - (UINT32)I_GetTimeMicros());
+	if (left <= 0)
+		return false;
+
+	if (dedicated && I_NetWait)
+		return I_NetWait(left);
+
+	I_SleepUntilMicros(deadline);
+	return false;
+}
+
 void D_SRB2Loop(void)
 {
 	tic_t oldentertics = 0, entertic = 0, realtics = 0, rendertimeout = INFTICS;
+	tic_t lastgametic = 0, lastgameticentertic = 0;
+	boolean interp, framedue;
 	static lumpnum_t gstartuplumpnum;
 
 	if (dedicated)
@@ -808,6 +938,11 @@ void D_SRB2Loop(void)
 		realtics = entertic - oldentertics;
 		oldentertics = entertic;
 
+		// With frame interpolation, frames are drawn as often as the cap
+		// allows instead of once per tic
+		interp = R_UsingFrameInterpolation();
+		framedue = (interp && D_FrameDue());
+
 		refreshdirmenu = 0; // not sure where to put this, here as good as any?
 
 #ifdef DEBUGFILE
@@ -816,11 +951,19 @@ void D_SRB2Loop(void)
 				debugload--;
 #endif
 
-		if (!realtics && !singletics)
+		if (!realtics && !singletics && !framedue)
 		{
-			I_Sleep();
-			continue;
+			boolean wake;
+			TRACE_BEGIN("D_WaitForNextTic");
+			wake = D_WaitForNextTic(entertic, interp);
+			TRACE_END();
+			if (!wake)
+				continue;
 		}
+		else if (realtics)
+			D_CountTicJitter(entertic);
+
+		M_TraceFrame();
 
 #ifdef HW3SOUND
 		HW3S_BeginFrameUpdate();
@@ -834,7 +977,25 @@ void D_SRB2Loop(void)
 		// process tics (but maybe not if realtic == 0)
 		TryRunTics(realtics);
 
-		if (lastdraw || singletics || gametic > rendergametic)
+		if (interp)
+		{
+			if (gametic != lastgametic)
+			{
+				lastgametic = gametic;
+				lastgameticentertic = entertic;
+			}
+
+			// How far the clock is past the last tic that ran. If another one
+			// was due and didn't come (lag, a netgame stall), stay on the last.
+			if (I_GetTime() == lastgameticentertic)
+				rendertimefrac = I_GetTimeFrac();
+			else
+				rendertimefrac = FRACUNIT;
+		}
+		else
+			rendertimefrac = FRACUNIT;
+
+		if (lastdraw || singletics || (interp ? framedue : gametic > rendergametic))
 		{
 			rendergametic = gametic;
 			rendertimeout = entertic+TICRATE/17;
@@ -1464,7 +1625,7 @@ void D_SRB2Main(void)
 	R_Init();
 
 	// setting up sound
-	if (dedicated)
+	if (dedicated || M_CheckParm("-simdemo") || M_CheckParm("-renderdemo"))
 	{
 		sound_disabled = true;
 		midi_disabled = digital_disabled = true;
@@ -1551,6 +1712,10 @@ void D_SRB2Main(void)
 	p = M_CheckParm("-playdemo");
 	if (!p)
 		p = M_CheckParm("-timedemo");
+	if (!p)
+		p = M_CheckParm("-simdemo");
+	if (!p)
+		p = M_CheckParm("-renderdemo");
 	if (p && M_IsNextParm())
 	{
 		char tmp[MAX_WADPATH];
@@ -1575,6 +1740,10 @@ void D_SRB2Main(void)
 			singledemo = true; // quit after one demo
 			G_DeferedPlayDemo(tmp);
 		}
+		else if (M_CheckParm("-simdemo"))
+			G_SimulateDemo(tmp, (M_CheckParm("-simreport") && M_IsNextParm()) ? M_GetNextParm() : NULL);
+		else if (M_CheckParm("-renderdemo"))
+			G_RenderDemo(tmp, (M_CheckParm("-renderreport") && M_IsNextParm()) ? M_GetNextParm() : NULL);
 		else
 			G_TimeDemo(tmp);
 
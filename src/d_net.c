@@ -69,6 +69,7 @@ boolean (*I_NetGet)(void) = NULL;
 void (*I_NetSend)(void) = NULL;
 boolean (*I_NetCanSend)(void) = NULL;
 boolean (*I_NetCanGet)(void) = NULL;
+boolean (*I_NetWait)(int micros) = NULL;
 void (*I_NetCloseSocket)(void) = NULL;
 void (*I_NetFreeNodenum)(INT32 nodenum) = NULL;
 SINT8 (*I_NetMakeNodewPort)(const char *address, const char* port) = NULL;
@@ -1252,6 +1253,7 @@ boolean D_CheckNetGame(void)
 	I_NetGet = Internal_Get;
 	I_NetSend = Internal_Send;
 	I_NetCanSend = NULL;
+	I_NetWait = NULL;
 	I_NetCloseSocket = NULL;
 	I_NetFreeNodenum = Internal_FreeNodenum;
 	I_NetMakeNodewPort = NULL;
@@ -1444,6 +1446,7 @@ void D_CloseConnection(void)
 		I_NetGet = Internal_Get;
 		I_NetSend = Internal_Send;
 		I_NetCanSend = NULL;
+		I_NetWait = NULL;
 		I_NetCloseSocket = NULL;
 		I_NetFreeNodenum = Internal_FreeNodenum;
 		I_NetMakeNodewPort = NULL;
@@ -47,6 +47,7 @@
 #include "m_cond.h"
 #include "m_anigif.h"
 #include "md5.h"
+#include "m_trace.h"
 
 #ifdef NETGAME_DEVMODE
 #define CV_RESTRICT CV_NETVAR
@@ -590,6 +591,8 @@ void D_RegisterServerCommands(void)
 #endif
 
 	COM_AddCommand("ping", Command_Ping_f);
+	COM_AddCommand("ticjitter", Command_TicJitter_f);
+	COM_AddCommand("trace", Command_Trace_f);
 	CV_RegisterVar(&cv_nettimeout);
 	CV_RegisterVar(&cv_jointimeout);
 
@@ -637,6 +640,10 @@ void D_RegisterClientCommands(void)
 
 	COM_AddCommand("numthinkers", Command_Numthinkers_f);
 	COM_AddCommand("countmobjs", Command_CountMobjs_f);
+	COM_AddCommand("profilethinkers", Command_ProfileThinkers_f);
+	COM_AddCommand("profilehooks", Command_ProfileHooks_f);
+	CV_RegisterVar(&cv_hookbudget);
+	COM_AddCommand("sightstats", Command_Sightstats_f);
 
 	COM_AddCommand("changeteam", Command_Teamchange_f);
 	COM_AddCommand("changeteam2", Command_Teamchange2_f);
@@ -3314,11 +3321,9 @@ static void Command_Addfile(void)
 
 		if ((fhandle = W_OpenWadFile(&fn, true)) != NULL)
 		{
-			tic_t t = I_GetTime();
-			CONS_Debug(DBG_SETUP, "Making MD5 for %s\n",fn);
-			md5_stream(fhandle, md5sum);
-			CONS_Debug(DBG_SETUP, "MD5 calc for %s took %f second\n", fn, (float)(I_GetTime() - t)/TICRATE);
 			fclose(fhandle);
+			if (W_MakeFileMD5(fn, md5sum) != 0)
+				return;
 		}
 		else // file not found
 			return;
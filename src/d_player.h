@@ -327,6 +327,7 @@ typedef struct player_s
 	fixed_t shieldscale;
 	// Focal origin above r.z
 	fixed_t viewz;
+	fixed_t old_viewz; // at the start of the tic, for frame interpolation
 	// Base height above floor for viewz.
 	fixed_t viewheight;
 	// Bob/squat speed.
@@ -345,6 +346,7 @@ typedef struct player_s
 
 	// fun thing for player sprite
 	angle_t drawangle;
+	angle_t old_drawangle; // at the start of the tic
 
 	// player's ring count
 	INT16 rings;
@@ -2011,6 +2011,15 @@ static void readlevelheader(MYFILE *f, INT32 num)
 				mapheaderinfo[num-1]->ssspheres = i;
 			else if (fastcmp(word, "GRAVITY"))
 				mapheaderinfo[num-1]->gravity = FLOAT_TO_FIXED(atof(word2));
+			else if (fastcmp(word, "DORMANTRADIUS"))
+				mapheaderinfo[num-1]->dormantradius = (UINT16)i;
+			else if (fastcmp(word, "DORMANTSCENERY"))
+			{
+				if (i || word2[0] == 'T' || word2[0] == 'Y')
+					mapheaderinfo[num-1]->levelflags |= LF_DORMANTSCENERY;
+				else
+					mapheaderinfo[num-1]->levelflags &= ~LF_DORMANTSCENERY;
+			}
 			else
 				deh_warning("Level header %d: unknown word '%s'", num, word);
 		}
@@ -9007,6 +9016,7 @@ static const char *const MOBJFLAG_LIST[] = {
 	"NOCLIPTHING",
 	"GRENADEBOUNCE",
 	"RUNSPAWNFUNC",
+	"SLEEPABLE",
 	NULL
 };
 
@@ -9058,6 +9068,8 @@ static const char *const MOBJEFLAG_LIST[] = {
 	"SPRUNG", // Mobj was already sprung this tic
 	"APPLYPMOMZ", // Platform movement
 	"TRACERANGLE", // Compute and trigger on mobj angle relative to tracer
+	"DORMANT", // Too far away from every player to think
+	"WOKEN", // Woken up by something other than a player coming near
 	NULL
 };
 
@@ -9598,6 +9610,7 @@ struct {
 	{"LF_NOTITLECARDRECORDATTACK",LF_NOTITLECARDRECORDATTACK},
 	{"LF_NOTITLECARD",LF_NOTITLECARD},
 	{"LF_WARNINGTITLE",LF_WARNINGTITLE},
+	{"LF_DORMANTSCENERY",LF_DORMANTSCENERY},
 	// And map flags
 	{"LF2_HIDEINMENU",LF2_HIDEINMENU},
 	{"LF2_HIDEINSTATS",LF2_HIDEINSTATS},
@@ -10108,6 +10121,20 @@ static mobjtype_t get_mobjtype(const char *word)
 	return MT_NULL;
 }
 
+/** Gets the name of a mobj type, without the MT_ prefix.
+  *
+  * \param type The mobj type.
+  * \return Its name, or NULL for a freeslot that was never claimed.
+  */
+const char *DEH_GetMobjTypeName(INT32 type)
+{
+	if (type < 0 || type >= NUMMOBJTYPES)
+		return NULL;
+	if (type >= MT_FIRSTFREESLOT)
+		return FREE_MOBJS[type - MT_FIRSTFREESLOT];
+	return MOBJTYPE_LIST[type]+3;
+}
+
 static statenum_t get_state(const char *word)
 { // Returns the value of S_ enumerations
 	statenum_t i;
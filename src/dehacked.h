@@ -33,6 +33,7 @@ void DEH_LoadDehackedLumpPwad(UINT16 wad, UINT16 lump, boolean mainfile);
 void DEH_Check(void);
 
 fixed_t get_number(const char *word);
+const char *DEH_GetMobjTypeName(INT32 type);
 
 boolean LUA_SetLuaAction(void *state, const char *actiontocompare);
 const char *LUA_GetActionName(void *action);
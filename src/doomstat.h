@@ -335,6 +335,7 @@ typedef struct
 	INT32 sstimer;          ///< Timer for special stages.
 	UINT32 ssspheres;       ///< Sphere requirement in special stages.
 	fixed_t gravity;        ///< Map-wide gravity.
+	UINT16 dormantradius;   ///< Objects further than this from every player may go dormant, 0 to never.
 
 	// Title card.
 	char ltzzpatch[8];      ///< Zig zag patch.
@@ -381,6 +382,8 @@ typedef struct
 #define LF_NOTITLECARDRECORDATTACK (1<<10)
 #define LF_NOTITLECARD  (LF_NOTITLECARDFIRST|LF_NOTITLECARDRESPAWN|LF_NOTITLECARDRECORDATTACK) ///< Don't start the title card at all
 
+#define LF_DORMANTSCENERY (1<<11) ///< Scenery objects may go dormant, as if they were MF_SLEEPABLE
+
 #define LF2_HIDEINMENU     1 ///< Hide in the multiplayer menu
 #define LF2_HIDEINSTATS    2 ///< Hide in the statistics screen
 #define LF2_RECORDATTACK   4 ///< Show this map in Time Attack
@@ -21,6 +21,26 @@ int I_GetTimeMicros(void)
 	return 0;
 }
 
+UINT64 I_GetPreciseTime(void)
+{
+	return 0;
+}
+
+UINT64 I_GetPrecision(void)
+{
+	return 1000000;
+}
+
+fixed_t I_GetTimeFrac(void)
+{
+	return 0;
+}
+
+void I_SleepUntilMicros(int deadline)
+{
+	(void)deadline;
+}
+
 void I_Sleep(void){}
 
 void I_GetEvent(void){}
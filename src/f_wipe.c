@@ -536,6 +536,10 @@ void F_RunWipe(UINT8 wipetype, boolean drawMenu)
 	UINT8 wipeframe = 0;
 	fademask_t *fmask;
 
+	// Nobody would see it, so don't wait for it either
+	if (noblit)
+		return;
+
 	if (!paldiv)
 		paldiv = FixedDiv(257<<FRACBITS, 11<<FRACBITS);
 
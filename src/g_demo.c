@@ -38,8 +38,12 @@
 #include "v_video.h"
 #include "lua_hook.h"
 #include "md5.h" // demo checksums
+#include "m_perfstats.h"
+#include "dehacked.h" // DEH_GetMobjTypeName
 
 boolean timingdemo; // if true, exit with report on completion
+boolean simulatingdemo; // if true, nothing is drawn and the game logic is measured
+boolean renderingdemo; // if true, frames are measured and hashed but not shown
 boolean nodrawers; // for comparative timing purposes
 boolean noblit; // for comparative timing purposes
 tic_t demostarttime; // for comparative timing purposes
@@ -2281,6 +2285,335 @@ void G_TimeDemo(const char *name)
 	G_DeferedPlayDemo(name);
 }
 
+//
+// G_SimulateDemo
+// Plays a demo back as fast as it will go with nothing drawn, measuring
+// only the game logic, then writes a report and quits.
+//
+static struct
+{
+	char demo[256];
+	char report[MAX_WADPATH];
+	int starttime; // microseconds, when the demo started
+
+	int ticstart; // microseconds, when the current P_Ticker started
+	UINT32 ticblocks, ticobjects; // allocation counts then
+	UINT64 ticbytes;
+
+	perfseries_t tictime; // microseconds spent in each P_Ticker
+	perfseries_t blocks; // zone blocks allocated by each P_Ticker
+	perfseries_t objects; // pooled objects handed out by each P_Ticker
+	UINT64 bytes; // total size of the zone blocks
+
+	UINT32 thinkerpeak[NUM_THINKERLISTS];
+	UINT64 thinkersum[NUM_THINKERLISTS];
+	UINT32 mobjpeak[NUMMOBJTYPES];
+	UINT64 mobjsum[NUMMOBJTYPES];
+} simstats;
+
+static const char *const thinkerlistnames[NUM_THINKERLISTS] = {"polyobj", "main", "mobj", "dynslope"};
+
+void G_SimulateDemo(const char *name, const char *reportpath)
+{
+	M_PerfSeriesFree(&simstats.tictime);
+	M_PerfSeriesFree(&simstats.blocks);
+	M_PerfSeriesFree(&simstats.objects);
+	memset(&simstats, 0, sizeof simstats);
+
+	strlcpy(simstats.demo, name, sizeof simstats.demo);
+	if (reportpath)
+		strlcpy(simstats.report, reportpath, sizeof simstats.report);
+	else
+		snprintf(simstats.report, sizeof simstats.report, "%s"PATHSEP"%s", srb2home, "simdemo.json");
+
+	nodrawers = noblit = true;
+	simulatingdemo = true;
+	singledemo = true;
+	singletics = true;
+	simstats.starttime = I_GetTimeMicros();
+	G_DeferedPlayDemo(name);
+}
+
+/** Called by G_Ticker before P_Ticker when simulating a demo.
+  */
+void G_StartSimulationTic(void)
+{
+	Z_GetAllocCounts(&simstats.ticblocks, &simstats.ticbytes, &simstats.ticobjects);
+	simstats.ticstart = I_GetTimeMicros();
+}
+
+/** Called by G_Ticker after P_Ticker when simulating a demo. Only the
+  * P_Ticker itself is timed; counting what is in the level is not.
+  */
+void G_EndSimulationTic(void)
+{
+	UINT32 time = (UINT32)(I_GetTimeMicros() - simstats.ticstart);
+	UINT32 blocks, objects, count[NUM_THINKERLISTS];
+	UINT64 bytes;
+	static UINT32 mobjcount[NUMMOBJTYPES];
+	thinker_t *th;
+	INT32 i;
+
+	Z_GetAllocCounts(&blocks, &bytes, &objects);
+	M_PerfSeriesAdd(&simstats.tictime, time);
+	M_PerfSeriesAdd(&simstats.blocks, blocks - simstats.ticblocks);
+	M_PerfSeriesAdd(&simstats.objects, objects - simstats.ticobjects);
+	simstats.bytes += bytes - simstats.ticbytes;
+
+	memset(mobjcount, 0, sizeof mobjcount);
+	for (i = 0; i < NUM_THINKERLISTS; i++)
+	{
+		count[i] = 0;
+		for (th = thlist[i].next; th != &thlist[i]; th = th->next)
+		{
+			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
+				continue;
+			count[i]++;
+			if (i == THINK_MOBJ && ((mobj_t *)th)->type < NUMMOBJTYPES)
+				mobjcount[((mobj_t *)th)->type]++;
+		}
+		simstats.thinkersum[i] += count[i];
+		if (count[i] > simstats.thinkerpeak[i])
+			simstats.thinkerpeak[i] = count[i];
+	}
+
+	for (i = 0; i < NUMMOBJTYPES; i++)
+	{
+		simstats.mobjsum[i] += mobjcount[i];
+		if (mobjcount[i] > simstats.mobjpeak[i])
+			simstats.mobjpeak[i] = mobjcount[i];
+	}
+}
+
+static void G_WriteSimulationReport(FILE *f, const perfsummary_t *tictime, const perfsummary_t *blocks, const perfsummary_t *objects, double seconds)
+{
+	const double tics = tictime->count ? (double)tictime->count : 1.0;
+	boolean first = true;
+	INT32 i;
+
+	fputs("{\n\t\"demo\": ", f);
+	M_PerfWriteJSONString(f, simstats.demo);
+	fprintf(f, ",\n\t\"version\": \"%s\",\n", VERSIONSTRING);
+	fprintf(f, "\t\"tics\": %s,\n\t\"seconds\": %.3f,\n", sizeu1(tictime->count), seconds);
+	fputs("\t\"ticker_us\": ", f);
+	M_PerfWriteJSONSummary(f, tictime);
+	fputs(",\n\t\"zone_blocks_per_tic\": ", f);
+	M_PerfWriteJSONSummary(f, blocks);
+	fprintf(f, ",\n\t\"zone_bytes\": %.0f,\n", (double)simstats.bytes);
+	fputs("\t\"pool_objects_per_tic\": ", f);
+	M_PerfWriteJSONSummary(f, objects);
+
+	fputs(",\n\t\"thinkers\": {", f);
+	for (i = 0; i < NUM_THINKERLISTS; i++)
+		fprintf(f, "%s\n\t\t\"%s\": {\"peak\": %u, \"mean\": %.2f}", i ? "," : "",
+			thinkerlistnames[i], simstats.thinkerpeak[i], simstats.thinkersum[i] / tics);
+
+	fputs("\n\t},\n\t\"mobjs\": [", f);
+	for (i = 0; i < NUMMOBJTYPES; i++)
+	{
+		const char *mtname = DEH_GetMobjTypeName(i);
+		if (!simstats.mobjpeak[i])
+			continue;
+		fprintf(f, "%s\n\t\t{\"type\": %d, \"name\": ", first ? "" : ",", i);
+		M_PerfWriteJSONString(f, mtname ? va("MT_%s", mtname) : "");
+		fprintf(f, ", \"peak\": %u, \"mean\": %.2f}", simstats.mobjpeak[i], simstats.mobjsum[i] / tics);
+		first = false;
+	}
+	fputs("\n\t]\n}\n", f);
+}
+
+// Stops simulating a demo, reports and quits.
+static void G_StopSimulatingDemo(void)
+{
+	perfsummary_t tictime, blocks, objects;
+	const double seconds = (UINT32)(I_GetTimeMicros() - simstats.starttime) / 1000000.0;
+	FILE *f;
+
+	G_StopDemo();
+
+	M_PerfSeriesSummarize(&simstats.tictime, &tictime);
+	M_PerfSeriesSummarize(&simstats.blocks, &blocks);
+	M_PerfSeriesSummarize(&simstats.objects, &objects);
+
+	CONS_Printf(M_GetText("simulated %s tics in %.3f seconds\n"), sizeu1(tictime.count), seconds);
+	CONS_Printf(M_GetText("P_Ticker: p50 %u us, p95 %u us, p99 %u us, max %u us, mean %.1f us\n"),
+		tictime.p50, tictime.p95, tictime.p99, tictime.max, tictime.mean);
+	CONS_Printf(M_GetText("allocations per tic: %.1f zone blocks, %.1f pooled objects\n"),
+		blocks.mean, objects.mean);
+
+	f = fopen(simstats.report, "w");
+	if (f)
+	{
+		G_WriteSimulationReport(f, &tictime, &blocks, &objects, seconds);
+		fclose(f);
+		CONS_Printf("Simulation results saved to '%s'\n", simstats.report);
+	}
+	else
+		CONS_Alert(CONS_ERROR, M_GetText("Couldn't write simulation results to '%s'\n"), simstats.report);
+
+	M_PerfSeriesFree(&simstats.tictime);
+	M_PerfSeriesFree(&simstats.blocks);
+	M_PerfSeriesFree(&simstats.objects);
+	I_Quit();
+}
+
+//
+// G_RenderDemo
+// Plays a demo back drawing one frame per tic with the software renderer,
+// without showing them, and measures each stage of drawing the view.
+// Every frame is hashed so that two builds can be checked for drawing
+// exactly the same thing. Writes a report and quits at the end.
+//
+enum
+{
+	RSTAT_RENDER, // the whole view, postprocessing included
+	RSTAT_BSP,
+	RSTAT_PORTAL,
+	RSTAT_PLANE,
+	RSTAT_MASKED,
+	RSTAT_SPRITESORT,
+	RSTAT_UI,
+	RSTAT_TIC,
+	RSTAT_NUMBSPCALLS,
+	RSTAT_NUMSPRITES,
+	RSTAT_NUMDRAWNODES,
+	RSTAT_NUMPOLYOBJECTS,
+	NUMRSTATS
+};
+
+static const char *const renderstatnames[NUMRSTATS] = {
+	"render_us", "bsp_us", "portal_us", "plane_us", "masked_us", "spritesort_us", "ui_us", "tic_us",
+	"bspcalls", "sprites", "drawnodes", "polyobjects"
+};
+
+static struct
+{
+	char demo[256];
+	char report[MAX_WADPATH];
+	int starttime; // microseconds, when the demo started
+
+	boolean drawn; // the view was drawn this frame
+	UINT32 hash; // of what it looked like
+
+	perfseries_t stats[NUMRSTATS];
+	perfseries_t hashes; // one per frame
+} renderbench;
+
+static void G_FreeRenderDemoStats(void)
+{
+	INT32 i;
+	for (i = 0; i < NUMRSTATS; i++)
+		M_PerfSeriesFree(&renderbench.stats[i]);
+	M_PerfSeriesFree(&renderbench.hashes);
+}
+
+void G_RenderDemo(const char *name, const char *reportpath)
+{
+	G_FreeRenderDemoStats();
+	memset(&renderbench, 0, sizeof renderbench);
+
+	strlcpy(renderbench.demo, name, sizeof renderbench.demo);
+	if (reportpath)
+		strlcpy(renderbench.report, reportpath, sizeof renderbench.report);
+	else
+		snprintf(renderbench.report, sizeof renderbench.report, "%s"PATHSEP"%s", srb2home, "renderdemo.json");
+
+	nodrawers = false;
+	noblit = true;
+	renderingdemo = true;
+	singledemo = true;
+	singletics = true;
+	renderbench.starttime = I_GetTimeMicros();
+	G_DeferedPlayDemo(name);
+}
+
+/** Called by D_Display once the view has been drawn, before anything is
+  * drawn over it.
+  */
+void G_HashRenderDemoFrame(void)
+{
+	if (rendermode != render_soft)
+		return;
+	renderbench.hash = M_PerfHashBuffer(screens[0], vid.width * vid.height * vid.bpp);
+	renderbench.drawn = true;
+}
+
+/** Called by D_Display at the end of every frame, to record the
+  * frame if the view was drawn.
+  */
+void G_AddRenderDemoFrame(void)
+{
+	const INT32 values[NUMRSTATS] = {
+		rs_rendercalltime, rs_bsptime, rs_sw_portaltime, rs_sw_planetime, rs_sw_maskedtime, rs_sw_spritesorttime, rs_uitime, rs_tictime,
+		rs_numbspcalls, rs_numsprites, rs_numdrawnodes, rs_numpolyobjects
+	};
+	INT32 i;
+
+	if (!renderbench.drawn)
+		return;
+	renderbench.drawn = false;
+
+	for (i = 0; i < NUMRSTATS; i++)
+		M_PerfSeriesAdd(&renderbench.stats[i], (UINT32)max(values[i], 0));
+	M_PerfSeriesAdd(&renderbench.hashes, renderbench.hash);
+}
+
+static void G_WriteRenderReport(FILE *f, double seconds, UINT32 allframes)
+{
+	perfsummary_t sum;
+	size_t i;
+
+	fputs("{\n\t\"demo\": ", f);
+	M_PerfWriteJSONString(f, renderbench.demo);
+	fprintf(f, ",\n\t\"version\": \"%s\",\n", VERSIONSTRING);
+	fprintf(f, "\t\"width\": %d,\n\t\"height\": %d,\n", vid.width, vid.height);
+	fprintf(f, "\t\"frames\": %s,\n\t\"seconds\": %.3f,\n", sizeu1(renderbench.hashes.count), seconds);
+	fprintf(f, "\t\"hash\": \"%08x\",\n", allframes);
+
+	for (i = 0; i < NUMRSTATS; i++)
+	{
+		M_PerfSeriesSummarize(&renderbench.stats[i], &sum);
+		fprintf(f, "\t\"%s\": ", renderstatnames[i]);
+		M_PerfWriteJSONSummary(f, &sum);
+		fputs(",\n", f);
+	}
+
+	fputs("\t\"frame_hashes\": [", f);
+	for (i = 0; i < renderbench.hashes.count; i++)
+		fprintf(f, "%s\"%08x\"", (i % 8) ? ", " : (i ? ",\n\t\t" : "\n\t\t"), renderbench.hashes.samples[i]);
+	fputs("\n\t]\n}\n", f);
+}
+
+// Stops rendering a demo, reports and quits.
+static void G_StopRenderingDemo(void)
+{
+	perfsummary_t render;
+	const double seconds = (UINT32)(I_GetTimeMicros() - renderbench.starttime) / 1000000.0;
+	const UINT32 allframes = M_PerfHashBuffer((UINT8 *)renderbench.hashes.samples, renderbench.hashes.count * sizeof (UINT32));
+	FILE *f;
+
+	G_StopDemo();
+
+	M_PerfSeriesSummarize(&renderbench.stats[RSTAT_RENDER], &render);
+	CONS_Printf(M_GetText("rendered %s frames at %dx%d in %.3f seconds, hash %08x\n"),
+		sizeu1(render.count), vid.width, vid.height, seconds, allframes);
+	CONS_Printf(M_GetText("view: p50 %u us, p95 %u us, p99 %u us, max %u us, mean %.1f us\n"),
+		render.p50, render.p95, render.p99, render.max, render.mean);
+
+	f = fopen(renderbench.report, "w");
+	if (f)
+	{
+		G_WriteRenderReport(f, seconds, allframes);
+		fclose(f);
+		CONS_Printf("Rendering results saved to '%s'\n", renderbench.report);
+	}
+	else
+		CONS_Alert(CONS_ERROR, M_GetText("Couldn't write rendering results to '%s'\n"), renderbench.report);
+
+	G_FreeRenderDemoStats();
+	I_Quit();
+}
+
 void G_DoPlayMetal(void)
 {
 	lumpnum_t l;
@@ -2493,6 +2826,8 @@ void G_StopDemo(void)
 	demoplayback = false;
 	titledemo = false;
 	timingdemo = false;
+	simulatingdemo = false;
+	renderingdemo = false;
 	singletics = false;
 
 	if (gamestate == GS_INTERMISSION)
@@ -2510,6 +2845,18 @@ boolean G_CheckDemoStatus(void)
 
 	// DO NOT end metal sonic demos here
 
+	if (simulatingdemo)
+	{
+		G_StopSimulatingDemo();
+		return true;
+	}
+
+	if (renderingdemo)
+	{
+		G_StopRenderingDemo();
+		return true;
+	}
+
 	if (timingdemo)
 	{
 		G_StopTimingDemo();
@@ -23,7 +23,7 @@
 // ======================================
 
 // demoplaying back and demo recording
-extern boolean demoplayback, titledemo, demorecording, timingdemo;
+extern boolean demoplayback, titledemo, demorecording, timingdemo, simulatingdemo, renderingdemo;
 extern tic_t demostarttime;
 
 // Quit after playing a demo from cmdline.
@@ -74,6 +74,12 @@ void G_LoadMetal(UINT8 **buffer);
 void G_DeferedPlayDemo(const char *demo);
 void G_DoPlayDemo(char *defdemoname);
 void G_TimeDemo(const char *name);
+void G_SimulateDemo(const char *name, const char *reportpath);
+void G_StartSimulationTic(void);
+void G_EndSimulationTic(void);
+void G_RenderDemo(const char *name, const char *reportpath);
+void G_HashRenderDemoFrame(void);
+void G_AddRenderDemoFrame(void);
 void G_AddGhost(char *defdemoname);
 void G_FreeGhosts(void);
 void G_DoPlayMetal(void);
@@ -2263,7 +2263,14 @@ void G_Ticker(boolean run)
 		case GS_LEVEL:
 			if (titledemo)
 				F_TitleDemoTicker();
-			P_Ticker(run); // tic the game
+			if (simulatingdemo)
+			{
+				G_StartSimulationTic();
+				P_Ticker(run); // tic the game
+				G_EndSimulationTic();
+			}
+			else
+				P_Ticker(run); // tic the game
 			ST_Ticker(run);
 			F_TextPromptTicker();
 			AM_Ticker();
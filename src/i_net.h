@@ -91,6 +91,14 @@ extern boolean (*I_NetGet)(void);
 */
 extern boolean (*I_NetCanGet)(void);
 
+/**	\brief	wait for a packet to come in, for at most the given time
+
+	\param	micros	longest time to wait, in microseconds
+
+	\return	true if a packet is waiting
+*/
+extern boolean (*I_NetWait)(int micros);
+
 /**	\brief send packet within doomcom struct
 */
 extern void (*I_NetSend)(void);
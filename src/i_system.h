@@ -48,6 +48,30 @@ tic_t I_GetTime(void);
 
 int I_GetTimeMicros(void);// provides microsecond counter for render stats
 
+/**	\brief	How far into the current tic the time is, for frame interpolation
+
+	\return	fraction of a tic, from 0 to FRACUNIT-1
+*/
+fixed_t I_GetTimeFrac(void);
+
+/**	\brief	A high resolution counter, for timing stretches of code too short
+	for I_GetTimeMicros
+
+	\return	counter ticks, I_GetPrecision of them per second
+*/
+UINT64 I_GetPreciseTime(void);
+
+/**	\brief	How many I_GetPreciseTime ticks there are in a second
+*/
+UINT64 I_GetPrecision(void);
+
+/**	\brief	Sleeps until I_GetTimeMicros reaches a deadline, with better than
+	millisecond precision where the system allows
+
+	\param	deadline	time to wake up at, on the I_GetTimeMicros clock
+*/
+void I_SleepUntilMicros(int deadline);
+
 /**	\brief	The I_Sleep function
 
 	\return	void
@@ -668,6 +668,38 @@ static boolean SOCK_CanGet(void)
 	return false;
 }
 #endif
+
+// Blocks in select until one of the sockets has a packet, so an idle server
+// uses no CPU but still answers right away
+static boolean SOCK_Wait(int micros)
+{
+	struct timeval timeout;
+	fd_set tset;
+	SOCKET_TYPE maxsocket = 0;
+	boolean any = false;
+	size_t i;
+
+	FD_ZERO(&tset);
+	for (i = 0; i < mysocketses; i++)
+	{
+		if (mysockets[i] == (SOCKET_TYPE)ERRSOCKET)
+			continue;
+		FD_SET(mysockets[i], &tset);
+		if (mysockets[i] > maxsocket)
+			maxsocket = mysockets[i];
+		any = true;
+	}
+
+	if (!any)
+	{
+		I_SleepUntilMicros((int)((UINT32)I_GetTimeMicros() + (UINT32)micros));
+		return false;
+	}
+
+	timeout.tv_sec = micros / 1000000;
+	timeout.tv_usec = micros % 1000000;
+	return (select((int)maxsocket + 1, &tset, NULL, NULL, &timeout) > 0);
+}
 #endif
 
 #ifndef NONET
@@ -1309,6 +1341,7 @@ static boolean SOCK_OpenSocket(void)
 	nodeconnected[BROADCASTADDR] = true;
 	I_NetSend = SOCK_Send;
 	I_NetGet = SOCK_Get;
+	I_NetWait = SOCK_Wait;
 	I_NetCloseSocket = SOCK_CloseSocket;
 	I_NetFreeNodenum = SOCK_FreeNodenum;
 	I_NetMakeNodewPort = SOCK_NetMakeNodewPort;
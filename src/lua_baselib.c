@@ -574,6 +574,17 @@ static int lib_pRemoveMobj(lua_State *L)
 	return 0;
 }
 
+static int lib_pWakeMobj(lua_State *L)
+{
+	mobj_t *mobj = *((mobj_t **)luaL_checkudata(L, 1, META_MOBJ));
+	NOHUD
+	INLEVEL
+	if (!mobj)
+		return LUA_ErrInvalid(L, "mobj_t");
+	P_WakeMobj(mobj);
+	return 0;
+}
+
 // P_IsValidSprite2 technically doesn't exist, and probably never should... but too much would need to be exposed to allow this to be checked by other methods.
 
 static int lib_pIsValidSprite2(lua_State *L)
@@ -3469,6 +3480,7 @@ static luaL_Reg lib[] = {
 	{"P_SpawnMobj",lib_pSpawnMobj},
 	{"P_SpawnMobjFromMobj",lib_pSpawnMobjFromMobj},
 	{"P_RemoveMobj",lib_pRemoveMobj},
+	{"P_WakeMobj",lib_pWakeMobj},
 	{"P_IsValidSprite2", lib_pIsValidSprite2},
 	{"P_SpawnLockOn", lib_pSpawnLockOn},
 	{"P_SpawnMissile",lib_pSpawnMissile},
@@ -113,4 +113,8 @@ boolean LUAh_SeenPlayer(player_t *player, player_t *seenfriend); // Hook for MT_
 #endif
 #define LUAh_PlayerThink(player) LUAh_PlayerHook(player, hook_PlayerThink) // Hook for P_PlayerThink
 boolean LUAh_ShouldJingleContinue(player_t *player, const char *musname); // Hook for whether a jingle of the given music should continue playing
-void LUAh_GameQuit(void); // Hook for game quitting
\ No newline at end of file
+void LUAh_GameQuit(void); // Hook for game quitting
+
+extern consvar_t cv_hookbudget;
+void LUAh_CheckHookBudget(void); // Warns about hooks going over cv_hookbudget, at the end of each tic
+void Command_ProfileHooks_f(void);
\ No newline at end of file
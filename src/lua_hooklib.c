@@ -17,11 +17,14 @@
 #include "r_skins.h"
 #include "b_bot.h"
 #include "z_zone.h"
+#include "p_local.h" // thinkerprofiling
+#include "i_system.h" // I_GetPreciseTime
 
 #include "lua_script.h"
 #include "lua_libs.h"
 #include "lua_hook.h"
 #include "lua_hud.h" // hud_running errors
+#include "m_trace.h"
 
 static UINT8 hooksAvailable[(hook_MAX/8)+1];
 
@@ -85,6 +88,10 @@ struct hook_s
 		char *str;
 	} s;
 	boolean error;
+
+	// measured while profiling, or when there is a budget
+	UINT32 calls;
+	UINT64 time, maxtime; // in I_GetPreciseTime ticks
 };
 typedef struct hook_s* hook_p;
 
@@ -115,10 +122,274 @@ static void PushHook(lua_State *L, hook_p hookp)
 	lua_gettable(L, LUA_REGISTRYINDEX);
 }
 
+//
+// Hook profiling
+//
+// While "profilehooks" is on, or hookbudget is set, every hook call is
+// timed and the time added up on the hook itself. Hooks called from other
+// hooks count towards both, but only once towards the tic's total.
+//
+
+static boolean hookprofiling = false;
+
+static void HookBudget_OnChange(void);
+consvar_t cv_hookbudget = {"hookbudget", "0", CV_CALL, CV_Unsigned, HookBudget_OnChange, 0, NULL, NULL, 0, 0, NULL};
+
+static UINT32 hookdepth; // hooks being called right now
+static UINT64 tichooktime; // spent in hooks this tic
+static hook_p tichookworst; // the slowest hook this tic
+static UINT64 tichookworsttime;
+static tic_t lastbudgetwarning;
+
+static void ResetHookProfile(hook_p hookp)
+{
+	for (; hookp; hookp = hookp->next)
+		hookp->calls = 0, hookp->time = hookp->maxtime = 0;
+}
+
+// Calls fn on every hook there is
+static void IterateHooks(void (*fn)(hook_p))
+{
+	INT32 i;
+	for (i = 0; i < NUMMOBJTYPES; i++)
+	{
+		fn(mobjthinkerhooks[i]);
+		fn(mobjcollidehooks[i]);
+		fn(mobjhooks[i]);
+	}
+	fn(playerhooks);
+	fn(linedefexecutorhooks);
+	fn(roothook);
+}
+
+static void HookBudget_OnChange(void)
+{
+	if (!hookprofiling)
+		IterateHooks(ResetHookProfile);
+}
+
+// Calls the hook pushed by PushHook, with the error handler at index 1.
+// Every hook but NetVars is called through here.
+static int CallHook(hook_p hookp, int nargs, int nresults)
+{
+	UINT64 start, time;
+	int err;
+
+	TRACE_BEGIN(hookNames[hookp->type]);
+
+	if (!hookprofiling && !cv_hookbudget.value)
+	{
+		err = lua_pcall(gL, nargs, nresults, 1);
+		TRACE_END();
+		return err;
+	}
+
+	hookdepth++;
+	start = I_GetPreciseTime();
+	err = lua_pcall(gL, nargs, nresults, 1);
+	time = I_GetPreciseTime() - start;
+	hookdepth--;
+
+	hookp->calls++;
+	hookp->time += time;
+	if (time > hookp->maxtime)
+		hookp->maxtime = time;
+
+	if (!hookdepth)
+	{
+		tichooktime += time;
+		if (time > tichookworsttime)
+		{
+			tichookworst = hookp;
+			tichookworsttime = time;
+		}
+	}
+
+	TRACE_END();
+	return err;
+}
+
+static double PreciseToMicros(UINT64 time)
+{
+	const UINT64 precision = I_GetPrecision();
+	return (double)time * 1000000.0 / (double)precision;
+}
+
+// Where the hook's function was defined
+static const char *GetHookSource(hook_p hookp, INT32 *line)
+{
+	static char source[LUA_IDSIZE];
+	lua_Debug ar;
+
+	PushHook(gL, hookp);
+	if (!lua_isfunction(gL, -1))
+	{
+		lua_pop(gL, 1);
+		*line = 0;
+		return "?";
+	}
+	lua_getinfo(gL, ">S", &ar); // pops the function
+	strlcpy(source, ar.short_src, sizeof source);
+	*line = ar.linedefined;
+	return source;
+}
+
+/** Warns when the hooks run this tic took longer than hookbudget
+  * microseconds. Called by P_Ticker at the end of every tic.
+  */
+void LUAh_CheckHookBudget(void)
+{
+	if (cv_hookbudget.value && gL && tichookworst
+	&& PreciseToMicros(tichooktime) > cv_hookbudget.value
+	&& (!lastbudgetwarning || gametic - lastbudgetwarning >= TICRATE)) // once a second at most
+	{
+		INT32 line;
+		const char *source = GetHookSource(tichookworst, &line);
+		CONS_Alert(CONS_WARNING, M_GetText("Lua hooks took %.0f us this tic, over the %d us budget. Slowest: %s at %s:%d, %.0f us\n"),
+			PreciseToMicros(tichooktime), cv_hookbudget.value, hookNames[tichookworst->type], source, line, PreciseToMicros(tichookworsttime));
+		lastbudgetwarning = gametic;
+	}
+
+	tichooktime = tichookworsttime = 0;
+	tichookworst = NULL;
+}
+
+static hook_p *sortedhooks;
+static size_t numsortedhooks;
+
+static void CollectHooks(hook_p hookp)
+{
+	for (; hookp; hookp = hookp->next)
+		if (hookp->calls)
+		{
+			if (sortedhooks)
+				sortedhooks[numsortedhooks] = hookp;
+			numsortedhooks++;
+		}
+}
+
+// Sorted by total time, highest first
+static int CompareHooks(const void *a, const void *b)
+{
+	const UINT64 x = (*(const hook_p *)a)->time, y = (*(const hook_p *)b)->time;
+	return (x < y) - (x > y);
+}
+
+static void ShowHookProfile(INT32 count)
+{
+	struct
+	{
+		char source[LUA_IDSIZE];
+		UINT64 time;
+		UINT32 calls;
+	} *addons;
+	size_t i, j, numaddons = 0;
+
+	if (!gL)
+		return;
+
+	// Count them, then gather them
+	sortedhooks = NULL;
+	numsortedhooks = 0;
+	IterateHooks(CollectHooks);
+	if (!numsortedhooks)
+	{
+		CONS_Printf(M_GetText("No hooks have run yet.\n"));
+		return;
+	}
+	sortedhooks = malloc(numsortedhooks * sizeof *sortedhooks);
+	addons = malloc((numsortedhooks + 1) * sizeof *addons); // one spare, for sorting
+	if (!sortedhooks || !addons)
+	{
+		free(sortedhooks);
+		free(addons);
+		sortedhooks = NULL;
+		return;
+	}
+	numsortedhooks = 0;
+	IterateHooks(CollectHooks);
+	qsort(sortedhooks, numsortedhooks, sizeof *sortedhooks, CompareHooks);
+
+	CONS_Printf(M_GetText("Lua hook time, in microseconds:\n"));
+	CONS_Printf("  %-20s %-28s %9s %10s %8s %8s\n", "hook", "function", "calls", "total", "per call", "max");
+	for (i = 0; i < numsortedhooks; i++)
+	{
+		const hook_p hookp = sortedhooks[i];
+		INT32 line;
+		const char *source = GetHookSource(hookp, &line);
+
+		// Add it up by the script it came from
+		for (j = 0; j < numaddons; j++)
+			if (!strcmp(addons[j].source, source))
+				break;
+		if (j == numaddons)
+		{
+			strlcpy(addons[j].source, source, sizeof addons[j].source);
+			addons[j].time = 0;
+			addons[j].calls = 0;
+			numaddons++;
+		}
+		addons[j].time += hookp->time;
+		addons[j].calls += hookp->calls;
+
+		if (i < (size_t)count)
+			CONS_Printf("  %-20s %-28s %9u %10.0f %8.2f %8.0f\n", hookNames[hookp->type], va("%s:%d", source, line),
+				hookp->calls, PreciseToMicros(hookp->time), PreciseToMicros(hookp->time) / hookp->calls, PreciseToMicros(hookp->maxtime));
+	}
+
+	CONS_Printf("  %-49s %9s %10s\n", "script", "calls", "total");
+	for (i = 0; i < numaddons && i < (size_t)count; i++)
+	{
+		// Pick the slowest one left
+		size_t worst = i;
+		for (j = i + 1; j < numaddons; j++)
+			if (addons[j].time > addons[worst].time)
+				worst = j;
+		if (worst != i)
+		{
+			addons[numaddons] = addons[i];
+			addons[i] = addons[worst];
+			addons[worst] = addons[numaddons];
+		}
+		CONS_Printf("  %-49s %9u %10.0f\n", addons[i].source, addons[i].calls, PreciseToMicros(addons[i].time));
+	}
+
+	free(sortedhooks);
+	free(addons);
+	sortedhooks = NULL;
+}
+
+/** Measures what every Lua hook costs.
+  * "profilehooks on|off|reset|show [count]"
+  */
+void Command_ProfileHooks_f(void)
+{
+	const char *arg = (COM_Argc() > 1) ? COM_Argv(1) : "";
+
+	if (!stricmp(arg, "on"))
+	{
+		if (!hookprofiling && !cv_hookbudget.value)
+			IterateHooks(ResetHookProfile);
+		hookprofiling = true;
+		CONS_Printf(M_GetText("Profiling Lua hooks.\n"));
+	}
+	else if (!stricmp(arg, "off"))
+	{
+		hookprofiling = false;
+		CONS_Printf(M_GetText("Stopped profiling Lua hooks.\n"));
+	}
+	else if (!stricmp(arg, "reset"))
+		IterateHooks(ResetHookProfile);
+	else if (!stricmp(arg, "show"))
+		ShowHookProfile((COM_Argc() > 2) ? atoi(COM_Argv(2)) : 10);
+	else
+		CONS_Printf(M_GetText("profilehooks <on|off|reset|show [count]>: measure what each Lua hook costs\n"));
+}
+
 // Takes hook, function, and additional arguments (mobj type to act on, etc.)
 static int lib_addHook(lua_State *L)
 {
-	static struct hook_s hook = {NULL, 0, 0, {0}, false};
+	static struct hook_s hook = {NULL, 0, 0, {0}, false, 0, 0, 0};
 	static UINT32 nextid;
 	hook_p hookp, *lastp;
 
@@ -272,7 +543,7 @@ boolean LUAh_MobjHook(mobj_t *mo, enum hook which)
 			LUA_PushUserdata(gL, mo, META_MOBJ);
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 1)) {
+		if (CallHook(hookp, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -293,7 +564,7 @@ boolean LUAh_MobjHook(mobj_t *mo, enum hook which)
 			LUA_PushUserdata(gL, mo, META_MOBJ);
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 1)) {
+		if (CallHook(hookp, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -328,7 +599,7 @@ boolean LUAh_PlayerHook(player_t *plr, enum hook which)
 			LUA_PushUserdata(gL, plr, META_PLAYER);
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 1)) {
+		if (CallHook(hookp, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -362,7 +633,7 @@ void LUAh_MapChange(INT16 mapnumber)
 
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 0, 1)) {
+		if (CallHook(hookp, 1, 0)) {
 			CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
 		}
@@ -389,7 +660,7 @@ void LUAh_MapLoad(void)
 
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 0, 1)) {
+		if (CallHook(hookp, 1, 0)) {
 			CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
 		}
@@ -416,7 +687,7 @@ void LUAh_PlayerJoin(int playernum)
 
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 0, 1)) {
+		if (CallHook(hookp, 1, 0)) {
 			CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
 		}
@@ -440,7 +711,7 @@ void LUAh_PreThinkFrame(void)
 			continue;
 
 		PushHook(gL, hookp);
-		if (lua_pcall(gL, 0, 0, 1)) {
+		if (CallHook(hookp, 0, 0)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -466,7 +737,7 @@ void LUAh_ThinkFrame(void)
 			continue;
 
 		PushHook(gL, hookp);
-		if (lua_pcall(gL, 0, 0, 1)) {
+		if (CallHook(hookp, 0, 0)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -492,7 +763,7 @@ void LUAh_PostThinkFrame(void)
 			continue;
 
 		PushHook(gL, hookp);
-		if (lua_pcall(gL, 0, 0, 1)) {
+		if (CallHook(hookp, 0, 0)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -530,7 +801,7 @@ UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -560,7 +831,7 @@ UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -607,7 +878,7 @@ UINT8 LUAh_MobjLineCollideHook(mobj_t *thing, line_t *line, enum hook which)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -637,7 +908,7 @@ UINT8 LUAh_MobjLineCollideHook(mobj_t *thing, line_t *line, enum hook which)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -663,11 +934,16 @@ boolean LUAh_MobjThinker(mobj_t *mo)
 {
 	hook_p hookp;
 	boolean hooked = false;
+	const mobjtype_t type = mo->type; // the hooks may remove it
+	UINT64 start = 0;
 	if (!gL || !(hooksAvailable[hook_MobjThinker/8] & (1<<(hook_MobjThinker%8))))
 		return false;
 
 	I_Assert(mo->type < NUMMOBJTYPES);
 
+	if (thinkerprofiling)
+		start = I_GetPreciseTime();
+
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
@@ -678,7 +954,7 @@ boolean LUAh_MobjThinker(mobj_t *mo)
 			LUA_PushUserdata(gL, mo, META_MOBJ);
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 1)) {
+		if (CallHook(hookp, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -696,7 +972,7 @@ boolean LUAh_MobjThinker(mobj_t *mo)
 			LUA_PushUserdata(gL, mo, META_MOBJ);
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 1)) {
+		if (CallHook(hookp, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -709,6 +985,8 @@ boolean LUAh_MobjThinker(mobj_t *mo)
 	}
 
 	lua_settop(gL, 0);
+	if (thinkerprofiling)
+		P_AddMobjLuaTime(type, I_GetPreciseTime() - start);
 	return hooked;
 }
 
@@ -739,7 +1017,7 @@ boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -764,7 +1042,7 @@ boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -813,7 +1091,7 @@ UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
-		if (lua_pcall(gL, 5, 1, 1)) {
+		if (CallHook(hookp, 5, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -848,7 +1126,7 @@ UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
-		if (lua_pcall(gL, 5, 1, 1)) {
+		if (CallHook(hookp, 5, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -902,7 +1180,7 @@ boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
-		if (lua_pcall(gL, 5, 1, 1)) {
+		if (CallHook(hookp, 5, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -933,7 +1211,7 @@ boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
-		if (lua_pcall(gL, 5, 1, 1)) {
+		if (CallHook(hookp, 5, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -980,7 +1258,7 @@ boolean LUAh_MobjDeath(mobj_t *target, mobj_t *inflictor, mobj_t *source, UINT8
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
-		if (lua_pcall(gL, 4, 1, 1)) {
+		if (CallHook(hookp, 4, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1009,7 +1287,7 @@ boolean LUAh_MobjDeath(mobj_t *target, mobj_t *inflictor, mobj_t *source, UINT8
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
-		if (lua_pcall(gL, 4, 1, 1)) {
+		if (CallHook(hookp, 4, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1049,7 +1327,7 @@ boolean LUAh_BotTiccmd(player_t *bot, ticcmd_t *cmd)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1090,7 +1368,7 @@ boolean LUAh_BotAI(mobj_t *sonic, mobj_t *tails, ticcmd_t *cmd)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 8, 1)) {
+		if (CallHook(hookp, 2, 8)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1152,7 +1430,7 @@ boolean LUAh_BotRespawn(mobj_t *sonic, mobj_t *tails)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1199,7 +1477,7 @@ boolean LUAh_LinedefExecute(line_t *line, mobj_t *mo, sector_t *sector)
 		lua_pushvalue(gL, -4);
 		lua_pushvalue(gL, -4);
 		lua_pushvalue(gL, -4);
-		if (lua_pcall(gL, 3, 0, 1)) {
+		if (CallHook(hookp, 3, 0)) {
 			CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
 		}
@@ -1249,7 +1527,7 @@ boolean LUAh_PlayerMsg(int source, int target, int flags, char *msg)
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
-		if (lua_pcall(gL, 4, 1, 1)) {
+		if (CallHook(hookp, 4, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1295,7 +1573,7 @@ boolean LUAh_HurtMsg(player_t *player, mobj_t *inflictor, mobj_t *source, UINT8
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
-		if (lua_pcall(gL, 4, 1, 1)) {
+		if (CallHook(hookp, 4, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1371,7 +1649,7 @@ boolean LUAh_MapThingSpawn(mobj_t *mo, mapthing_t *mthing)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1396,7 +1674,7 @@ boolean LUAh_MapThingSpawn(mobj_t *mo, mapthing_t *mthing)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1437,7 +1715,7 @@ boolean LUAh_FollowMobj(player_t *player, mobj_t *mobj)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1462,7 +1740,7 @@ boolean LUAh_FollowMobj(player_t *player, mobj_t *mobj)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1502,7 +1780,7 @@ UINT8 LUAh_PlayerCanDamage(player_t *player, mobj_t *mobj)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1545,7 +1823,7 @@ void LUAh_PlayerQuit(player_t *plr, kickreason_t reason)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 0, 1)) {
+		if (CallHook(hookp, 2, 0)) {
 			CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
 		}
@@ -1569,7 +1847,7 @@ void LUAh_IntermissionThinker(void)
 			continue;
 
 		PushHook(gL, hookp);
-		if (lua_pcall(gL, 0, 0, 1)) {
+		if (CallHook(hookp, 0, 0)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1611,7 +1889,7 @@ boolean LUAh_TeamSwitch(player_t *player, int newteam, boolean fromspectators, b
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
-		if (lua_pcall(gL, 5, 1, 1)) {
+		if (CallHook(hookp, 5, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1655,7 +1933,7 @@ UINT8 LUAh_ViewpointSwitch(player_t *player, player_t *newdisplayplayer, boolean
 		lua_pushvalue(gL, -4);
 		lua_pushvalue(gL, -4);
 		lua_pushvalue(gL, -4);
-		if (lua_pcall(gL, 3, 1, 1)) {
+		if (CallHook(hookp, 3, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1706,7 +1984,7 @@ boolean LUAh_SeenPlayer(player_t *player, player_t *seenfriend)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1752,7 +2030,7 @@ boolean LUAh_ShouldJingleContinue(player_t *player, const char *musname)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1786,7 +2064,7 @@ void LUAh_GameQuit(void)
 			continue;
 
 		PushHook(gL, hookp);
-		if (lua_pcall(gL, 0, 0, 1)) {
+		if (CallHook(hookp, 0, 0)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1828,7 +1828,10 @@ static int ffloor_set(lua_State *L)
 		ffloortype_e oldflags = ffloor->flags; // store FOF's old flags
 		ffloor->flags = luaL_checkinteger(L, 3);
 		if (ffloor->flags != oldflags)
+		{
 			ffloor->target->moved = true; // reset target sector's lightlist
+			P_ClearSightCache();
+		}
 		break;
 	}
 	case ffloor_alpha:
@@ -2147,6 +2150,8 @@ static int mapheaderinfo_get(lua_State *L)
 		lua_pushinteger(L, header->ssspheres);
 	else if (fastcmp(field, "gravity"))
 		lua_pushfixed(L, header->gravity);
+	else if (fastcmp(field, "dormantradius"))
+		lua_pushinteger(L, header->dormantradius);
 	// TODO add support for reading numGradedMares and grades
 	else {
 		// Read custom vars now
@@ -0,0 +1,133 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 2020 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  m_perfstats.c
+/// \brief Sample series and summaries for the benchmark modes
+///
+/// Series are kept with the C library's allocator rather than the zone,
+/// so that measuring doesn't show up in the zone's allocation counts and
+/// survives the level being freed.
+
+#include "doomdef.h"
+#include "m_perfstats.h"
+
+/** Adds a measurement to the end of a series.
+  *
+  * \param series The series, which may be all zeroes to start with.
+  * \param value The measurement.
+  */
+void M_PerfSeriesAdd(perfseries_t *series, UINT32 value)
+{
+	if (series->count == series->capacity)
+	{
+		size_t newcap = series->capacity ? series->capacity * 2 : 1024;
+		UINT32 *newsamples = realloc(series->samples, newcap * sizeof *newsamples);
+		if (!newsamples)
+			I_Error("M_PerfSeriesAdd: out of memory");
+		series->samples = newsamples;
+		series->capacity = newcap;
+	}
+	series->samples[series->count++] = value;
+}
+
+/** Throws away all of a series' measurements.
+  */
+void M_PerfSeriesFree(perfseries_t *series)
+{
+	free(series->samples);
+	series->samples = NULL;
+	series->count = series->capacity = 0;
+}
+
+static int M_CompareSamples(const void *a, const void *b)
+{
+	const UINT32 x = *(const UINT32 *)a, y = *(const UINT32 *)b;
+	return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of a sorted series
+static UINT32 M_Percentile(const UINT32 *sorted, size_t count, size_t percent)
+{
+	size_t rank = (count * percent + 99) / 100;
+	return sorted[rank ? rank - 1 : 0];
+}
+
+/** Works out the spread of a series. The series itself is left in the
+  * order the measurements were taken.
+  *
+  * \param series The series.
+  * \param out Gets the summary; all zeroes if the series is empty.
+  */
+void M_PerfSeriesSummarize(const perfseries_t *series, perfsummary_t *out)
+{
+	UINT32 *sorted;
+	double sum = 0.0;
+	size_t i;
+
+	memset(out, 0, sizeof *out);
+	if (!series->count)
+		return;
+
+	sorted = malloc(series->count * sizeof *sorted);
+	if (!sorted)
+		I_Error("M_PerfSeriesSummarize: out of memory");
+	memcpy(sorted, series->samples, series->count * sizeof *sorted);
+	qsort(sorted, series->count, sizeof *sorted, M_CompareSamples);
+
+	for (i = 0; i < series->count; i++)
+		sum += sorted[i];
+
+	out->count = series->count;
+	out->min = sorted[0];
+	out->p50 = M_Percentile(sorted, series->count, 50);
+	out->p95 = M_Percentile(sorted, series->count, 95);
+	out->p99 = M_Percentile(sorted, series->count, 99);
+	out->max = sorted[series->count - 1];
+	out->mean = sum / series->count;
+
+	free(sorted);
+}
+
+/** Hashes a block of memory with 32-bit FNV-1a, to tell whether two
+  * frames came out the same.
+  */
+UINT32 M_PerfHashBuffer(const UINT8 *buf, size_t len)
+{
+	UINT32 hash = 2166136261u;
+	while (len--)
+	{
+		hash ^= *buf++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/** Writes a string as a quoted JSON string.
+  */
+void M_PerfWriteJSONString(FILE *f, const char *str)
+{
+	fputc('"', f);
+	for (; *str; str++)
+	{
+		if (*str == '"' || *str == '\\')
+			fprintf(f, "\\%c", *str);
+		else if ((UINT8)*str < 0x20)
+			fprintf(f, "\\u%04x", (UINT8)*str);
+		else
+			fputc(*str, f);
+	}
+	fputc('"', f);
+}
+
+/** Writes a summary as a JSON object.
+  */
+void M_PerfWriteJSONSummary(FILE *f, const perfsummary_t *sum)
+{
+	fprintf(f, "{\"count\": %s, \"min\": %u, \"p50\": %u, \"p95\": %u, \"p99\": %u, \"max\": %u, \"mean\": %.2f}",
+		sizeu1(sum->count), sum->min, sum->p50, sum->p95, sum->p99, sum->max, sum->mean);
+}
@@ -0,0 +1,42 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 2020 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  m_perfstats.h
+/// \brief Sample series and summaries for the benchmark modes
+
+#ifndef __M_PERFSTATS__
+#define __M_PERFSTATS__
+
+#include <stdio.h>
+#include "doomtype.h"
+
+// A growing list of measurements, one per tic or frame
+typedef struct
+{
+	UINT32 *samples;
+	size_t count, capacity;
+} perfseries_t;
+
+// What a series looks like as a whole
+typedef struct
+{
+	size_t count;
+	UINT32 min, p50, p95, p99, max;
+	double mean;
+} perfsummary_t;
+
+void M_PerfSeriesAdd(perfseries_t *series, UINT32 value);
+void M_PerfSeriesFree(perfseries_t *series);
+void M_PerfSeriesSummarize(const perfseries_t *series, perfsummary_t *out);
+
+UINT32 M_PerfHashBuffer(const UINT8 *buf, size_t len);
+
+void M_PerfWriteJSONString(FILE *f, const char *str);
+void M_PerfWriteJSONSummary(FILE *f, const perfsummary_t *sum);
+
+#endif
@@ -0,0 +1,207 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 2020 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  m_trace.c
+/// \brief Timeline tracing of the engine, saved for chrome://tracing and Perfetto
+///
+/// "trace <frames>" records when every marked stretch of code starts and
+/// ends, for that many frames from the next one on, then saves it in the
+/// Chrome trace event format. Events go in a buffer allocated when the
+/// recording starts and freed when it is saved.
+
+#include "doomdef.h"
+#include "command.h"
+#include "console.h"
+#include "d_main.h" // srb2home
+#include "i_system.h"
+#include "i_threads.h"
+#include "m_misc.h"
+#include "m_perfstats.h" // M_PerfWriteJSONString
+#include "m_trace.h"
+
+// Enough for a few seconds of a busy level
+#define MAXTRACEEVENTS (1<<20)
+
+typedef struct
+{
+	const char *name; // NULL for the end of the latest stretch begun
+	UINT32 time; // microseconds since the recording started
+	UINT32 thread;
+} traceevent_t;
+
+boolean trace_recording = false;
+
+static struct
+{
+	traceevent_t *events;
+	size_t numevents;
+	UINT32 dropped; // events that didn't fit
+
+	INT32 framesleft; // frames still to record, once it has started
+	boolean pending; // starts on the next frame
+	boolean inframe; // a frame's event has begun
+	int starttime;
+	char filename[MAX_WADPATH];
+} trace;
+
+#ifdef HAVE_THREADS
+static I_mutex trace_mutex;
+#endif
+
+static void M_TraceAdd(const char *name)
+{
+	traceevent_t *ev;
+
+#ifdef HAVE_THREADS
+	I_lock_mutex(&trace_mutex);
+#endif
+	if (trace.numevents < MAXTRACEEVENTS)
+	{
+		ev = &trace.events[trace.numevents++];
+		ev->name = name;
+		ev->time = (UINT32)(I_GetTimeMicros() - trace.starttime);
+#ifdef HAVE_THREADS
+		ev->thread = (UINT32)I_thread_id();
+#else
+		ev->thread = 1;
+#endif
+	}
+	else
+		trace.dropped++;
+#ifdef HAVE_THREADS
+	I_unlock_mutex(trace_mutex);
+#endif
+}
+
+/** Begins a stretch of the timeline. Use TRACE_BEGIN instead.
+  */
+void M_TraceBegin(const char *name)
+{
+	M_TraceAdd(name);
+}
+
+/** Ends the latest stretch begun on this thread. Use TRACE_END instead.
+  */
+void M_TraceEnd(void)
+{
+	M_TraceAdd(NULL);
+}
+
+static void M_TraceSave(void)
+{
+	FILE *f = fopen(trace.filename, "w");
+	size_t i;
+
+	if (!f)
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("Couldn't write the trace to '%s'\n"), trace.filename);
+		return;
+	}
+
+	fputs("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n", f);
+	fputs("{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"SRB2\"}}", f);
+	for (i = 0; i < trace.numevents; i++)
+	{
+		const traceevent_t *ev = &trace.events[i];
+		if (ev->name)
+		{
+			fputs(",\n{\"name\": ", f);
+			M_PerfWriteJSONString(f, ev->name);
+			fprintf(f, ", \"ph\": \"B\", \"ts\": %u, \"pid\": 1, \"tid\": %u}", ev->time, ev->thread);
+		}
+		else
+			fprintf(f, ",\n{\"ph\": \"E\", \"ts\": %u, \"pid\": 1, \"tid\": %u}", ev->time, ev->thread);
+	}
+	fputs("\n]}\n", f);
+	fclose(f);
+
+	CONS_Printf(M_GetText("Saved %s trace events to '%s'\n"), sizeu1(trace.numevents), trace.filename);
+	if (trace.dropped)
+		CONS_Alert(CONS_WARNING, M_GetText("%u events didn't fit and were left out\n"), trace.dropped);
+}
+
+static void M_TraceStop(void)
+{
+	trace_recording = false;
+	M_TraceSave();
+	free(trace.events);
+	trace.events = NULL;
+}
+
+/** Called by D_SRB2Loop at the start of every frame it runs, to start
+  * and stop recording on frame boundaries.
+  */
+void M_TraceFrame(void)
+{
+	if (trace_recording)
+	{
+		if (trace.inframe)
+			M_TraceEnd();
+		trace.inframe = false;
+
+		if (--trace.framesleft <= 0)
+			M_TraceStop();
+	}
+	else if (trace.pending)
+	{
+		trace.pending = false;
+		trace.starttime = I_GetTimeMicros();
+		trace_recording = true;
+	}
+
+	if (trace_recording)
+	{
+		M_TraceBegin("frame");
+		trace.inframe = true;
+	}
+}
+
+/** Records a trace of the next few frames: "trace <frames> [file]".
+  * The file goes in the home folder and defaults to trace.json.
+  */
+void Command_Trace_f(void)
+{
+	INT32 frames;
+
+	if (COM_Argc() < 2)
+	{
+		CONS_Printf(M_GetText("trace <frames> [file]: record a timeline of the next frames for chrome://tracing or Perfetto\n"));
+		return;
+	}
+
+	if (trace_recording || trace.pending)
+	{
+		CONS_Printf(M_GetText("Already recording a trace.\n"));
+		return;
+	}
+
+	frames = atoi(COM_Argv(1));
+	if (frames <= 0)
+	{
+		CONS_Printf(M_GetText("The number of frames has to be positive.\n"));
+		return;
+	}
+
+	trace.events = malloc(MAXTRACEEVENTS * sizeof *trace.events);
+	if (!trace.events)
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("Not enough memory to record a trace\n"));
+		return;
+	}
+
+	snprintf(trace.filename, sizeof trace.filename, "%s"PATHSEP"%s", srb2home,
+		(COM_Argc() > 2) ? COM_Argv(2) : "trace.json");
+	FIL_DefaultExtension(trace.filename, ".json");
+
+	trace.numevents = 0;
+	trace.dropped = 0;
+	trace.framesleft = frames;
+	trace.inframe = false;
+	trace.pending = true;
+	CONS_Printf(M_GetText("Recording a trace of %d frames...\n"), frames);
+}
@@ -0,0 +1,38 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 2020 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  m_trace.h
+/// \brief Timeline tracing of the engine, saved for chrome://tracing and Perfetto
+
+#ifndef __M_TRACE__
+#define __M_TRACE__
+
+#include "doomtype.h"
+
+// Set while frames are being recorded by the "trace" command
+extern boolean trace_recording;
+
+// Marks out a stretch of code to show up on the timeline. Every
+// TRACE_BEGIN needs a TRACE_END on every way out of the code it marks,
+// and the name has to be a string that never goes away.
+// Costs one test of a global while nothing is being recorded.
+#ifdef NOTRACE
+#define TRACE_BEGIN(name) (void)0
+#define TRACE_END() (void)0
+#else
+#define TRACE_BEGIN(name) do { if (trace_recording) M_TraceBegin(name); } while (0)
+#define TRACE_END() do { if (trace_recording) M_TraceEnd(); } while (0)
+#endif
+
+void M_TraceBegin(const char *name);
+void M_TraceEnd(void);
+void M_TraceFrame(void);
+
+void Command_Trace_f(void);
+
+#endif
@@ -385,6 +385,7 @@ void T_MoveElevator(elevator_t *elevator)
 			res = crushed;
 			elevator->sector->floorheight = oldfloor;
 			elevator->sector->ceilingheight = oldceiling;
+			P_SectorHeightsChanged(elevator->sector);
 		}
 		else
 			res = res1;
@@ -450,6 +451,7 @@ void T_MoveElevator(elevator_t *elevator)
 			res = crushed;
 			elevator->sector->floorheight = oldfloor;
 			elevator->sector->ceilingheight = oldceiling;
+			P_SectorHeightsChanged(elevator->sector);
 		}
 		else
 			res = res1;
@@ -821,6 +823,7 @@ void T_StartCrumble(crumble_t *crumble)
 						rover->flags &= ~FF_TRANSLUCENT;
 				}
 			}
+			P_ClearSightCache();
 
 			// Up!
 			if (crumble->flags & CF_REVERSE)
@@ -868,6 +871,7 @@ void T_StartCrumble(crumble_t *crumble)
 					}
 				}
 			}
+			P_ClearSightCache();
 		}
 
 		// We're about to go back to the original position,
@@ -920,6 +924,7 @@ void T_StartCrumble(crumble_t *crumble)
 		crumble->sector->crumblestate = CRUMBLE_WAIT;
 		crumble->sector->ceilingheight = crumble->ceilingwasheight;
 		crumble->sector->floorheight = crumble->floorwasheight;
+		P_SectorHeightsChanged(crumble->sector);
 		crumble->sector->floordata = NULL;
 		crumble->sector->ceilingdata = NULL;
 		crumble->sector->ceilspeed = 0;
@@ -971,6 +976,7 @@ void T_MarioBlock(mariothink_t *block)
 	{
 		block->sector->ceilingheight = block->ceilingstartheight;
 		block->sector->floorheight = block->floorstartheight;
+		P_SectorHeightsChanged(block->sector);
 		P_RemoveThinker(&block->thinker);
 		block->sector->floordata = NULL;
 		block->sector->ceilingdata = NULL;
@@ -1648,6 +1654,7 @@ void T_RaiseSector(raise_t *raise)
 	{
 		raise->sector->floorheight = floordestination;
 		raise->sector->ceilingheight = ceilingdestination;
+		P_SectorHeightsChanged(raise->sector);
 		raise->sector->ceilspeed = 0;
 		raise->sector->floorspeed = 0;
 		return;
@@ -2266,6 +2273,7 @@ void EV_CrumbleChain(sector_t *sec, ffloor_t *rover)
 	rover->flags &= ~FF_EXISTS;
 	rover->master->frontsector->moved = true;
 	P_RecalcPrecipInSector(sec);
+	P_ClearSightCache();
 }
 
 // Used for bobbing platforms on the water
@@ -2389,7 +2397,10 @@ void EV_MarioBlock(ffloor_t *rover, sector_t *sector, mobj_t *puncher)
 		return;
 
 	if (!(rover->flags & FF_SOLID))
+	{
 		rover->flags |= (FF_SOLID|FF_RENDERALL|FF_CUTLEVEL);
+		P_ClearSightCache();
+	}
 
 	// Find an item to pop out!
 	thing = SearchMarioNode(roversec->touching_thinglist);
@@ -3531,6 +3531,8 @@ boolean P_DamageMobj(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32 da
 	if (target->health <= 0)
 		return false;
 
+	P_WakeMobj(target);
+
 	// Spectator handling
 	if (multiplayer)
 	{
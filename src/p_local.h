@@ -67,7 +67,6 @@ typedef enum
 	THINK_MAIN,
 	THINK_MOBJ,
 	THINK_DYNSLOPE,
-	THINK_PRECIP,
 	NUM_THINKERLISTS
 } thinklistnum_t; /**< Thinker lists. */
 extern thinker_t thlist[];
@@ -95,6 +94,10 @@ typedef struct camera_s
 	//More drawing info: to determine current sprite.
 	angle_t angle; // orientation
 
+	// At the start of the tic, for frame interpolation
+	fixed_t old_x, old_y, old_z;
+	angle_t old_angle, old_aiming;
+
 	struct subsector_s *subsector;
 
 	// The closest interval over all contacted Sectors (or Things).
@@ -296,6 +299,10 @@ boolean P_RailThinker(mobj_t *mobj);
 void P_PushableThinker(mobj_t *mobj);
 void P_SceneryThinker(mobj_t *mobj);
 
+void P_UpdateDormancy(void);
+void P_WakeMobj(mobj_t *mobj);
+void P_WakeSectorMobjs(sector_t *sector);
+
 
 fixed_t P_MobjFloorZ(mobj_t *mobj, sector_t *sector, sector_t *boundsec, fixed_t x, fixed_t y, line_t *line, boolean lowest, boolean perfect);
 fixed_t P_MobjCeilingZ(mobj_t *mobj, sector_t *sector, sector_t *boundsec, fixed_t x, fixed_t y, line_t *line, boolean lowest, boolean perfect);
@@ -415,6 +422,8 @@ boolean P_TeleportMove(mobj_t *thing, fixed_t x, fixed_t y, fixed_t z);
 void P_SlideMove(mobj_t *mo);
 void P_BounceMove(mobj_t *mo);
 boolean P_CheckSight(mobj_t *t1, mobj_t *t2);
+void P_ClearSightCache(void);
+void Command_Sightstats_f(void);
 void P_CheckHoopPosition(mobj_t *hoopthing, fixed_t x, fixed_t y, fixed_t z, fixed_t radius);
 
 boolean P_CheckSector(sector_t *sector, boolean crunch);
@@ -423,7 +432,6 @@ void P_DelSeclist(msecnode_t *node);
 void P_DelPrecipSeclist(mprecipsecnode_t *node);
 
 void P_CreateSecNodeList(mobj_t *thing, fixed_t x, fixed_t y);
-void P_Initsecnode(void);
 
 void P_RadiusAttack(mobj_t *spot, mobj_t *source, fixed_t damagedist, UINT8 damagetype, boolean sightcheck);
 
@@ -444,6 +452,21 @@ extern fixed_t bmaporgx;
 extern fixed_t bmaporgy; // origin of block map
 extern mobj_t **blocklinks; // for thing chains
 
+// Collision data for one of the mobjs in a block
+typedef struct
+{
+	mobj_t *mobj;
+	fixed_t x, y, radius;
+} blockthing_t;
+
+typedef struct
+{
+	blockthing_t *things;
+	size_t count, capacity;
+} blockthings_t;
+
+extern blockthings_t *blockthings; // next to blocklinks, see P_BlockThingsNear
+
 //
 // P_INTER
 //
@@ -2251,6 +2251,9 @@ boolean P_CheckPosition(mobj_t *thing, fixed_t x, fixed_t y)
 		for (bx = xl; bx <= xh; bx++)
 			for (by = yl; by <= yh; by++)
 			{
+				// Skip the blocks where PIT_CheckThing would miss everything
+				if (!P_BlockThingsNear(bx, by, x, y, thing->radius, thing))
+					continue;
 				if (!P_BlockThingsIterator(bx, by, PIT_CheckThing))
 					blockval = false;
 				if (P_MobjWasRemoved(tmthing))
@@ -4258,6 +4261,9 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 	nofit = false;
 	crushchange = crunch;
 
+	// Whatever moved the sector, forget what was cached about its old heights
+	P_SectorHeightsChanged(sector);
+
 	// killough 4/4/98: scan list front-to-back until empty or exhausted,
 	// restarting from beginning after each thing is processed. Avoids
 	// crashes, and is sure to examine all things in the sector, and only
@@ -4485,59 +4491,36 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
  Lots of new Boom functions that work faster and add functionality.
 */
 
-static msecnode_t *headsecnode = NULL;
-static mprecipsecnode_t *headprecipsecnode = NULL;
-
-void P_Initsecnode(void)
-{
-	headsecnode = NULL;
-	headprecipsecnode = NULL;
-}
+// Sector nodes live in pools, which keep their own freelists
+// and are emptied along with the rest of the level.
+// They're never seen by Lua, so they skip Z_Free's userdata checks.
+static zpool_t secnodepool = Z_POOL("Sector nodes", sizeof (msecnode_t), PU_LEVEL);
+static zpool_t precipsecnodepool = Z_POOL("Precip sec nodes", sizeof (mprecipsecnode_t), PU_LEVEL);
 
 // P_GetSecnode() retrieves a node from the freelist. The calling routine
 // should make sure it sets all fields properly.
 
-static msecnode_t *P_GetSecnode(void)
+static inline msecnode_t *P_GetSecnode(void)
 {
-	msecnode_t *node;
-
-	if (headsecnode)
-	{
-		node = headsecnode;
-		headsecnode = headsecnode->m_thinglist_next;
-	}
-	else
-		node = Z_Calloc(sizeof (*node), PU_LEVEL, NULL);
-	return node;
+	return Z_PoolMalloc(&secnodepool);
 }
 
-static mprecipsecnode_t *P_GetPrecipSecnode(void)
+static inline mprecipsecnode_t *P_GetPrecipSecnode(void)
 {
-	mprecipsecnode_t *node;
-
-	if (headprecipsecnode)
-	{
-		node = headprecipsecnode;
-		headprecipsecnode = headprecipsecnode->m_thinglist_next;
-	}
-	else
-		node = Z_Calloc(sizeof (*node), PU_LEVEL, NULL);
-	return node;
+	return Z_PoolMalloc(&precipsecnodepool);
 }
 
 // P_PutSecnode() returns a node to the freelist.
 
 static inline void P_PutSecnode(msecnode_t *node)
 {
-	node->m_thinglist_next = headsecnode;
-	headsecnode = node;
+	Z_PoolFree(node);
 }
 
 // Tails 08-25-2002
 static inline void P_PutPrecipSecnode(mprecipsecnode_t *node)
 {
-	node->m_thinglist_next = headprecipsecnode;
-	headprecipsecnode = node;
+	Z_PoolFree(node);
 }
 
 // P_AddSecnode() searches the current list to see if this sector is
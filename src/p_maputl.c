@@ -681,6 +681,114 @@ void P_LineOpening(line_t *linedef, mobj_t *mobj)
 }
 
 
+//
+// BLOCK THINGS
+//
+// Next to each block's chain of mobjs, the blockmap keeps an array of their
+// collision data. Scanning it tells whether anything in the block can be
+// touched without going through the mobjs themselves. Like the chains it
+// counts on x and y only changing between P_UnsetThingPosition and
+// P_SetThingPosition, and on P_UpdateBlockThing being called for radius
+// changes in between.
+//
+
+static void P_AddBlockThing(mobj_t *thing, INT32 block)
+{
+	blockthings_t *bt = &blockthings[block];
+
+	if (bt->count == bt->capacity)
+	{
+		bt->capacity = bt->capacity ? bt->capacity*2 : 4;
+		bt->things = Z_Realloc(bt->things, bt->capacity * sizeof (*bt->things), PU_LEVEL, NULL);
+	}
+
+	bt->things[bt->count].mobj = thing;
+	bt->things[bt->count].x = thing->x;
+	bt->things[bt->count].y = thing->y;
+	bt->things[bt->count].radius = thing->radius;
+	bt->count++;
+}
+
+static blockthing_t *P_FindBlockThing(mobj_t *thing, blockthings_t **btp)
+{
+	const INT32 blockx = (unsigned)(thing->x - bmaporgx)>>MAPBLOCKSHIFT;
+	const INT32 blocky = (unsigned)(thing->y - bmaporgy)>>MAPBLOCKSHIFT;
+	blockthings_t *bt;
+	size_t i;
+
+	if (blockx < 0 || blockx >= bmapwidth || blocky < 0 || blocky >= bmapheight)
+		return NULL;
+
+	bt = &blockthings[blocky*bmapwidth + blockx];
+	for (i = 0; i < bt->count; i++)
+		if (bt->things[i].mobj == thing)
+		{
+			*btp = bt;
+			return &bt->things[i];
+		}
+
+	return NULL;
+}
+
+static void P_RemoveBlockThing(mobj_t *thing)
+{
+	blockthings_t *bt;
+	blockthing_t *entry = P_FindBlockThing(thing, &bt);
+
+	if (entry)
+		*entry = bt->things[--bt->count]; // order doesn't matter
+}
+
+/** Refreshes the blockmap's copy of a linked thing's radius.
+  *
+  * \param thing The thing whose radius was changed.
+  */
+void P_UpdateBlockThing(mobj_t *thing)
+{
+	blockthings_t *bt;
+	blockthing_t *entry;
+
+	if ((thing->flags & MF_NOBLOCKMAP) || !thing->bprev)
+		return;
+
+	if ((entry = P_FindBlockThing(thing, &bt)) != NULL)
+		entry->radius = thing->radius;
+}
+
+/** Checks whether anything in a block could touch a thing of the given
+  * radius at the given spot, the way PIT_CheckThing measures it.
+  *
+  * \param x Block column.
+  * \param y Block row.
+  * \param spotx X of the spot.
+  * \param spoty Y of the spot.
+  * \param radius Radius of the thing at the spot.
+  * \param ignore Thing that doesn't count, usually the one at the spot.
+  * \return False if everything in the block is too far away.
+  */
+boolean P_BlockThingsNear(INT32 x, INT32 y, fixed_t spotx, fixed_t spoty, fixed_t radius, mobj_t *ignore)
+{
+	const blockthings_t *bt;
+	size_t i;
+
+	if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+		return false;
+
+	bt = &blockthings[y*bmapwidth + x];
+	for (i = 0; i < bt->count; i++)
+	{
+		const blockthing_t *entry = &bt->things[i];
+		const fixed_t blockdist = entry->radius + radius;
+
+		if (entry->mobj == ignore)
+			continue;
+		if (abs(entry->x - spotx) < blockdist && abs(entry->y - spoty) < blockdist)
+			return true;
+	}
+
+	return false;
+}
+
 //
 // THING POSITION SETTING
 //
@@ -742,6 +850,8 @@ void P_UnsetThingPosition(mobj_t *thing)
 		*/
 
 		mobj_t *bnext, **bprev = thing->bprev;
+		if (bprev)
+			P_RemoveBlockThing(thing);
 		if (bprev && (*bprev = bnext = thing->bnext) != NULL)  // unlink from block map
 			bnext->bprev = bprev;
 	}
@@ -829,6 +939,7 @@ void P_SetThingPosition(mobj_t *thing)
 				bnext->bprev = &thing->bnext;
 			thing->bprev = link;
 			*link = thing;
+			P_AddBlockThing(thing, blocky*bmapwidth + blockx);
 		}
 		else // thing is off the map
 			thing->bnext = NULL, thing->bprev = NULL;
@@ -62,6 +62,8 @@ void P_LineOpening(line_t *plinedef, mobj_t *mobj);
 
 boolean P_BlockLinesIterator(INT32 x, INT32 y, boolean(*func)(line_t *));
 boolean P_BlockThingsIterator(INT32 x, INT32 y, boolean(*func)(mobj_t *));
+boolean P_BlockThingsNear(INT32 x, INT32 y, fixed_t spotx, fixed_t spoty, fixed_t radius, mobj_t *ignore);
+void P_UpdateBlockThing(mobj_t *thing);
 
 #define PT_ADDLINES     1
 #define PT_ADDTHINGS    2
@@ -19,6 +19,7 @@
 #include "p_local.h"
 #include "p_setup.h"
 #include "r_main.h"
+#include "r_fps.h"
 #include "r_skins.h"
 #include "r_sky.h"
 #include "r_splats.h"
@@ -44,6 +45,15 @@ consvar_t cv_splats = {"splats", "On", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0
 
 actioncache_t actioncachehead;
 
+// Mobjs come and go by the thousands, so they get their own pools.
+zpool_t mobjpool = Z_POOL("Mobjs", sizeof (mobj_t), PU_LEVEL);
+
+// All of the level's precipitation, in blockmap order. It isn't put on the
+// thinker lists: a drop only moves when the renderer gets to it, through
+// P_PrecipThink.
+precipmobj_t *precipmobjs;
+size_t numprecipmobjs;
+
 static mobj_t *overlaycap = NULL;
 
 void P_InitCachedActions(void)
@@ -4002,14 +4012,23 @@ void P_RecalcPrecipInSector(sector_t *sector)
 }
 
 //
-// P_NullPrecipThinker
+// P_PrecipThink
 //
-// For "Blank" precipitation
+// Moves a drop that is about to be drawn up to the current tic. Drops
+// nobody can see don't think at all.
 //
-void P_NullPrecipThinker(precipmobj_t *mobj)
+void P_PrecipThink(precipmobj_t *mobj)
 {
-	//(void)mobj;
-	mobj->precipflags &= ~PCF_THUNK;
+	if (mobj->lastthink == leveltime)
+		return;
+
+	mobj->lastthink = leveltime;
+	R_ResetPrecipitationMobjInterpolationState(mobj);
+
+	if (mobj->precipflags & PCF_RAIN)
+		P_RainThinker(mobj);
+	else
+		P_SnowThinker(mobj);
 }
 
 void P_SnowThinker(precipmobj_t *mobj)
@@ -4018,7 +4037,10 @@ void P_SnowThinker(precipmobj_t *mobj)
 
 	// adjust height
 	if ((mobj->z += mobj->momz) <= mobj->floorz)
+	{
 		mobj->z = mobj->ceilingz;
+		R_ResetPrecipitationMobjInterpolationState(mobj);
+	}
 }
 
 void P_RainThinker(precipmobj_t *mobj)
@@ -4042,6 +4064,7 @@ void P_RainThinker(precipmobj_t *mobj)
 			return;
 
 		mobj->z = mobj->ceilingz;
+		R_ResetPrecipitationMobjInterpolationState(mobj);
 		P_SetPrecipMobjState(mobj, S_RAIN1);
 
 		return;
@@ -4055,6 +4078,7 @@ void P_RainThinker(precipmobj_t *mobj)
 	if (mobj->precipflags & PCF_PIT)
 	{
 		mobj->z = mobj->ceilingz;
+		R_ResetPrecipitationMobjInterpolationState(mobj);
 		return;
 	}
 
@@ -4742,6 +4766,7 @@ static void P_Boss4DestroyCage(mobj_t *mobj)
 						rover->flags &= ~FF_EXISTS;
 						sector->moved = true;
 						rsec->moved = true;
+						P_ClearSightCache();
 					}
 				}
 		}
@@ -6395,6 +6420,7 @@ void P_SetScale(mobj_t *mobj, fixed_t newscale)
 
 	mobj->radius = FixedMul(FixedDiv(mobj->radius, oldscale), newscale);
 	mobj->height = FixedMul(FixedDiv(mobj->height, oldscale), newscale);
+	P_UpdateBlockThing(mobj);
 
 	player = mobj->player;
 
@@ -10015,6 +10041,126 @@ static boolean P_FuseThink(mobj_t *mobj)
 	return !P_MobjWasRemoved(mobj);
 }
 
+//
+// Dormancy
+//
+// On maps with a dormantradius, MF_SLEEPABLE mobjs (and scenery, if the map
+// asks for it) stop thinking while they are more than that far away from
+// every player, and start again once one comes within 7/8 of it. Everything
+// that decides this is synced game state, so netgames stay in step.
+// Dormant mobjs stay in the thinker list, since a lot of code looks for
+// mobjs there.
+//
+
+static INT32 dormancyradius; // map units, as in the level header
+static INT32 dormancywakeradius;
+static mobj_t *dormancyviews[2*MAXPLAYERS];
+static INT32 numdormancyviews;
+
+/** Gathers the places dormant mobjs are woken up around for this tic.
+  * Called before running the thinkers.
+  */
+void P_UpdateDormancy(void)
+{
+	INT32 i;
+
+	numdormancyviews = 0;
+	dormancyradius = 0;
+
+	if (gamestate != GS_LEVEL || !mapheaderinfo[gamemap-1] || !mapheaderinfo[gamemap-1]->dormantradius)
+		return;
+
+	dormancyradius = mapheaderinfo[gamemap-1]->dormantradius;
+	dormancywakeradius = dormancyradius - dormancyradius/8;
+
+	for (i = 0; i < MAXPLAYERS; i++)
+	{
+		if (!playeringame[i])
+			continue;
+		if (players[i].mo && !P_MobjWasRemoved(players[i].mo))
+			dormancyviews[numdormancyviews++] = players[i].mo;
+		// Cutscene cameras are looking at something too
+		if (players[i].awayviewtics && players[i].awayviewmobj && !P_MobjWasRemoved(players[i].awayviewmobj))
+			dormancyviews[numdormancyviews++] = players[i].awayviewmobj;
+	}
+}
+
+/** Wakes a mobj up and keeps it awake until a player has been near it.
+  *
+  * \param mobj The mobj to wake up.
+  */
+void P_WakeMobj(mobj_t *mobj)
+{
+	if (!dormancyradius || (!(mobj->flags & MF_SLEEPABLE) && !(mobj->eflags & MFE_DORMANT)))
+		return;
+
+	mobj->eflags = (mobj->eflags & ~MFE_DORMANT)|MFE_WOKEN;
+}
+
+/** Wakes up every mobj touching a sector.
+  *
+  * \param sector The sector.
+  */
+void P_WakeSectorMobjs(sector_t *sector)
+{
+	msecnode_t *node;
+
+	for (node = sector->touching_thinglist; node; node = node->m_thinglist_next)
+		if (node->m_thing->eflags & MFE_DORMANT)
+			P_WakeMobj(node->m_thing);
+}
+
+// Is any player within radius of the mobj?
+static boolean P_DormancyViewNear(mobj_t *mobj, INT32 radius)
+{
+	const INT64 radiussq = (INT64)radius*radius;
+	INT32 i;
+
+	for (i = 0; i < numdormancyviews; i++)
+	{
+		// In map units, so far apart corners can't overflow
+		const INT64 dx = (mobj->x>>FRACBITS) - (dormancyviews[i]->x>>FRACBITS);
+		const INT64 dy = (mobj->y>>FRACBITS) - (dormancyviews[i]->y>>FRACBITS);
+
+		if (dx*dx + dy*dy <= radiussq)
+			return true;
+	}
+
+	return false;
+}
+
+// Should the mobj skip thinking this tic?
+static boolean P_MobjIsDormant(mobj_t *mobj)
+{
+	if (!dormancyradius || mobj->player
+	|| !((mobj->flags & MF_SLEEPABLE)
+		|| ((mobj->flags & MF_SCENERY) && (mapheaderinfo[gamemap-1]->levelflags & LF_DORMANTSCENERY))))
+	{
+		mobj->eflags &= ~MFE_DORMANT;
+		return false;
+	}
+
+	if (mobj->eflags & MFE_DORMANT)
+	{
+		if (!P_DormancyViewNear(mobj, dormancywakeradius))
+			return true;
+		mobj->eflags &= ~MFE_DORMANT;
+		return false;
+	}
+
+	if (P_DormancyViewNear(mobj, dormancyradius))
+	{
+		mobj->eflags &= ~MFE_WOKEN;
+		return false;
+	}
+
+	if (mobj->eflags & MFE_WOKEN)
+		return false;
+
+	mobj->eflags |= MFE_DORMANT;
+	return true;
+}
+
 //
 // P_MobjThinker
 //
@@ -10026,6 +10172,9 @@ void P_MobjThinker(mobj_t *mobj)
 	if (mobj->flags & MF_NOTHINK)
 		return;
 
+	if (P_MobjIsDormant(mobj))
+		return;
+
 	if ((mobj->flags & MF_BOSS) && mobj->spawnpoint && (bossdisabled & (1<<mobj->spawnpoint->extrainfo)))
 		return;
 
@@ -10459,7 +10608,7 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 	const mobjinfo_t *info = &mobjinfo[type];
 	SINT8 sc = -1;
 	state_t *st;
-	mobj_t *mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+	mobj_t *mobj = Z_PoolCalloc(&mobjpool);
 
 	// this is officially a mobj, declared as soon as possible.
 	mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker;
@@ -10801,6 +10950,8 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 		}
 	}
 
+	R_ResetMobjInterpolationState(mobj);
+
 	if (!(mobj->flags & MF_NOTHINK))
 		P_AddThinker(THINK_MOBJ, &mobj->thinker);
 
@@ -10840,10 +10991,9 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 	return mobj;
 }
 
-static precipmobj_t *P_SpawnPrecipMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
+static precipmobj_t *P_SpawnPrecipMobj(precipmobj_t *mobj, fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 {
 	state_t *st;
-	precipmobj_t *mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
 	fixed_t starting_floorz;
 
 	mobj->x = x;
@@ -10871,9 +11021,8 @@ static precipmobj_t *P_SpawnPrecipMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype
 
 	mobj->z = z;
 	mobj->momz = mobjinfo[type].speed;
-
-	mobj->thinker.function.acp1 = (actionf_p1)P_NullPrecipThinker;
-	P_AddThinker(THINK_PRECIP, &mobj->thinker);
+	R_ResetPrecipitationMobjInterpolationState(mobj);
+	mobj->lastthink = leveltime - 1;
 
 	CalculatePrecipFloor(mobj);
 
@@ -10887,19 +11036,16 @@ static precipmobj_t *P_SpawnPrecipMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype
 	return mobj;
 }
 
-static inline precipmobj_t *P_SpawnRainMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
+static inline precipmobj_t *P_SpawnRainMobj(precipmobj_t *mo, fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 {
-	precipmobj_t *mo = P_SpawnPrecipMobj(x,y,z,type);
+	P_SpawnPrecipMobj(mo,x,y,z,type);
 	mo->precipflags |= PCF_RAIN;
-	//mo->thinker.function.acp1 = (actionf_p1)P_RainThinker;
 	return mo;
 }
 
-static inline precipmobj_t *P_SpawnSnowMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
+static inline precipmobj_t *P_SpawnSnowMobj(precipmobj_t *mo, fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 {
-	precipmobj_t *mo = P_SpawnPrecipMobj(x,y,z,type);
-	//mo->thinker.function.acp1 = (actionf_p1)P_SnowThinker;
-	return mo;
+	return P_SpawnPrecipMobj(mo,x,y,z,type);
 }
 
 //
@@ -11011,8 +11157,12 @@ boolean P_MobjWasRemoved(mobj_t *mobj)
 	return true;
 }
 
+// The drop stays in precipmobjs, it's just never seen again
 void P_RemovePrecipMobj(precipmobj_t *mobj)
 {
+	if (!mobj->subsector)
+		return; // already removed
+
 	// unlink from sector and block lists
 	P_UnsetPrecipThingPosition(mobj);
 
@@ -11022,8 +11172,27 @@ void P_RemovePrecipMobj(precipmobj_t *mobj)
 		precipsector_list = NULL;
 	}
 
-	// free block
-	P_RemoveThinker((thinker_t *)mobj);
+	mobj->subsector = NULL;
+	mobj->precipflags |= PCF_INVISIBLE;
+}
+
+// Removes all of the level's precipitation
+void P_RemovePrecipitation(void)
+{
+	size_t i;
+
+	// The array may already be gone with the rest of PU_LEVEL,
+	// but the count still has to go
+	if (precipmobjs)
+	{
+		for (i = 0; i < numprecipmobjs; i++)
+			P_RemovePrecipMobj(&precipmobjs[i]);
+
+		Z_Free(precipmobjs);
+		precipmobjs = NULL;
+	}
+
+	numprecipmobjs = 0;
 }
 
 // Clearing out stuff for savegames
@@ -11058,10 +11227,18 @@ void P_SpawnPrecipitation(void)
 	fixed_t basex, basey, x, y, height;
 	subsector_t *precipsector = NULL;
 	precipmobj_t *rainmo = NULL;
+	fixed_t *spots;
+	size_t numspots = 0, n;
+
+	P_RemovePrecipitation();
 
 	if (dedicated || !(cv_drawdist_precip.value) || curWeather == PRECIP_NONE)
 		return;
 
+	// Pick all of the spots before spawning anything,
+	// so the drops can go into an array of the right size
+	spots = Z_Malloc(bmapwidth*bmapheight*2*sizeof (*spots), PU_STATIC, NULL);
+
 	// Use the blockmap to narrow down our placing patterns
 	for (i = 0; i < bmapwidth*bmapheight; ++i)
 	{
@@ -11082,35 +11259,57 @@ void P_SpawnPrecipitation(void)
 		if (!(precipsector->sector->floorheight <= precipsector->sector->ceilingheight - (32<<FRACBITS)))
 			continue;
 
-		// Don't set height yet...
-		height = precipsector->sector->ceilingheight;
-
 		if (curWeather == PRECIP_SNOW)
 		{
 			// Not in a sector with visible sky -- exception for NiGHTS.
 			if ((!(maptol & TOL_NIGHTS) && (precipsector->sector->ceilingpic != skyflatnum)) == !(precipsector->sector->flags & SF_INVERTPRECIP))
 				continue;
-
-			rainmo = P_SpawnSnowMobj(x, y, height, MT_SNOWFLAKE);
-			mrand = M_RandomByte();
-			if (mrand < 64)
-				P_SetPrecipMobjState(rainmo, S_SNOW3);
-			else if (mrand < 144)
-				P_SetPrecipMobjState(rainmo, S_SNOW2);
 		}
 		else // everything else.
 		{
 			// Not in a sector with visible sky.
 			if ((precipsector->sector->ceilingpic != skyflatnum) == !(precipsector->sector->flags & SF_INVERTPRECIP))
 				continue;
+		}
+
+		spots[2*numspots] = x;
+		spots[2*numspots+1] = y;
+		numspots++;
+	}
+
+	if (numspots)
+	{
+		precipmobjs = Z_Calloc(numspots*sizeof (*precipmobjs), PU_LEVEL, &precipmobjs);
+		numprecipmobjs = numspots;
+	}
+
+	for (n = 0; n < numspots; n++)
+	{
+		x = spots[2*n];
+		y = spots[2*n+1];
+		precipsector = R_PointInSubsector(x, y);
+
+		// Don't set height yet...
+		height = precipsector->sector->ceilingheight;
 
-			rainmo = P_SpawnRainMobj(x, y, height, MT_RAIN);
+		if (curWeather == PRECIP_SNOW)
+		{
+			rainmo = P_SpawnSnowMobj(&precipmobjs[n], x, y, height, MT_SNOWFLAKE);
+			mrand = M_RandomByte();
+			if (mrand < 64)
+				P_SetPrecipMobjState(rainmo, S_SNOW3);
+			else if (mrand < 144)
+				P_SetPrecipMobjState(rainmo, S_SNOW2);
 		}
+		else // everything else.
+			rainmo = P_SpawnRainMobj(&precipmobjs[n], x, y, height, MT_RAIN);
 
 		// Randomly assign a height, now that floorz is set.
 		rainmo->z = M_RandomRange(rainmo->floorz>>FRACBITS, rainmo->ceilingz>>FRACBITS)<<FRACBITS;
 	}
 
+	Z_Free(spots);
+
 	if (curWeather == PRECIP_BLANK)
 	{
 		curWeather = PRECIP_RAIN;
@@ -11414,6 +11613,7 @@ void P_SpawnPlayer(INT32 playernum)
 	// Set bounds accurately.
 	mobj->radius = FixedMul(skins[p->skin].radius, mobj->scale);
 	mobj->height = P_GetPlayerHeight(p);
+	P_UpdateBlockThing(mobj);
 
 	if (!leveltime && !p->spectator && ((maptol & TOL_NIGHTS) == TOL_NIGHTS) != (G_IsSpecialStage(gamemap))) // non-special NiGHTS stage or special non-NiGHTS stage
 	{
@@ -11556,6 +11756,7 @@ void P_MovePlayerToSpawn(INT32 playernum, mapthing_t *mthing)
 	mobj->angle = angle;
 
 	P_AfterPlayerSpawn(playernum);
+	R_ResetMobjInterpolationState(mobj);
 }
 
 void P_MovePlayerToStarpost(INT32 playernum)
@@ -11605,6 +11806,7 @@ void P_MovePlayerToStarpost(INT32 playernum)
 	mobj->angle = p->starpostangle;
 
 	P_AfterPlayerSpawn(playernum);
+	R_ResetMobjInterpolationState(mobj);
 
 	if (!(netgame || multiplayer))
 		leveltime = p->starposttime;
@@ -12421,7 +12623,10 @@ static boolean P_SetupNiGHTSDrone(mapthing_t* mthing, mobj_t* mobj)
 		mobj->health = timelimit;
 
 	if (hitboxradius > 0)
+	{
 		mobj->radius = hitboxradius;
+		P_UpdateBlockThing(mobj);
+	}
 
 	if (hitboxheight > 0)
 		mobj->height = hitboxheight;
@@ -12849,7 +13054,10 @@ static boolean P_SetupSpawnedMapThing(mapthing_t *mthing, mobj_t *mobj, boolean
 			mobj->flags2 |= MF2_AMBUSH;
 
 		if (mthing->angle > 0)
+		{
 			mobj->radius = (mthing->angle & 16383) << FRACBITS;
+			P_UpdateBlockThing(mobj);
+		}
 		// FALLTHRU
 	case MT_AXISTRANSFER:
 	case MT_AXISTRANSFERLINE:
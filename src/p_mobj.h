@@ -28,6 +28,9 @@
 // Needs precompiled tables/data structures.
 #include "info.h"
 
+// For the object pools.
+#include "z_zone.h"
+
 //
 // NOTES: mobj_t
 //
@@ -159,7 +162,9 @@ typedef enum
 	MF_GRENADEBOUNCE    = 1<<28,
 	// Run the action thinker on spawn.
 	MF_RUNSPAWNFUNC     = 1<<29,
-	// free: 1<<30 and 1<<31
+	// Can go dormant when far away from all players, see P_UpdateDormancy.
+	MF_SLEEPABLE        = 1<<30,
+	// free: 1<<31
 } mobjflag_t;
 
 typedef enum
@@ -244,6 +249,11 @@ typedef enum
 	// Compute and trigger on mobj angle relative to tracer
 	// See Linedef Exec 457 (Track mobj angle to point)
 	MFE_TRACERANGLE       = 1<<11,
+	// Too far away from every player to think
+	MFE_DORMANT           = 1<<12,
+	// Woken up by something other than a player coming near,
+	// stays awake until one has
+	MFE_WOKEN             = 1<<13,
 	// free: to and including 1<<15
 } mobjeflag_t;
 
@@ -261,8 +271,6 @@ typedef enum {
 	PCF_MOVINGFOF = 8,
 	// Is rain.
 	PCF_RAIN = 16,
-	// Ran the thinker this tic.
-	PCF_THUNK = 32,
 } precipflag_t;
 // Map Object definition.
 typedef struct mobj_s
@@ -272,6 +280,7 @@ typedef struct mobj_s
 
 	// Info for drawing: position.
 	fixed_t x, y, z;
+	fixed_t old_x, old_y, old_z; // at the start of the tic, for frame interpolation
 
 	// More list: links in sector (if needed)
 	struct mobj_s *snext;
@@ -280,6 +289,7 @@ typedef struct mobj_s
 	// More drawing info: to determine current sprite.
 	angle_t angle, pitch, roll; // orientation
 	angle_t rollangle;
+	angle_t old_angle; // at the start of the tic
 	spritenum_t sprite; // used to find patch_t and flip value
 	UINT32 frame; // frame number, plus bits see p_pspr.h
 	UINT8 sprite2; // player sprites
@@ -388,11 +398,12 @@ typedef struct mobj_s
 //
 typedef struct precipmobj_s
 {
-	// List: thinker links.
+	// Unused, precipitation is kept in precipmobjs rather than the thinker lists.
 	thinker_t thinker;
 
 	// Info for drawing: position.
 	fixed_t x, y, z;
+	fixed_t old_x, old_y, old_z; // at the start of the tic, for frame interpolation
 
 	// More list: links in sector (if needed)
 	struct precipmobj_s *snext;
@@ -401,6 +412,7 @@ typedef struct precipmobj_s
 	// More drawing info: to determine current sprite.
 	angle_t angle, pitch, roll;  // orientation
 	angle_t rollangle;
+	angle_t old_angle; // at the start of the tic
 	spritenum_t sprite; // used to find patch_t and flip value
 	UINT32 frame; // frame number, plus bits see p_pspr.h
 	UINT8 sprite2; // player sprites
@@ -427,6 +439,8 @@ typedef struct precipmobj_s
 	INT32 tics; // state tic counter
 	state_t *state;
 	INT32 flags; // flags from mobjinfo tables
+
+	tic_t lastthink; // leveltime of the last P_PrecipThink
 } precipmobj_t;
 
 typedef struct actioncache_s
@@ -439,6 +453,11 @@ typedef struct actioncache_s
 
 extern actioncache_t actioncachehead;
 
+extern zpool_t mobjpool;
+
+extern precipmobj_t *precipmobjs;
+extern size_t numprecipmobjs;
+
 void P_InitCachedActions(void);
 void P_RunCachedActions(void);
 void P_AddCachedAction(mobj_t *mobj, INT32 statenum);
@@ -467,8 +486,9 @@ boolean P_SupermanLook4Players(mobj_t *actor);
 void P_DestroyRobots(void);
 void P_SnowThinker(precipmobj_t *mobj);
 void P_RainThinker(precipmobj_t *mobj);
-void P_NullPrecipThinker(precipmobj_t *mobj);
+void P_PrecipThink(precipmobj_t *mobj);
 void P_RemovePrecipMobj(precipmobj_t *mobj);
+void P_RemovePrecipitation(void);
 void P_SetScale(mobj_t *mobj, fixed_t newscale);
 void P_XYMovement(mobj_t *mo);
 void P_RingXYMovement(mobj_t *mo);
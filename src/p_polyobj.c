@@ -99,7 +99,7 @@ polymaplink_t **polyblocklinks;
 //
 
 // Polyobject Blockmap
-static polymaplink_t *bmap_freelist; // free list of blockmap links
+static zpool_t polymaplinkpool = Z_POOL("Polyobj links", sizeof (polymaplink_t), PU_LEVEL); // blockmap links
 
 
 //
@@ -644,31 +644,16 @@ static void Polyobj_removeFromSubsec(polyobj_t *po)
 
 // Blockmap Functions
 
-// Retrieves a polymaplink object from the free list or creates a new one.
+// Retrieves a polymaplink object from the pool.
 static polymaplink_t *Polyobj_getLink(void)
 {
-	polymaplink_t *l;
-
-	if (bmap_freelist)
-	{
-		l = bmap_freelist;
-		bmap_freelist = (polymaplink_t *)(l->link.next);
-	}
-	else
-	{
-		l = Z_Malloc(sizeof(*l), PU_LEVEL, NULL);
-		memset(l, 0, sizeof(*l));
-	}
-
-	return l;
+	return Z_PoolCalloc(&polymaplinkpool);
 }
 
-// Puts a polymaplink object into the free list.
+// Puts a polymaplink object back into the pool.
 static void Polyobj_putLink(polymaplink_t *l)
 {
-	memset(l, 0, sizeof(*l));
-	l->link.next = (mdllistitem_t *)bmap_freelist;
-	bmap_freelist = l;
+	Z_PoolFree(l);
 }
 
 // Inserts a polyobject into the polyobject blockmap. Unlike, mobj_t's,
@@ -1026,6 +1011,7 @@ static boolean Polyobj_moveXY(polyobj_t *po, fixed_t x, fixed_t y, boolean check
 		Polyobj_removeFromSubsec(po);   // unlink it from its subsector
 		Polyobj_linkToBlockmap(po);     // relink to blockmap
 		Polyobj_attachToSubsec(po);     // relink to subsector
+		P_ClearSightCache();            // may block or unblock sight now
 	}
 
 	return !(hitflags & 2);
@@ -1226,6 +1212,7 @@ static boolean Polyobj_rotate(polyobj_t *po, angle_t delta, UINT8 turnthings, bo
 		Polyobj_removeFromSubsec(po);   // remove from subsector
 		Polyobj_linkToBlockmap(po);     // relink to blockmap
 		Polyobj_attachToSubsec(po);     // relink to subsector
+		P_ClearSightCache();            // may block or unblock sight now
 	}
 
 	return !(hitflags & 2);
@@ -1292,11 +1279,10 @@ void Polyobj_InitLevel(void)
 	M_QueueInit(&anchorqueue);
 
 	// get rid of values from previous level
-	// note: as with msecnodes, it is very important to clear out the blockmap
-	// node freelist, otherwise it may contain dangling pointers to old objects
+	// note: the blockmap link pool is emptied by Z_FreeTags along with the
+	// rest of the level, so it can't hand out links to the old objects
 	PolyObjects    = NULL;
 	numPolyObjects = 0;
-	bmap_freelist  = NULL;
 
 	// run down the thinker list, count the number of spawn points, and save
 	// the mobj_t pointers on a queue for use below.
@@ -2546,6 +2532,7 @@ void T_PolyObjFade(polyfade_t *th)
 			po->flags &= ~POF_RENDERALL;
 		else
 			po->flags |= (po->spawnflags & POF_RENDERALL);
+		P_ClearSightCache();
 
 		// set collision
 		if (th->docollision)
@@ -1051,6 +1051,8 @@ static void UnArchiveSectors(void)
 			sectors[i].floorheight = READFIXED(save_p);
 		if (diff & SD_CEILHT)
 			sectors[i].ceilingheight = READFIXED(save_p);
+		if (diff & (SD_FLOORHT|SD_CEILHT))
+			P_SectorHeightsChanged(&sectors[i]);
 		if (diff & SD_FLOORPIC)
 		{
 			sectors[i].floorpic = P_AddLevelFlatRuntime((char *)save_p);
@@ -2244,8 +2246,7 @@ static void P_NetArchiveThinkers(void)
 		// save off the current thinkers
 		for (th = thlist[i].next; th != &thlist[i]; th = th->next)
 		{
-			if (!(th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed
-			 || th->function.acp1 == (actionf_p1)P_NullPrecipThinker))
+			if (th->function.acp1 != (actionf_p1)P_RemoveThinkerDelayed)
 				numsaved++;
 
 			if (th->function.acp1 == (actionf_p1)P_MobjThinker)
@@ -2253,9 +2254,6 @@ static void P_NetArchiveThinkers(void)
 				SaveMobjThinker(th, tc_mobj);
 				continue;
 			}
-	#ifdef PARANOIA
-			else if (th->function.acp1 == (actionf_p1)P_NullPrecipThinker);
-	#endif
 			else if (th->function.acp1 == (actionf_p1)T_MoveCeiling)
 			{
 				SaveCeilingThinker(th, tc_ceiling);
@@ -2574,13 +2572,13 @@ static thinker_t* LoadMobjThinker(actionf_p1 thinker)
 			return NULL;
 		}
 
-		mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+		mobj = Z_PoolCalloc(&mobjpool);
 
 		mobj->spawnpoint = &mapthings[spawnpointnum];
 		mapthings[spawnpointnum].mobj = mobj;
 	}
 	else
-		mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+		mobj = Z_PoolCalloc(&mobjpool);
 
 	// declare this as a valid mobj as soon as possible.
 	mobj->thinker.function.acp1 = thinker;
@@ -3403,6 +3401,7 @@ static void P_NetUnArchiveThinkers(void)
 	// we don't want the removed mobjs to come back
 	iquetail = iquehead = 0;
 	P_InitThinkers();
+	P_ClearSightCache();
 
 	// clear sector thinker pointers so they don't point to non-existant thinkers for all of eternity
 	for (i = 0; i < numsectors; i++)
@@ -106,6 +106,11 @@ mapthing_t *mapthings;
 sector_t *spawnsectors;
 line_t *spawnlines;
 side_t *spawnsides;
+
+// All of the above, and the blockmap and reject data below,
+// are carved out of this one after the other.
+zarena_t levelarena = Z_ARENA("Level geometry", PU_LEVEL);
+
 INT32 numstarposts;
 UINT16 bossdisabled;
 boolean stoppedclock;
@@ -130,6 +135,7 @@ INT32 *blockmaplump; // Big blockmap
 fixed_t bmaporgx, bmaporgy;
 // for thing chains
 mobj_t **blocklinks;
+blockthings_t *blockthings;
 
 // REJECT
 // For fast sight rejection.
@@ -351,6 +357,7 @@ static void P_ClearSingleMapHeaderInfo(INT16 i)
 	mapheaderinfo[num]->sstimer = 90;
 	mapheaderinfo[num]->ssspheres = 1;
 	mapheaderinfo[num]->gravity = FRACUNIT/2;
+	mapheaderinfo[num]->dormantradius = 0;
 	mapheaderinfo[num]->keywords[0] = '\0';
 	snprintf(mapheaderinfo[num]->musname, 7, "%sM", G_BuildMapName(i));
 	mapheaderinfo[num]->musname[6] = 0;
@@ -520,6 +527,11 @@ size_t P_PrecacheLevelFlats(void)
 	lumpnum_t lump;
 	size_t i;
 
+	// Get them all decompressing in the background first
+	for (i = 0; i < numlevelflats; i++)
+		if (levelflats[i].type == LEVELFLAT_FLAT)
+			W_PrefetchLump(levelflats[i].u.flat.lumpnum);
+
 	//SoM: 4/18/2000: New flat code to make use of levelflats.
 	flatmemory = 0;
 	for (i = 0; i < numlevelflats; i++)
@@ -992,6 +1004,10 @@ static void P_InitializeSector(sector_t *ss)
 	ss->linecount = 0;
 	ss->lines = NULL;
 
+	ss->neighborcount = 0;
+	ss->neighbors = NULL;
+	ss->surroundingvalid = false;
+
 	ss->ffloors = NULL;
 	ss->attached = NULL;
 	ss->attachedsolid = NULL;
@@ -1411,6 +1427,328 @@ UINT32 sidesPos[UINT16_MAX];
 UINT32 vertexesPos[UINT16_MAX];
 UINT32 sectorsPos[UINT16_MAX];
 
+//
+// Compiled map cache
+//
+// Tokenizing a big TEXTMAP is by far the slowest part of loading a UDMF
+// level, so once one has been parsed, its elements are saved to MAPCACHEDIR
+// in srb2home as runs of key/value strings, together with the blockmap built
+// for it. The next time a TEXTMAP with the same MD5 is loaded, the whole file
+// is read back at once and the tokenizer is skipped entirely.
+//
+// The values still go through the ParseTextmap*Parameter functions, because
+// texture, flat and colormap names must be resolved against the addons that
+// are loaded right now. The nodes need no caching, UDMF maps get them from
+// an already binary ZNODES lump.
+//
+// Cache files use the native byte order, they never leave this machine.
+// Disabled with the -nomapcache parameter.
+//
+#define MAPCACHEDIR "mapcache"
+#define MAPCACHEVERSION 1
+
+typedef struct
+{
+	char magic[8]; // "SRB2UDMC"
+	UINT32 version; // MAPCACHEVERSION
+	UINT8 md5[16]; // of the TEXTMAP lump
+
+	UINT32 numvertexes, numsectors, numlines, numsides, nummapthings;
+	UINT32 textsize; // bytes of element strings following the header
+
+	INT32 bmaporgx, bmaporgy, bmapwidth, bmapheight;
+	UINT32 blockmapsize; // entries of blockmaplump following the strings, 0 if none
+} mapcacheheader_t;
+
+static const char mapcachemagic[8] = {'S','R','B','2','U','D','M','C'};
+
+static UINT8 *mapcachedata = NULL; // cache file being loaded from
+static char *mapcachetext = NULL; // its element strings
+
+static boolean mapcacherecord = false; // saving elements as they are parsed
+static char *mapcacherec = NULL;
+static size_t mapcacherecsize, mapcacherecalloc;
+
+static size_t createdblockmapsize = 0; // blockmaplump entries made by P_CreateBlockMap
+
+static const char *P_MapCachePath(const UINT8 *md5)
+{
+	char hex[33];
+	UINT8 i;
+
+	for (i = 0; i < 16; i++)
+		sprintf(&hex[i*2], "%02x", md5[i]);
+
+	return va("%s" PATHSEP MAPCACHEDIR PATHSEP "%s.dat", srb2home, hex);
+}
+
+/** Checks that the element strings of a cache file are well formed and
+  * finds where every element starts. Each element is a run of key and
+  * value strings, ended by an empty key.
+  *
+  * \param text Element strings.
+  * \param size Size of the strings, in bytes.
+  * \param pos Position table to fill.
+  * \param num Number of elements to find.
+  * \param offs Current offset into the strings, advanced past the elements.
+  * \return True if the elements fit in the strings.
+  */
+static boolean P_IndexCachedElements(const char *text, size_t size, UINT32 *pos, size_t num, size_t *offs)
+{
+	size_t i, o = *offs;
+	const char *end;
+	UINT8 s;
+
+	for (i = 0; i < num; i++)
+	{
+		pos[i] = (UINT32)o;
+		while (true)
+		{
+			if (o >= size)
+				return false;
+			if (!text[o])
+				break;
+
+			// key, then value
+			for (s = 0; s < 2; s++)
+			{
+				end = memchr(text + o, '\0', size - o);
+				if (!end)
+					return false;
+				o = end - text + 1;
+			}
+		}
+		o++;
+	}
+
+	*offs = o;
+	return true;
+}
+
+/** Reads the compiled version of the current map, if there is one and it was
+  * made from the same TEXTMAP, and sets the element counts from it.
+  *
+  * \return True if the elements will be parsed from the cache.
+  */
+static boolean P_LoadCompiledTextmap(void)
+{
+	mapcacheheader_t *header;
+	FILE *f;
+	long len;
+	size_t offs = 0;
+
+	f = fopen(P_MapCachePath(mapmd5), "rb");
+	if (!f)
+		return false;
+
+	fseek(f, 0, SEEK_END);
+	len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	if (len < (long)sizeof (*header))
+	{
+		fclose(f);
+		return false;
+	}
+
+	mapcachedata = malloc(len);
+	if (!mapcachedata || fread(mapcachedata, 1, len, f) != (size_t)len)
+	{
+		fclose(f);
+		goto stale;
+	}
+	fclose(f);
+
+	header = (mapcacheheader_t *)mapcachedata;
+	mapcachetext = (char *)(header + 1);
+
+	if (memcmp(header->magic, mapcachemagic, sizeof mapcachemagic)
+		|| header->version != MAPCACHEVERSION
+		|| memcmp(header->md5, mapmd5, 16)
+		|| (size_t)len != sizeof (*header) + header->textsize + header->blockmapsize * sizeof (INT32)
+		|| header->numvertexes >= UINT16_MAX || header->numsectors >= UINT16_MAX
+		|| header->numlines >= UINT16_MAX || header->numsides >= UINT16_MAX
+		|| header->nummapthings >= UINT16_MAX)
+		goto stale;
+
+	numvertexes  = header->numvertexes;
+	numsectors   = header->numsectors;
+	numlines     = header->numlines;
+	numsides     = header->numsides;
+	nummapthings = header->nummapthings;
+
+	// Same order as P_LoadTextmap parses them in.
+	if (!(P_IndexCachedElements(mapcachetext, header->textsize, vertexesPos, numvertexes, &offs)
+		&& P_IndexCachedElements(mapcachetext, header->textsize, sectorsPos, numsectors, &offs)
+		&& P_IndexCachedElements(mapcachetext, header->textsize, linesPos, numlines, &offs)
+		&& P_IndexCachedElements(mapcachetext, header->textsize, sidesPos, numsides, &offs)
+		&& P_IndexCachedElements(mapcachetext, header->textsize, mapthingsPos, nummapthings, &offs))
+		|| offs != header->textsize)
+		goto stale;
+
+	CONS_Debug(DBG_SETUP, "Loading compiled map %s\n", P_MapCachePath(mapmd5));
+	return true;
+
+stale:
+	CONS_Debug(DBG_SETUP, "Compiled map %s is stale, parsing TEXTMAP\n", P_MapCachePath(mapmd5));
+	free(mapcachedata);
+	mapcachedata = NULL;
+	mapcachetext = NULL;
+	return false;
+}
+
+/** Loads the blockmap saved with the compiled map, if it has one.
+  *
+  * \return True if the blockmap was loaded.
+  */
+static boolean P_LoadCachedBlockMap(void)
+{
+	mapcacheheader_t *header = (mapcacheheader_t *)mapcachedata;
+	size_t count;
+
+	if (!header || !header->blockmapsize
+		|| (size_t)header->bmapwidth * header->bmapheight + 4 > header->blockmapsize)
+		return false;
+
+	blockmaplump = Z_ArenaAlloc(&levelarena, sizeof (*blockmaplump) * header->blockmapsize);
+	M_Memcpy(blockmaplump, mapcachetext + header->textsize, sizeof (*blockmaplump) * header->blockmapsize);
+
+	bmaporgx = header->bmaporgx;
+	bmaporgy = header->bmaporgy;
+	bmapwidth = header->bmapwidth;
+	bmapheight = header->bmapheight;
+
+	// clear out mobj chains
+	count = sizeof (*blocklinks) * bmapwidth * bmapheight;
+	blocklinks = Z_ArenaCalloc(&levelarena, count);
+	blockthings = Z_ArenaCalloc(&levelarena, sizeof (*blockthings) * bmapwidth * bmapheight);
+	blockmap = blockmaplump + 4;
+
+	// haleyjd 2/22/06: setup polyobject blockmap
+	count = sizeof(*polyblocklinks) * bmapwidth * bmapheight;
+	polyblocklinks = Z_ArenaCalloc(&levelarena, count);
+	return true;
+}
+
+/** Saves a string of the element being parsed from the TEXTMAP.
+  */
+static void P_RecordTextmapString(const char *str)
+{
+	size_t len = strlen(str) + 1;
+
+	if (!mapcacherecord)
+		return;
+
+	if (mapcacherecsize + len > mapcacherecalloc)
+	{
+		char *rec;
+
+		if (!mapcacherecalloc)
+			mapcacherecalloc = 1<<16;
+		while (mapcacherecsize + len > mapcacherecalloc)
+			mapcacherecalloc *= 2;
+
+		rec = realloc(mapcacherec, mapcacherecalloc);
+		if (!rec)
+		{
+			mapcacherecord = false;
+			return;
+		}
+		mapcacherec = rec;
+	}
+
+	M_Memcpy(mapcacherec + mapcacherecsize, str, len);
+	mapcacherecsize += len;
+}
+
+/** Writes the elements saved while parsing the TEXTMAP to the map cache,
+  * along with the blockmap if it had to be built.
+  */
+static void P_SaveCompiledTextmap(void)
+{
+	mapcacheheader_t header;
+	const char *path;
+	FILE *f;
+
+	memset(&header, 0, sizeof header);
+	M_Memcpy(header.magic, mapcachemagic, sizeof mapcachemagic);
+	header.version = MAPCACHEVERSION;
+	M_Memcpy(header.md5, mapmd5, 16);
+
+	header.numvertexes  = (UINT32)numvertexes;
+	header.numsectors   = (UINT32)numsectors;
+	header.numlines     = (UINT32)numlines;
+	header.numsides     = (UINT32)numsides;
+	header.nummapthings = (UINT32)nummapthings;
+	header.textsize     = (UINT32)mapcacherecsize;
+
+	if (createdblockmapsize)
+	{
+		header.bmaporgx = bmaporgx;
+		header.bmaporgy = bmaporgy;
+		header.bmapwidth = bmapwidth;
+		header.bmapheight = bmapheight;
+		header.blockmapsize = (UINT32)createdblockmapsize;
+	}
+
+	I_mkdir(va("%s" PATHSEP MAPCACHEDIR, srb2home), 0755);
+
+	path = P_MapCachePath(mapmd5);
+	f = fopen(path, "wb");
+	if (!f)
+	{
+		CONS_Debug(DBG_SETUP, "Can't write compiled map %s\n", path);
+		return;
+	}
+
+	// A partly written file fails the size check and is simply parsed again.
+	if (fwrite(&header, sizeof header, 1, f) != 1
+		|| fwrite(mapcacherec, 1, mapcacherecsize, f) != mapcacherecsize
+		|| fwrite(blockmaplump, sizeof (*blockmaplump), header.blockmapsize, f) != header.blockmapsize)
+		CONS_Debug(DBG_SETUP, "Can't write compiled map %s\n", path);
+
+	fclose(f);
+}
+
+/** Looks for a compiled version of the UDMF map about to be loaded,
+  * or prepares to make one if there is none.
+  */
+static void P_OpenMapCache(void)
+{
+	mapcacherecord = false;
+	mapcacherecsize = 0;
+	createdblockmapsize = 0;
+
+#ifdef NOMD5
+	return; // No way to tell maps apart
+#else
+	if (M_CheckParm("-nomapcache"))
+		return;
+
+	if (!P_LoadCompiledTextmap())
+		mapcacherecord = true;
+#endif
+}
+
+/** Done loading the map; saves it to the map cache if it was parsed.
+  *
+  * \param save False if the map failed to load.
+  */
+static void P_CloseMapCache(boolean save)
+{
+	if (save && mapcacherecord)
+		P_SaveCompiledTextmap();
+
+	free(mapcachedata);
+	mapcachedata = NULL;
+	mapcachetext = NULL;
+
+	free(mapcacherec);
+	mapcacherec = NULL;
+	mapcacherecsize = mapcacherecalloc = 0;
+	mapcacherecord = false;
+}
+
 // Determine total amount of map data in TEXTMAP.
 static boolean TextmapCount(UINT8 *data, size_t size)
 {
@@ -1715,7 +2053,8 @@ static void ParseTextmapThingParameter(UINT32 i, char *param, char *val)
 	}
 }
 
-/** From a given position table, run a specified parser function through a {}-encapsuled text.
+/** From a given position table, run a specified parser function through a {}-encapsuled text,
+  * or through the element's strings when loading a compiled map.
   *
   * \param Position of the data to parse, in the textmap.
   * \param Structure number (mapthings, sectors, ...).
@@ -1725,11 +2064,22 @@ static void TextmapParse(UINT32 dataPos, size_t num, void (*parser)(UINT32, char
 {
 	char *param, *val;
 
+	if (mapcachetext)
+	{
+		for (param = mapcachetext + dataPos; *param; param = val + strlen(val) + 1)
+		{
+			val = param + strlen(param) + 1;
+			parser(num, param, val);
+		}
+		return;
+	}
+
 	M_SetTokenPos(dataPos);
 	param = M_GetToken(NULL);
 	if (!fastcmp(param, "{"))
 	{
 		Z_Free(param);
+		P_RecordTextmapString("");
 		CONS_Alert(CONS_WARNING, "Invalid UDMF data capsule!\n");
 		return;
 	}
@@ -1744,10 +2094,15 @@ static void TextmapParse(UINT32 dataPos, size_t num, void (*parser)(UINT32, char
 			break;
 		}
 		val = M_GetToken(NULL);
+		if (!*param) // would end the element early
+			mapcacherecord = false;
+		P_RecordTextmapString(param);
+		P_RecordTextmapString(val);
 		parser(num, param, val);
 		Z_Free(param);
 		Z_Free(val);
 	}
+	P_RecordTextmapString("");
 }
 
 /** Provides a fix to the flat alignment coordinate transform from standard Textmaps.
@@ -1995,7 +2350,7 @@ static boolean P_LoadMapData(const virtres_t *virt)
 	if (udmf) // Count how many entries for each type we got in textmap.
 	{
 		virtlump_t *textmap = vres_Find(virt, "TEXTMAP");
-		if (!TextmapCount(textmap->data, textmap->size))
+		if (!mapcachetext && !TextmapCount(textmap->data, textmap->size))
 			return false;
 	}
 	else
@@ -2034,11 +2389,11 @@ static boolean P_LoadMapData(const virtres_t *virt)
 	if (numlines <= 0)
 		I_Error("Level has no linedefs");
 
-	vertexes  = Z_Calloc(numvertexes * sizeof (*vertexes), PU_LEVEL, NULL);
-	sectors   = Z_Calloc(numsectors * sizeof (*sectors), PU_LEVEL, NULL);
-	sides     = Z_Calloc(numsides * sizeof (*sides), PU_LEVEL, NULL);
-	lines     = Z_Calloc(numlines * sizeof (*lines), PU_LEVEL, NULL);
-	mapthings = Z_Calloc(nummapthings * sizeof (*mapthings), PU_LEVEL, NULL);
+	vertexes  = Z_ArenaCalloc(&levelarena, numvertexes * sizeof (*vertexes));
+	sectors   = Z_ArenaCalloc(&levelarena, numsectors * sizeof (*sectors));
+	sides     = Z_ArenaCalloc(&levelarena, numsides * sizeof (*sides));
+	lines     = Z_ArenaCalloc(&levelarena, numlines * sizeof (*lines));
+	mapthings = Z_ArenaCalloc(&levelarena, nummapthings * sizeof (*mapthings));
 
 	// Allocate a big chunk of memory as big as our MAXLEVELFLATS limit.
 	//Fab : FIXME: allocate for whatever number of flats - 512 different flats per level should be plenty
@@ -2327,14 +2682,14 @@ static boolean P_LoadExtendedSubsectorsAndSegs(UINT8 **data, nodetype_t nodetype
 
 	// Subsectors
 	numsubsectors = READUINT32((*data));
-	subsectors = Z_Calloc(numsubsectors*sizeof(*subsectors), PU_LEVEL, NULL);
+	subsectors = Z_ArenaCalloc(&levelarena, numsubsectors*sizeof(*subsectors));
 
 	for (i = 0; i < numsubsectors; i++)
 		subsectors[i].numlines = READUINT32((*data));
 
 	// Segs
 	numsegs = READUINT32((*data));
-	segs = Z_Calloc(numsegs*sizeof(*segs), PU_LEVEL, NULL);
+	segs = Z_ArenaCalloc(&levelarena, numsegs*sizeof(*segs));
 
 	for (i = 0, k = 0; i < numsubsectors; i++)
 	{
@@ -2420,7 +2775,7 @@ static void P_LoadExtendedNodes(UINT8 **data, nodetype_t nodetype)
 	boolean xgl3 = (nodetype == NT_XGL3);
 
 	numnodes = READINT32((*data));
-	nodes = Z_Calloc(numnodes*sizeof(*nodes), PU_LEVEL, NULL);
+	nodes = Z_ArenaCalloc(&levelarena, numnodes*sizeof(*nodes));
 
 	for (i = 0, mn = nodes; i < numnodes; i++, mn++)
 	{
@@ -2465,9 +2820,9 @@ static void P_LoadMapBSP(const virtres_t *virt)
 		if (numsegs <= 0)
 			I_Error("Level has no segs");
 
-		subsectors = Z_Calloc(numsubsectors * sizeof(*subsectors), PU_LEVEL, NULL);
-		nodes      = Z_Calloc(numnodes * sizeof(*nodes), PU_LEVEL, NULL);
-		segs       = Z_Calloc(numsegs * sizeof(*segs), PU_LEVEL, NULL);
+		subsectors = Z_ArenaCalloc(&levelarena, numsubsectors * sizeof(*subsectors));
+		nodes      = Z_ArenaCalloc(&levelarena, numnodes * sizeof(*nodes));
+		segs       = Z_ArenaCalloc(&levelarena, numsegs * sizeof(*segs));
 
 		P_LoadSubsectors(virtssectors->data);
 		P_LoadNodes(virtnodes->data);
@@ -2495,7 +2850,7 @@ static void P_LoadMapBSP(const virtres_t *virt)
 static void P_ReadBlockMapLump(INT16 *wadblockmaplump, size_t count)
 {
 	size_t i;
-	blockmaplump = Z_Calloc(sizeof (*blockmaplump) * count, PU_LEVEL, NULL);
+	blockmaplump = Z_ArenaCalloc(&levelarena, sizeof (*blockmaplump) * count);
 
 	// killough 3/1/98: Expand wad blockmap into larger internal one,
 	// by treating all offsets except -1 as unsigned and zero-extending
@@ -2536,12 +2891,13 @@ static boolean P_LoadBlockMap(UINT8 *data, size_t count)
 
 	// clear out mobj chains
 	count = sizeof (*blocklinks)* bmapwidth*bmapheight;
-	blocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+	blocklinks = Z_ArenaCalloc(&levelarena, count);
+	blockthings = Z_ArenaCalloc(&levelarena, sizeof (*blockthings) * bmapwidth * bmapheight);
 	blockmap = blockmaplump+4;
 
 	// haleyjd 2/22/06: setup polyobject blockmap
 	count = sizeof(*polyblocklinks) * bmapwidth * bmapheight;
-	polyblocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+	polyblocklinks = Z_ArenaCalloc(&levelarena, count);
 	return true;
 }
 
@@ -2759,7 +3115,8 @@ static void P_CreateBlockMap(void)
 					count += bmap[i].n + 2; // 1 header word + 1 trailer word + blocklist
 
 			// Allocate blockmap lump with computed count
-			blockmaplump = Z_Calloc(sizeof (*blockmaplump) * count, PU_LEVEL, NULL);
+			blockmaplump = Z_ArenaCalloc(&levelarena, sizeof (*blockmaplump) * count);
+			createdblockmapsize = count;
 		}
 
 		// Now compress the blockmap.
@@ -2789,12 +3146,13 @@ static void P_CreateBlockMap(void)
 	{
 		size_t count = sizeof (*blocklinks) * bmapwidth * bmapheight;
 		// clear out mobj chains (copied from from P_LoadBlockMap)
-		blocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+		blocklinks = Z_ArenaCalloc(&levelarena, count);
+		blockthings = Z_ArenaCalloc(&levelarena, sizeof (*blockthings) * bmapwidth * bmapheight);
 		blockmap = blockmaplump + 4;
 
 		// haleyjd 2/22/06: setup polyobject blockmap
 		count = sizeof(*polyblocklinks) * bmapwidth * bmapheight;
-		polyblocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+		polyblocklinks = Z_ArenaCalloc(&levelarena, count);
 	}
 }
 
@@ -2807,9 +3165,14 @@ static void P_LoadReject(UINT8 *data, size_t count)
 		rejectmatrix = NULL;
 		CONS_Debug(DBG_SETUP, "P_LoadReject: REJECT lump has size 0, will not be loaded\n");
 	}
+	else if (count < (numsectors*numsectors + 7)/8) // P_CheckSight would read past the end
+	{
+		rejectmatrix = NULL;
+		CONS_Alert(CONS_WARNING, "P_LoadReject: REJECT lump is too small for %s sectors, will not be loaded\n", sizeu1(numsectors));
+	}
 	else
 	{
-		rejectmatrix = Z_Malloc(count, PU_LEVEL, NULL); // allocate memory for the reject matrix
+		rejectmatrix = Z_ArenaAlloc(&levelarena, count); // allocate memory for the reject matrix
 		M_Memcpy(rejectmatrix, data, count); // copy the data into it
 	}
 }
@@ -2825,7 +3188,7 @@ static void P_LoadMapLUT(const virtres_t *virt)
 	else
 		rejectmatrix = NULL;
 
-	if (!(virtblockmap && P_LoadBlockMap(virtblockmap->data, virtblockmap->size)))
+	if (!(virtblockmap && P_LoadBlockMap(virtblockmap->data, virtblockmap->size)) && !P_LoadCachedBlockMap())
 		P_CreateBlockMap();
 }
 
@@ -2886,7 +3249,7 @@ static void P_LinkMapData(void)
 		}
 		else
 		{
-			sector->lines = Z_Calloc(sector->linecount * sizeof(line_t*), PU_LEVEL, NULL);
+			sector->lines = Z_ArenaCalloc(&levelarena, sector->linecount * sizeof(line_t*));
 
 			// zero the count, since we'll later use this to track how many we've recorded
 			sector->linecount = 0;
@@ -3246,12 +3609,21 @@ static boolean P_LoadMapFromFile(void)
 	virtlump_t *textmap = vres_Find(virt, "TEXTMAP");
 	udmf = textmap != NULL;
 
+	// The compiled map cache goes by the map's MD5, so make it first.
+	P_MakeMapMD5(virt, &mapmd5);
+	if (udmf)
+		P_OpenMapCache();
+
 	if (!P_LoadMapData(virt))
+	{
+		P_CloseMapCache(false);
 		return false;
+	}
 	P_LoadMapBSP(virt);
 	P_LoadMapLUT(virt);
 
 	P_LinkMapData();
+	P_InitSectorNeighbors();
 
 	P_InitTagLists();   // Create xref tables for tags
 
@@ -3259,15 +3631,15 @@ static boolean P_LoadMapFromFile(void)
 		P_ConvertBinaryMap();
 
 	// Copy relevant map data for NetArchive purposes.
-	spawnsectors = Z_Calloc(numsectors * sizeof(*sectors), PU_LEVEL, NULL);
-	spawnlines = Z_Calloc(numlines * sizeof(*lines), PU_LEVEL, NULL);
-	spawnsides = Z_Calloc(numsides * sizeof(*sides), PU_LEVEL, NULL);
+	spawnsectors = Z_ArenaCalloc(&levelarena, numsectors * sizeof(*sectors));
+	spawnlines = Z_ArenaCalloc(&levelarena, numlines * sizeof(*lines));
+	spawnsides = Z_ArenaCalloc(&levelarena, numsides * sizeof(*sides));
 
 	memcpy(spawnsectors, sectors, numsectors * sizeof(*sectors));
 	memcpy(spawnlines, lines, numlines * sizeof(*lines));
 	memcpy(spawnsides, sides, numsides * sizeof(*sides));
 
-	P_MakeMapMD5(virt, &mapmd5);
+	P_CloseMapCache(udmf);
 
 	vres_Free(virt);
 	return true;
@@ -3958,9 +4330,6 @@ boolean P_LoadLevel(boolean fromnetsave)
 	if (rendermode != render_none)
 		V_SetPaletteLump("PLAYPAL");
 
-	// Initialize sector node list.
-	P_Initsecnode();
-
 	if (netgame || multiplayer)
 		cv_debug = botskin = 0;
 
@@ -4015,7 +4384,7 @@ boolean P_LoadLevel(boolean fromnetsave)
 	// This is handled BEFORE sounds are stopped.
 	if (modeattacking && !demoplayback && (pausedelay == INT32_MIN))
 		ranspecialwipe = 2;
-	else if (rendermode != render_none && G_IsSpecialStage(gamemap))
+	else if (rendermode != render_none && !noblit && G_IsSpecialStage(gamemap))
 	{
 		P_RunSpecialStageWipe();
 		ranspecialwipe = 1;
@@ -4042,7 +4411,7 @@ boolean P_LoadLevel(boolean fromnetsave)
 
 	// Let's fade to black here
 	// But only if we didn't do the special stage wipe
-	if (rendermode != render_none && !ranspecialwipe)
+	if (rendermode != render_none && !noblit && !ranspecialwipe)
 		P_RunLevelWipe();
 
 	if (!titlemapinaction)
@@ -4090,6 +4459,7 @@ boolean P_LoadLevel(boolean fromnetsave)
 	R_FlushTranslationColormapCache();
 
 	Z_FreeTags(PU_LEVEL, PU_PURGELEVEL - 1);
+	numprecipmobjs = 0; // precipmobjs went with the purge
 
 #if defined (WALLSPLATS) || defined (FLOORSPLATS)
 	// clear the splats from previous level
@@ -4098,6 +4468,7 @@ boolean P_LoadLevel(boolean fromnetsave)
 
 	P_InitThinkers();
 	P_InitCachedActions();
+	P_ClearSightCache();
 
 	if (!fromnetsave && savedata.lives > 0)
 	{
@@ -4132,6 +4503,10 @@ boolean P_LoadLevel(boolean fromnetsave)
 	if (!P_LoadMapFromFile())
 		return false;
 
+	// Let the flats and textures decompress while the level is set up
+	if (precache)
+		R_PrefetchLevel();
+
 	// init anything that P_SpawnSlopes/P_LoadThings needs to know
 	P_InitSpecials();
 
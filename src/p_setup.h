@@ -31,6 +31,9 @@ extern UINT8 levelfadecol;
 
 extern lumpnum_t lastloadedmaplumpnum; // for comparative savegame
 
+// static level geometry, freed all at once with the level
+extern zarena_t levelarena;
+
 /* for levelflat type */
 enum
 {
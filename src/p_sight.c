@@ -13,6 +13,7 @@
 
 #include "doomdef.h"
 #include "doomstat.h"
+#include "command.h"
 #include "p_local.h"
 #include "p_slopes.h"
 #include "r_main.h"
@@ -31,7 +32,83 @@ typedef struct {
 	fixed_t bbox[4];
 } los_t;
 
-static INT32 sightcounts[2];
+// What happened to the P_CheckSight calls, for sightstats
+static struct
+{
+	UINT32 queries;
+	UINT32 rejected; // by the REJECT lump
+	UINT32 samesubsector;
+	UINT32 cached;
+	UINT32 traced;
+} sightcounts;
+
+//
+// Sight cache
+//
+// Enemies and scripts tend to ask the same question more than once a tic.
+// Answers are kept until the tic ends or the level changes shape, which is
+// whenever P_ClearSightCache is called. They are keyed on the positions
+// and heights the answer depends on, so it doesn't matter which mobjs
+// asked.
+//
+
+#define SIGHTCACHESIZE 512 // power of 2
+
+typedef struct
+{
+	fixed_t x1, y1, z1, height1;
+	fixed_t x2, y2, z2, height2;
+	UINT32 epoch; // valid if sightepoch
+	boolean result;
+} sightcache_t;
+
+static sightcache_t sightcache[SIGHTCACHESIZE];
+static UINT32 sightepoch = 1;
+
+/** Forgets every cached P_CheckSight answer. Call this at the start of a
+  * tic and whenever something changes what can be seen through:
+  * sector heights, slopes, polyobjects or FOF flags.
+  */
+void P_ClearSightCache(void)
+{
+	if (++sightepoch == 0) // wrapped around, entries from way back would look valid
+	{
+		memset(sightcache, 0, sizeof (sightcache));
+		sightepoch = 1;
+	}
+}
+
+static sightcache_t *P_SightCacheSlot(mobj_t *t1, mobj_t *t2)
+{
+	UINT32 hash = (UINT32)t1->x ^ ((UINT32)t1->y * 31) ^ ((UINT32)t1->z * 131)
+		^ ((UINT32)t2->x * 1031) ^ ((UINT32)t2->y * 10007) ^ ((UINT32)t2->z * 100003)
+		^ (UINT32)t1->height ^ ((UINT32)t2->height << 7);
+
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
+	return &sightcache[hash & (SIGHTCACHESIZE-1)];
+}
+
+/** Prints how P_CheckSight calls were answered since the last reset.
+  */
+void Command_Sightstats_f(void)
+{
+	if (COM_Argc() > 1 && !strcasecmp(COM_Argv(1), "reset"))
+	{
+		memset(&sightcounts, 0, sizeof (sightcounts));
+		return;
+	}
+
+	CONS_Printf(M_GetText("Sight checks: %u\n"), sightcounts.queries);
+	if (!sightcounts.queries)
+		return;
+
+	CONS_Printf(M_GetText(" * rejected by REJECT: %u%s\n"), sightcounts.rejected, rejectmatrix ? "" : M_GetText(" (level has none)"));
+	CONS_Printf(M_GetText(" * same subsector: %u\n"), sightcounts.samesubsector);
+	CONS_Printf(M_GetText(" * cached: %u (%u%% of the rest)\n"), sightcounts.cached,
+		(sightcounts.cached + sightcounts.traced) ? (UINT32)(100 * (UINT64)sightcounts.cached / (sightcounts.cached + sightcounts.traced)) : 0);
+	CONS_Printf(M_GetText(" * traced: %u\n"), sightcounts.traced);
+}
 
 //
 // P_DivlineSide
@@ -372,50 +449,15 @@ static boolean P_CrossBSPNode(INT32 bspnum, register los_t *los)
 }
 
 //
-// P_CheckSight
+// P_TraceSight
 //
-// Returns true if a straight line between t1 and t2 is unobstructed.
-// Uses REJECT.
+// The expensive part of P_CheckSight: traces the line from the eyes of t1
+// to any part of t2 through 3D floors and the BSP.
 //
-boolean P_CheckSight(mobj_t *t1, mobj_t *t2)
+static boolean P_TraceSight(mobj_t *t1, mobj_t *t2, const sector_t *s1, const sector_t *s2)
 {
-	const sector_t *s1, *s2;
-	size_t pnum;
 	los_t los;
 
-	// First check for trivial rejection.
-	if (!t1 || !t2)
-		return false;
-
-	I_Assert(!P_MobjWasRemoved(t1));
-	I_Assert(!P_MobjWasRemoved(t2));
-
-	if (!t1->subsector || !t2->subsector
-	|| !t1->subsector->sector || !t2->subsector->sector)
-		return false;
-
-	s1 = t1->subsector->sector;
-	s2 = t2->subsector->sector;
-	pnum = (s1-sectors)*numsectors + (s2-sectors);
-
-	if (rejectmatrix != NULL)
-	{
-		// Check in REJECT table.
-		if (rejectmatrix[pnum>>3] & (1 << (pnum&7))) // can't possibly be connected
-			return false;
-	}
-
-	// killough 11/98: shortcut for melee situations
-	// same subsector? obviously visible
-	// haleyjd 02/23/06: can't do this if there are polyobjects in the subsec
-	if (!t1->subsector->polyList &&
-		t1->subsector == t2->subsector)
-		return true;
-
-	// An unobstructed LOS is possible.
-	// Now look from eyes of t1 to any part of t2.
-	sightcounts[1]++;
-
 	validcount++;
 
 	los.topslope =
@@ -496,3 +538,77 @@ boolean P_CheckSight(mobj_t *t1, mobj_t *t2)
 	// the head node is the last node output
 	return P_CrossBSPNode((INT32)numnodes - 1, &los);
 }
+
+//
+// P_CheckSight
+//
+// Returns true if a straight line between t1 and t2 is unobstructed.
+// Uses REJECT.
+//
+boolean P_CheckSight(mobj_t *t1, mobj_t *t2)
+{
+	const sector_t *s1, *s2;
+	size_t pnum;
+	sightcache_t *cached;
+
+	// First check for trivial rejection.
+	if (!t1 || !t2)
+		return false;
+
+	I_Assert(!P_MobjWasRemoved(t1));
+	I_Assert(!P_MobjWasRemoved(t2));
+
+	if (!t1->subsector || !t2->subsector
+	|| !t1->subsector->sector || !t2->subsector->sector)
+		return false;
+
+	sightcounts.queries++;
+
+	s1 = t1->subsector->sector;
+	s2 = t2->subsector->sector;
+	pnum = (s1-sectors)*numsectors + (s2-sectors);
+
+	if (rejectmatrix != NULL)
+	{
+		// Check in REJECT table.
+		if (rejectmatrix[pnum>>3] & (1 << (pnum&7))) // can't possibly be connected
+		{
+			sightcounts.rejected++;
+			return false;
+		}
+	}
+
+	// killough 11/98: shortcut for melee situations
+	// same subsector? obviously visible
+	// haleyjd 02/23/06: can't do this if there are polyobjects in the subsec
+	if (!t1->subsector->polyList &&
+		t1->subsector == t2->subsector)
+	{
+		sightcounts.samesubsector++;
+		return true;
+	}
+
+	// An unobstructed LOS is possible.
+	// Now look from eyes of t1 to any part of t2.
+	cached = P_SightCacheSlot(t1, t2);
+	if (cached->epoch == sightepoch
+	&& cached->x1 == t1->x && cached->y1 == t1->y && cached->z1 == t1->z && cached->height1 == t1->height
+	&& cached->x2 == t2->x && cached->y2 == t2->y && cached->z2 == t2->z && cached->height2 == t2->height)
+	{
+		sightcounts.cached++;
+		return cached->result;
+	}
+
+	sightcounts.traced++;
+
+	cached->x1 = t1->x;
+	cached->y1 = t1->y;
+	cached->z1 = t1->z;
+	cached->height1 = t1->height;
+	cached->x2 = t2->x;
+	cached->y2 = t2->y;
+	cached->z2 = t2->z;
+	cached->height2 = t2->height;
+	cached->epoch = sightepoch;
+	return (cached->result = P_TraceSight(t1, t2, s1, s2));
+}
@@ -96,7 +96,7 @@ void T_DynamicSlopeLine (dynplanethink_t* th)
 	pslope_t* slope = th->slope;
 	line_t* srcline = th->sourceline;
 
-	fixed_t zdelta;
+	fixed_t zdelta, oldz = slope->o.z;
 
 	switch(th->type) {
 	case DP_FRONTFLOOR:
@@ -127,7 +127,10 @@ void T_DynamicSlopeLine (dynplanethink_t* th)
 		slope->zdelta = FixedDiv(zdelta, th->extent);
 		slope->zangle = R_PointToAngle2(0, 0, th->extent, -zdelta);
 		P_CalculateSlopeNormal(slope);
+		P_ClearSightCache();
 	}
+	else if (slope->o.z != oldz)
+		P_ClearSightCache();
 }
 
 /// Mapthing-defined
@@ -137,8 +140,10 @@ void T_DynamicSlopeVert (dynplanethink_t* th)
 
 	size_t i;
 	INT32 l;
+	fixed_t oldz[3];
 
 	for (i = 0; i < 3; i++) {
+		oldz[i] = th->vex[i].z;
 		l = P_FindSpecialLineFromTag(799, th->tags[i], -1);
 		if (l != -1) {
 			th->vex[i].z = lines[l].frontsector->floorheight;
@@ -148,6 +153,9 @@ void T_DynamicSlopeVert (dynplanethink_t* th)
 	}
 
 	ReconfigureViaVertexes(slope, th->vex[0], th->vex[1], th->vex[2]);
+
+	if (th->vex[0].z != oldz[0] || th->vex[1].z != oldz[1] || th->vex[2].z != oldz[2])
+		P_ClearSightCache();
 }
 
 static inline void P_AddDynSlopeThinker (pslope_t* slope, dynplanetype_t type, line_t* sourceline, fixed_t extent, const INT16 tags[3], const vector3_t vx[3])
@@ -583,34 +583,120 @@ static sector_t *getNextSector(line_t *line, sector_t *sec)
 	return line->frontsector;
 }
 
-/** Finds lowest floor in adjacent sectors.
+/** Lists the distinct sectors next to each sector, so that the functions
+  * below don't have to cross every line of a big sector to find them.
+  * Called once the sectors' line lists are built.
   *
-  * \param sec Sector to start in.
-  * \return Lowest floor height in an adjacent sector.
-  * \sa P_FindHighestFloorSurrounding, P_FindNextLowestFloor,
-  *     P_FindLowestCeilingSurrounding
+  * \sa getNextSector, P_SectorHeightsChanged
   */
-fixed_t P_FindLowestFloorSurrounding(sector_t *sec)
+void P_InitSectorNeighbors(void)
+{
+	size_t i, j, total = 0;
+	sector_t *sec, *other;
+	sector_t **list;
+
+	// Count them first, so every list can share one allocation
+	for (i = 0, sec = sectors; i < numsectors; i++, sec++)
+	{
+		validcount++;
+		sec->neighborcount = 0;
+
+		for (j = 0; j < sec->linecount; j++)
+		{
+			other = getNextSector(sec->lines[j], sec);
+
+			if (!other || other->validcount == validcount)
+				continue;
+
+			other->validcount = validcount;
+			sec->neighborcount++;
+		}
+
+		total += sec->neighborcount;
+	}
+
+	list = total ? Z_ArenaAlloc(&levelarena, total * sizeof (*list)) : NULL;
+
+	for (i = 0, sec = sectors; i < numsectors; i++, sec++)
+	{
+		validcount++;
+		sec->neighbors = sec->neighborcount ? list : NULL;
+		list += sec->neighborcount;
+		sec->neighborcount = 0;
+		sec->surroundingvalid = false;
+
+		for (j = 0; j < sec->linecount; j++)
+		{
+			other = getNextSector(sec->lines[j], sec);
+
+			if (!other || other->validcount == validcount)
+				continue;
+
+			other->validcount = validcount;
+			sec->neighbors[sec->neighborcount++] = other;
+		}
+	}
+}
+
+/** Lets go of what was cached about a sector's floor and ceiling heights.
+  * Call after moving either of them; P_CheckSector does this for you.
+  *
+  * \param sec The sector that moved.
+  */
+void P_SectorHeightsChanged(sector_t *sec)
+{
+	size_t i;
+
+	for (i = 0; i < sec->neighborcount; i++)
+		sec->neighbors[i]->surroundingvalid = false;
+
+	P_ClearSightCache();
+}
+
+// Finds the plane extremes among a sector's neighbors, if it has any
+static void P_UpdateSurroundingHeights(sector_t *sec)
 {
 	size_t i;
-	line_t *check;
 	sector_t *other;
-	fixed_t floorh;
 
-	floorh = sec->floorheight;
+	if (sec->surroundingvalid || !sec->neighborcount)
+		return;
 
-	for (i = 0; i < sec->linecount; i++)
-	{
-		check = sec->lines[i];
-		other = getNextSector(check,sec);
+	other = sec->neighbors[0];
+	sec->surroundinglowfloor = sec->surroundinghighfloor = other->floorheight;
+	sec->surroundinglowceiling = sec->surroundinghighceiling = other->ceilingheight;
 
-		if (!other)
-			continue;
+	for (i = 1; i < sec->neighborcount; i++)
+	{
+		other = sec->neighbors[i];
 
-		if (other->floorheight < floorh)
-			floorh = other->floorheight;
+		if (other->floorheight < sec->surroundinglowfloor)
+			sec->surroundinglowfloor = other->floorheight;
+		if (other->floorheight > sec->surroundinghighfloor)
+			sec->surroundinghighfloor = other->floorheight;
+		if (other->ceilingheight < sec->surroundinglowceiling)
+			sec->surroundinglowceiling = other->ceilingheight;
+		if (other->ceilingheight > sec->surroundinghighceiling)
+			sec->surroundinghighceiling = other->ceilingheight;
 	}
-	return floorh;
+
+	sec->surroundingvalid = true;
+}
+
+/** Finds lowest floor in adjacent sectors.
+  *
+  * \param sec Sector to start in.
+  * \return Lowest floor height in an adjacent sector.
+  * \sa P_FindHighestFloorSurrounding, P_FindNextLowestFloor,
+  *     P_FindLowestCeilingSurrounding
+  */
+fixed_t P_FindLowestFloorSurrounding(sector_t *sec)
+{
+	if (!sec->neighborcount)
+		return sec->floorheight;
+
+	P_UpdateSurroundingHeights(sec);
+	return min(sec->floorheight, sec->surroundinglowfloor);
 }
 
 /** Finds highest floor in adjacent sectors.
@@ -622,27 +708,11 @@ fixed_t P_FindLowestFloorSurrounding(sector_t *sec)
   */
 fixed_t P_FindHighestFloorSurrounding(sector_t *sec)
 {
-	size_t i;
-	line_t *check;
-	sector_t *other;
-	fixed_t floorh = -500*FRACUNIT;
-	INT32 foundsector = 0;
-
-	for (i = 0; i < sec->linecount; i++)
-	{
-		check = sec->lines[i];
-		other = getNextSector(check, sec);
-
-		if (!other)
-			continue;
-
-		if (other->floorheight > floorh || !foundsector)
-			floorh = other->floorheight;
+	if (!sec->neighborcount)
+		return -500*FRACUNIT;
 
-		if (!foundsector)
-			foundsector = 1;
-	}
-	return floorh;
+	P_UpdateSurroundingHeights(sec);
+	return sec->surroundinghighfloor;
 }
 
 /** Finds next highest floor in adjacent sectors.
@@ -661,17 +731,16 @@ fixed_t P_FindNextHighestFloor(sector_t *sec, fixed_t currentheight)
 	size_t i;
 	fixed_t height;
 
-	for (i = 0; i < sec->linecount; i++)
+	for (i = 0; i < sec->neighborcount; i++)
 	{
-		other = getNextSector(sec->lines[i],sec);
-		if (other && other->floorheight > currentheight)
+		other = sec->neighbors[i];
+		if (other->floorheight > currentheight)
 		{
 			height = other->floorheight;
-			while (++i < sec->linecount)
+			while (++i < sec->neighborcount)
 			{
-				other = getNextSector(sec->lines[i], sec);
-				if (other &&
-					other->floorheight < height &&
+				other = sec->neighbors[i];
+				if (other->floorheight < height &&
 					other->floorheight > currentheight)
 					height = other->floorheight;
 			}
@@ -701,16 +770,16 @@ fixed_t P_FindNextLowestFloor(sector_t *sec, fixed_t currentheight)
 	size_t i;
 	fixed_t height;
 
-	for (i = 0; i < sec->linecount; i++)
+	for (i = 0; i < sec->neighborcount; i++)
 	{
-		other = getNextSector(sec->lines[i], sec);
-		if (other && other->floorheight < currentheight)
+		other = sec->neighbors[i];
+		if (other->floorheight < currentheight)
 		{
 			height = other->floorheight;
-			while (++i < sec->linecount)
+			while (++i < sec->neighborcount)
 			{
-				other = getNextSector(sec->lines[i], sec);
-				if (other &&	other->floorheight > height
+				other = sec->neighbors[i];
+				if (other->floorheight > height
 					&& other->floorheight < currentheight)
 					height = other->floorheight;
 			}
@@ -737,16 +806,16 @@ static fixed_t P_FindNextLowestCeiling(sector_t *sec, fixed_t currentheight)
 	size_t i;
 	fixed_t height;
 
-	for (i = 0; i < sec->linecount; i++)
+	for (i = 0; i < sec->neighborcount; i++)
 	{
-		other = getNextSector(sec->lines[i],sec);
-		if (other &&	other->ceilingheight < currentheight)
+		other = sec->neighbors[i];
+		if (other->ceilingheight < currentheight)
 		{
 			height = other->ceilingheight;
-			while (++i < sec->linecount)
+			while (++i < sec->neighborcount)
 			{
-				other = getNextSector(sec->lines[i],sec);
-				if (other &&	other->ceilingheight > height
+				other = sec->neighbors[i];
+				if (other->ceilingheight > height
 					&& other->ceilingheight < currentheight)
 					height = other->ceilingheight;
 			}
@@ -772,16 +841,16 @@ static fixed_t P_FindNextHighestCeiling(sector_t *sec, fixed_t currentheight)
 	size_t i;
 	fixed_t height;
 
-	for (i = 0; i < sec->linecount; i++)
+	for (i = 0; i < sec->neighborcount; i++)
 	{
-		other = getNextSector(sec->lines[i], sec);
-		if (other && other->ceilingheight > currentheight)
+		other = sec->neighbors[i];
+		if (other->ceilingheight > currentheight)
 		{
 			height = other->ceilingheight;
-			while (++i < sec->linecount)
+			while (++i < sec->neighborcount)
 			{
-				other = getNextSector(sec->lines[i],sec);
-				if (other && other->ceilingheight < height
+				other = sec->neighbors[i];
+				if (other->ceilingheight < height
 					&& other->ceilingheight > currentheight)
 					height = other->ceilingheight;
 			}
@@ -805,27 +874,11 @@ static fixed_t P_FindNextHighestCeiling(sector_t *sec, fixed_t currentheight)
   */
 fixed_t P_FindLowestCeilingSurrounding(sector_t *sec)
 {
-	size_t i;
-	line_t *check;
-	sector_t *other;
-	fixed_t height = 32000*FRACUNIT; //SoM: 3/7/2000: Remove ovf
-	INT32 foundsector = 0;
+	if (!sec->neighborcount)
+		return 32000*FRACUNIT; //SoM: 3/7/2000: Remove ovf
 
-	for (i = 0; i < sec->linecount; i++)
-	{
-		check = sec->lines[i];
-		other = getNextSector(check, sec);
-
-		if (!other)
-			continue;
-
-		if (other->ceilingheight < height || !foundsector)
-			height = other->ceilingheight;
-
-		if (!foundsector)
-			foundsector = 1;
-	}
-	return height;
+	P_UpdateSurroundingHeights(sec);
+	return sec->surroundinglowceiling;
 }
 
 /** Finds Highest ceiling in adjacent sectors.
@@ -837,27 +890,11 @@ fixed_t P_FindLowestCeilingSurrounding(sector_t *sec)
   */
 fixed_t P_FindHighestCeilingSurrounding(sector_t *sec)
 {
-	size_t i;
-	line_t *check;
-	sector_t *other;
-	fixed_t height = 0;
-	INT32 foundsector = 0;
-
-	for (i = 0; i < sec->linecount; i++)
-	{
-		check = sec->lines[i];
-		other = getNextSector(check, sec);
-
-		if (!other)
-			continue;
-
-		if (other->ceilingheight > height || !foundsector)
-			height = other->ceilingheight;
+	if (!sec->neighborcount)
+		return 0;
 
-		if (!foundsector)
-			foundsector = 1;
-	}
-	return height;
+	P_UpdateSurroundingHeights(sec);
+	return sec->surroundinghighceiling;
 }
 
 #if 0
@@ -1508,20 +1545,10 @@ INT32 P_FindMinSurroundingLight(sector_t *sector, INT32 max)
 {
 	size_t i;
 	INT32 min = max;
-	line_t *line;
-	sector_t *check;
-
-	for (i = 0; i < sector->linecount; i++)
-	{
-		line = sector->lines[i];
-		check = getNextSector(line,sector);
 
-		if (!check)
-			continue;
-
-		if (check->lightlevel < min)
-			min = check->lightlevel;
-	}
+	for (i = 0; i < sector->neighborcount; i++)
+		if (sector->neighbors[i]->lightlevel < min)
+			min = sector->neighbors[i]->lightlevel;
 	return min;
 }
 
@@ -2184,31 +2211,18 @@ void P_SwitchWeather(INT32 weathernum)
 	}
 
 	if (purge)
-	{
-		thinker_t *think;
-		precipmobj_t *precipmobj;
-
-		for (think = thlist[THINK_PRECIP].next; think != &thlist[THINK_PRECIP]; think = think->next)
-		{
-			if (think->function.acp1 != (actionf_p1)P_NullPrecipThinker)
-				continue; // not a precipmobj thinker
-
-			precipmobj = (precipmobj_t *)think;
-
-			P_RemovePrecipMobj(precipmobj);
-		}
-	}
+		P_RemovePrecipitation();
 	else if (swap && !((swap == PRECIP_BLANK && curWeather == PRECIP_STORM_NORAIN) || (swap == PRECIP_STORM_NORAIN && curWeather == PRECIP_BLANK))) // Rather than respawn all that crap, reuse it!
 	{
-		thinker_t *think;
 		precipmobj_t *precipmobj;
 		state_t *st;
+		size_t i;
 
-		for (think = thlist[THINK_PRECIP].next; think != &thlist[THINK_PRECIP]; think = think->next)
+		for (i = 0; precipmobjs && i < numprecipmobjs; i++)
 		{
-			if (think->function.acp1 != (actionf_p1)P_NullPrecipThinker)
-				continue; // not a precipmobj thinker
-			precipmobj = (precipmobj_t *)think;
+			precipmobj = &precipmobjs[i];
+			if (!precipmobj->subsector)
+				continue; // removed
 
 			if (swap == PRECIP_RAIN) // Snow To Rain
 			{
@@ -2223,7 +2237,6 @@ void P_SwitchWeather(INT32 weathernum)
 				precipmobj->precipflags &= ~PCF_INVISIBLE;
 
 				precipmobj->precipflags |= PCF_RAIN;
-				//think->function.acp1 = (actionf_p1)P_RainThinker;
 			}
 			else if (swap == PRECIP_SNOW) // Rain To Snow
 			{
@@ -2247,15 +2260,9 @@ void P_SwitchWeather(INT32 weathernum)
 				precipmobj->momz = mobjinfo[MT_SNOWFLAKE].speed;
 
 				precipmobj->precipflags &= ~(PCF_INVISIBLE|PCF_RAIN);
-
-				//think->function.acp1 = (actionf_p1)P_SnowThinker;
 			}
 			else if (swap == PRECIP_BLANK || swap == PRECIP_STORM_NORAIN) // Remove precip, but keep it around for reuse.
-			{
-				//think->function.acp1 = (actionf_p1)P_NullPrecipThinker;
-
 				precipmobj->precipflags |= PCF_INVISIBLE;
-			}
 		}
 	}
 
@@ -2375,6 +2382,17 @@ static void P_ProcessLineSpecial(line_t *line, mobj_t *mo, sector_t *callsec)
 	if (mo && mo->player && botingame)
 		bot = players[secondarydisplayplayer].mo;
 
+	// Whatever this does to the tagged sectors, what's in them should see it
+	if (line->tag && mapheaderinfo[gamemap-1]->dormantradius)
+	{
+		while ((secnum = P_FindSectorFromTag(line->tag, secnum)) >= 0)
+			P_WakeSectorMobjs(&sectors[secnum]);
+		secnum = -1;
+	}
+
+	// Executors move and hide sectors, FOFs and polyobjects
+	P_ClearSightCache();
+
 	// note: only commands with linedef types >= 400 && < 500 can be used
 	switch (line->special)
 	{
@@ -5657,6 +5675,7 @@ static ffloor_t *P_AddFakeFloor(sector_t *sec, sector_t *sec2, line_t *master, f
 		CONS_Alert(CONS_ERROR, M_GetText("A FOF tagged %d has a top height below its bottom.\n"), master->tag);
 		sec2->ceilingheight = sec2->floorheight;
 		sec2->floorheight = tempceiling;
+		P_SectorHeightsChanged(sec2);
 	}
 
 	if (sec2->numattached == 0)
@@ -7757,6 +7776,7 @@ void T_Disappear(disappear_t *d)
 			sectors[s].moved = true;
 			P_RecalcPrecipInSector(&sectors[s]);
 		}
+		P_ClearSightCache();
 
 		if (d->exists)
 		{
@@ -8057,6 +8077,9 @@ static boolean P_FadeFakeFloor(ffloor_t *rover, INT16 sourcevalue, INT16 destval
 		}
 	}
 
+	// FF_EXISTS and FF_TRANSLUCENT decide what blocks sight
+	P_ClearSightCache();
+
 	if (fadingdata)
 		fadingdata->alpha = alpha;
 
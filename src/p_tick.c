@@ -18,9 +18,16 @@
 #include "s_sound.h"
 #include "st_stuff.h"
 #include "p_polyobj.h"
+#include "r_fps.h"
 #include "m_random.h"
 #include "lua_script.h"
 #include "lua_hook.h"
+#include "m_trace.h"
+#include "m_misc.h" // FIL_DefaultExtension
+#include "i_system.h" // I_GetPreciseTime
+#include "d_main.h" // srb2home
+#include "dehacked.h" // DEH_GetMobjTypeName
+#include "p_slopes.h" // T_DynamicSlope*
 
 // Object place
 #include "m_cheat.h"
@@ -41,7 +48,7 @@ thinker_t thlist[NUM_THINKERLISTS];
 void Command_Numthinkers_f(void)
 {
 	INT32 num;
-	INT32 count = 0;
+	INT32 count = 0, dormant = 0;
 	actionf_p1 action;
 	thinker_t *think;
 	thinklistnum_t start = 0;
@@ -61,7 +68,7 @@ void Command_Numthinkers_f(void)
 			"\t1: P_MobjThinker\n"
 			/*"\t2: P_RainThinker\n"
 			"\t3: P_SnowThinker\n"*/
-			"\t2: P_NullPrecipThinker\n"
+			"\t2: Precipitation\n"
 			"\t3: T_Friction\n"
 			"\t4: T_Pusher\n"
 			"\t5: P_RemoveThinkerDelayed\n");
@@ -85,11 +92,10 @@ void Command_Numthinkers_f(void)
 			action = (actionf_p1)P_SnowThinker;
 			CONS_Printf(M_GetText("Number of %s: "), "P_SnowThinker");
 			break;*/
-		case 2:
-			start = end = THINK_PRECIP;
-			action = (actionf_p1)P_NullPrecipThinker;
-			CONS_Printf(M_GetText("Number of %s: "), "P_NullPrecipThinker");
-			break;
+		case 2: // not thinkers anymore, see P_PrecipThink
+			CONS_Printf(M_GetText("Number of %s: "), "precipitation");
+			CONS_Printf("%s\n", sizeu1(numprecipmobjs));
+			return;
 		case 3:
 			start = end = THINK_MAIN;
 			action = (actionf_p1)T_Friction;
@@ -117,10 +123,15 @@ void Command_Numthinkers_f(void)
 				continue;
 
 			count++;
+			if (i == THINK_MOBJ && (((mobj_t *)think)->eflags & MFE_DORMANT))
+				dormant++;
 		}
 	}
 
-	CONS_Printf("%d\n", count);
+	if (dormant)
+		CONS_Printf(M_GetText("%d (%d active, %d dormant)\n"), count, count - dormant, dormant);
+	else
+		CONS_Printf("%d\n", count);
 }
 
 void Command_CountMobjs_f(void)
@@ -183,6 +194,251 @@ void Command_CountMobjs_f(void)
 	}
 }
 
+//
+// Thinker profiling
+//
+// While it is on, P_RunThinkers times every thinker it runs, adding the
+// time up by thinker function and, for mobjs, by mobj type. The time
+// spent in a type's MobjThinker hooks is also kept apart, though it is
+// included in the type's total.
+//
+
+boolean thinkerprofiling = false;
+
+#define MAXPROFILEDFUNCS 128
+
+typedef struct
+{
+	actionf_p1 func;
+	UINT64 time; // in I_GetPreciseTime ticks
+	UINT32 calls;
+} funcprofile_t;
+
+typedef struct
+{
+	UINT64 time, luatime;
+	UINT32 calls;
+} mobjprofile_t;
+
+static funcprofile_t funcprofiles[MAXPROFILEDFUNCS];
+static size_t numfuncprofiles;
+static funcprofile_t *lastfuncprofile; // thinkers of a kind tend to come one after the other
+static mobjprofile_t mobjprofiles[NUMMOBJTYPES];
+static UINT32 profiledtics;
+
+// Names for the thinker functions the game itself has
+static const struct
+{
+	actionf_p1 func;
+	const char *name;
+} thinkernames[] = {
+	{(actionf_p1)P_MobjThinker, "P_MobjThinker"},
+	{(actionf_p1)P_RemoveThinkerDelayed, "P_RemoveThinkerDelayed"},
+	{(actionf_p1)T_MoveCeiling, "T_MoveCeiling"},
+	{(actionf_p1)T_CrushCeiling, "T_CrushCeiling"},
+	{(actionf_p1)T_MoveFloor, "T_MoveFloor"},
+	{(actionf_p1)T_LightningFlash, "T_LightningFlash"},
+	{(actionf_p1)T_StrobeFlash, "T_StrobeFlash"},
+	{(actionf_p1)T_Glow, "T_Glow"},
+	{(actionf_p1)T_FireFlicker, "T_FireFlicker"},
+	{(actionf_p1)T_MoveElevator, "T_MoveElevator"},
+	{(actionf_p1)T_ContinuousFalling, "T_ContinuousFalling"},
+	{(actionf_p1)T_ThwompSector, "T_ThwompSector"},
+	{(actionf_p1)T_NoEnemiesSector, "T_NoEnemiesSector"},
+	{(actionf_p1)T_EachTimeThinker, "T_EachTimeThinker"},
+	{(actionf_p1)T_RaiseSector, "T_RaiseSector"},
+	{(actionf_p1)T_CameraScanner, "T_CameraScanner"},
+	{(actionf_p1)T_Scroll, "T_Scroll"},
+	{(actionf_p1)T_Friction, "T_Friction"},
+	{(actionf_p1)T_Pusher, "T_Pusher"},
+	{(actionf_p1)T_BounceCheese, "T_BounceCheese"},
+	{(actionf_p1)T_StartCrumble, "T_StartCrumble"},
+	{(actionf_p1)T_MarioBlock, "T_MarioBlock"},
+	{(actionf_p1)T_MarioBlockChecker, "T_MarioBlockChecker"},
+	{(actionf_p1)T_FloatSector, "T_FloatSector"},
+	{(actionf_p1)T_LaserFlash, "T_LaserFlash"},
+	{(actionf_p1)T_LightFade, "T_LightFade"},
+	{(actionf_p1)T_ExecutorDelay, "T_ExecutorDelay"},
+	{(actionf_p1)T_Disappear, "T_Disappear"},
+	{(actionf_p1)T_Fade, "T_Fade"},
+	{(actionf_p1)T_FadeColormap, "T_FadeColormap"},
+	{(actionf_p1)T_PlaneDisplace, "T_PlaneDisplace"},
+	{(actionf_p1)T_PolyObjRotate, "T_PolyObjRotate"},
+	{(actionf_p1)T_PolyObjMove, "T_PolyObjMove"},
+	{(actionf_p1)T_PolyObjWaypoint, "T_PolyObjWaypoint"},
+	{(actionf_p1)T_PolyDoorSlide, "T_PolyDoorSlide"},
+	{(actionf_p1)T_PolyDoorSwing, "T_PolyDoorSwing"},
+	{(actionf_p1)T_PolyObjFlag, "T_PolyObjFlag"},
+	{(actionf_p1)T_PolyObjDisplace, "T_PolyObjDisplace"},
+	{(actionf_p1)T_PolyObjRotDisplace, "T_PolyObjRotDisplace"},
+	{(actionf_p1)T_PolyObjFade, "T_PolyObjFade"},
+	{(actionf_p1)T_DynamicSlopeLine, "T_DynamicSlopeLine"},
+	{(actionf_p1)T_DynamicSlopeVert, "T_DynamicSlopeVert"},
+	{NULL, NULL}
+};
+
+static const char *P_ThinkerFuncName(actionf_p1 func)
+{
+	size_t i;
+	for (i = 0; thinkernames[i].func; i++)
+		if (thinkernames[i].func == func)
+			return thinkernames[i].name;
+	return va("%p", (void *)(size_t)func);
+}
+
+static funcprofile_t *P_GetFuncProfile(actionf_p1 func)
+{
+	size_t i;
+
+	if (lastfuncprofile && lastfuncprofile->func == func)
+		return lastfuncprofile;
+
+	for (i = 0; i < numfuncprofiles; i++)
+		if (funcprofiles[i].func == func)
+			return (lastfuncprofile = &funcprofiles[i]);
+
+	if (numfuncprofiles == MAXPROFILEDFUNCS)
+		return NULL;
+
+	lastfuncprofile = &funcprofiles[numfuncprofiles++];
+	lastfuncprofile->func = func;
+	lastfuncprofile->time = 0;
+	lastfuncprofile->calls = 0;
+	return lastfuncprofile;
+}
+
+/** Called by LUAh_MobjThinker while profiling, with how long the
+  * hooks took for a mobj.
+  */
+void P_AddMobjLuaTime(mobjtype_t type, UINT64 time)
+{
+	if (type < NUMMOBJTYPES)
+		mobjprofiles[type].luatime += time;
+}
+
+static void P_ResetThinkerProfile(void)
+{
+	numfuncprofiles = 0;
+	lastfuncprofile = NULL;
+	memset(mobjprofiles, 0, sizeof mobjprofiles);
+	profiledtics = 0;
+}
+
+// Sorted by total time, highest first
+static int P_CompareFuncProfiles(const void *a, const void *b)
+{
+	const UINT64 x = ((const funcprofile_t *)a)->time, y = ((const funcprofile_t *)b)->time;
+	return (x < y) - (x > y);
+}
+
+static const mobjprofile_t *sortmobjprofiles;
+
+static int P_CompareMobjProfiles(const void *a, const void *b)
+{
+	const UINT64 x = sortmobjprofiles[*(const mobjtype_t *)a].time, y = sortmobjprofiles[*(const mobjtype_t *)b].time;
+	return (x < y) - (x > y);
+}
+
+static double P_PreciseToMicros(UINT64 time)
+{
+	const UINT64 precision = I_GetPrecision();
+	return (double)time * 1000000.0 / (double)precision;
+}
+
+static void P_ShowThinkerProfile(INT32 count)
+{
+	mobjtype_t order[NUMMOBJTYPES];
+	const double tics = profiledtics ? (double)profiledtics : 1.0;
+	size_t i, n;
+
+	CONS_Printf(M_GetText("Thinker time over %u tics, in microseconds:\n"), profiledtics);
+	CONS_Printf("  %-24s %10s %10s %8s\n", "function", "calls", "per tic", "per call");
+	qsort(funcprofiles, numfuncprofiles, sizeof *funcprofiles, P_CompareFuncProfiles);
+	for (i = 0; i < numfuncprofiles && i < (size_t)count; i++)
+	{
+		const funcprofile_t *fp = &funcprofiles[i];
+		CONS_Printf("  %-24s %10u %10.1f %8.2f\n", P_ThinkerFuncName(fp->func), fp->calls,
+			P_PreciseToMicros(fp->time) / tics, fp->calls ? P_PreciseToMicros(fp->time) / fp->calls : 0.0);
+	}
+
+	for (i = n = 0; i < NUMMOBJTYPES; i++)
+		if (mobjprofiles[i].calls)
+			order[n++] = i;
+	sortmobjprofiles = mobjprofiles;
+	qsort(order, n, sizeof *order, P_CompareMobjProfiles);
+
+	CONS_Printf("  %-24s %10s %10s %8s %8s\n", "mobj type", "calls", "per tic", "per call", "lua/tic");
+	for (i = 0; i < n && i < (size_t)count; i++)
+	{
+		const mobjprofile_t *mp = &mobjprofiles[order[i]];
+		const char *name = DEH_GetMobjTypeName(order[i]);
+		CONS_Printf("  %-24s %10u %10.1f %8.2f %8.1f\n", name ? va("MT_%s", name) : va("%d", order[i]), mp->calls,
+			P_PreciseToMicros(mp->time) / tics, P_PreciseToMicros(mp->time) / mp->calls, P_PreciseToMicros(mp->luatime) / tics);
+	}
+}
+
+static void P_SaveThinkerProfile(const char *filename)
+{
+	char path[MAX_WADPATH];
+	FILE *f;
+	size_t i;
+
+	snprintf(path, sizeof path, "%s"PATHSEP"%s", srb2home, filename);
+	FIL_DefaultExtension(path, ".csv");
+
+	f = fopen(path, "w");
+	if (!f)
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("Couldn't write '%s'\n"), path);
+		return;
+	}
+
+	fprintf(f, "kind,name,calls,total_us,lua_us,tics\n");
+	for (i = 0; i < numfuncprofiles; i++)
+		fprintf(f, "function,%s,%u,%.1f,,%u\n", P_ThinkerFuncName(funcprofiles[i].func),
+			funcprofiles[i].calls, P_PreciseToMicros(funcprofiles[i].time), profiledtics);
+	for (i = 0; i < NUMMOBJTYPES; i++)
+	{
+		const char *name = DEH_GetMobjTypeName((INT32)i);
+		if (!mobjprofiles[i].calls)
+			continue;
+		fprintf(f, "mobjtype,%s,%u,%.1f,%.1f,%u\n", name ? va("MT_%s", name) : va("%s", sizeu1(i)),
+			mobjprofiles[i].calls, P_PreciseToMicros(mobjprofiles[i].time), P_PreciseToMicros(mobjprofiles[i].luatime), profiledtics);
+	}
+	fclose(f);
+
+	CONS_Printf(M_GetText("Thinker profile saved to '%s'\n"), path);
+}
+
+/** Measures what every kind of thinker costs.
+  * "profilethinkers on|off|reset|show [count]|save [file]"
+  */
+void Command_ProfileThinkers_f(void)
+{
+	const char *arg = (COM_Argc() > 1) ? COM_Argv(1) : "";
+
+	if (!stricmp(arg, "on"))
+	{
+		if (!thinkerprofiling)
+			P_ResetThinkerProfile();
+		thinkerprofiling = true;
+		CONS_Printf(M_GetText("Profiling thinkers.\n"));
+	}
+	else if (!stricmp(arg, "off"))
+	{
+		thinkerprofiling = false;
+		CONS_Printf(M_GetText("Stopped profiling thinkers.\n"));
+	}
+	else if (!stricmp(arg, "reset"))
+		P_ResetThinkerProfile();
+	else if (!stricmp(arg, "show"))
+		P_ShowThinkerProfile((COM_Argc() > 2) ? atoi(COM_Argv(2)) : 10);
+	else if (!stricmp(arg, "save"))
+		P_SaveThinkerProfile((COM_Argc() > 2) ? COM_Argv(2) : "thinkers.csv");
+	else
+		CONS_Printf(M_GetText("profilethinkers <on|off|reset|show [count]|save [file]>: measure what each kind of thinker costs\n"));
+}
+
 //
 // P_InitThinkers
 //
@@ -294,6 +550,42 @@ if ((*mop = targ) != NULL) // Set new target and if non-NULL, increase its count
 	return targ;
 }
 
+// P_RunThinkers, timing every thinker
+static void P_RunThinkersProfiled(void)
+{
+	size_t i;
+	for (i = 0; i < NUM_THINKERLISTS; i++)
+	{
+		for (currentthinker = thlist[i].next; currentthinker != &thlist[i]; currentthinker = currentthinker->next)
+		{
+			const actionf_p1 func = currentthinker->function.acp1;
+			// The mobj may be gone once it has thought
+			const mobjtype_t type = (i == THINK_MOBJ && func == (actionf_p1)P_MobjThinker) ? ((mobj_t *)currentthinker)->type : NUMMOBJTYPES;
+			funcprofile_t *fp;
+			UINT64 start, time;
+
+#ifdef PARANOIA
+			I_Assert(func != NULL);
+#endif
+			start = I_GetPreciseTime();
+			func(currentthinker);
+			time = I_GetPreciseTime() - start;
+
+			if ((fp = P_GetFuncProfile(func)) != NULL)
+			{
+				fp->time += time;
+				fp->calls++;
+			}
+			if (type < NUMMOBJTYPES)
+			{
+				mobjprofiles[type].time += time;
+				mobjprofiles[type].calls++;
+			}
+		}
+	}
+	profiledtics++;
+}
+
 //
 // P_RunThinkers
 //
@@ -319,6 +611,14 @@ if ((*mop = targ) != NULL) // Set new target and if non-NULL, increase its count
 static inline void P_RunThinkers(void)
 {
 	size_t i;
+	TRACE_BEGIN("P_RunThinkers");
+	P_UpdateDormancy();
+	if (thinkerprofiling)
+	{
+		P_RunThinkersProfiled();
+		TRACE_END();
+		return;
+	}
 	for (i = 0; i < NUM_THINKERLISTS; i++)
 	{
 		for (currentthinker = thlist[i].next; currentthinker != &thlist[i]; currentthinker = currentthinker->next)
@@ -329,7 +629,7 @@ static inline void P_RunThinkers(void)
 			currentthinker->function.acp1(currentthinker);
 		}
 	}
-
+	TRACE_END();
 }
 
 //
@@ -588,6 +888,15 @@ void P_Ticker(boolean run)
 {
 	INT32 i;
 
+	TRACE_BEGIN("P_Ticker");
+
+	// Whatever this tic does to the level, the frames drawn until the next one
+	// move it there from here
+	R_StartInterpolationTic();
+
+	// Sight answers only hold within a tic
+	P_ClearSightCache();
+
 	// Increment jointime and quittime even if paused
 	for (i = 0; i < MAXPLAYERS; i++)
 		if (playeringame[i])
@@ -616,6 +925,7 @@ void P_Ticker(boolean run)
 			P_MoveChaseCamera(&players[0], &camera, false);
 			P_MapEnd();
 			S_SetStackAdjustmentStart();
+			TRACE_END();
 			return;
 		}
 	}
@@ -624,6 +934,7 @@ void P_Ticker(boolean run)
 	if (paused || P_AutoPause())
 	{
 		S_SetStackAdjustmentStart();
+		TRACE_END();
 		return;
 	}
 
@@ -744,7 +1055,11 @@ void P_Ticker(boolean run)
 
 	P_MapEnd();
 
+	LUAh_CheckHookBudget();
+
 //	Z_CheckMemCleanup();
+
+	TRACE_END();
 }
 
 // Abbreviated ticker for pre-loading, calls thinkers and assorted things
@@ -760,6 +1075,9 @@ void P_PreTicker(INT32 frames)
 
 	for (framecnt = 0; framecnt < frames; ++framecnt)
 	{
+		R_StartInterpolationTic();
+		P_ClearSightCache();
+
 		P_MapStart();
 
 		LUAh_PreThinkFrame();
@@ -23,6 +23,11 @@ extern tic_t leveltime;
 // Called by G_Ticker. Carries out all thinking of enemies and players.
 void Command_Numthinkers_f(void);
 void Command_CountMobjs_f(void);
+void Command_ProfileThinkers_f(void);
+
+// Set while "profilethinkers" is measuring what each thinker costs
+extern boolean thinkerprofiling;
+void P_AddMobjLuaTime(mobjtype_t type, UINT64 time);
 
 void P_Ticker(boolean run);
 void P_PreTicker(INT32 frames);
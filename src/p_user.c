@@ -21,6 +21,7 @@
 #include "g_game.h"
 #include "p_local.h"
 #include "r_main.h"
+#include "r_fps.h"
 #include "s_sound.h"
 #include "r_skins.h"
 #include "d_think.h"
@@ -9739,6 +9740,8 @@ void P_ResetCamera(player_t *player, camera_t *thiscam)
 	thiscam->height = 16*FRACUNIT;
 
 	while (!P_MoveChaseCamera(player,thiscam,true) && ++tries < 2*TICRATE);
+
+	R_ResetCameraInterpolationState(thiscam);
 }
 
 boolean P_MoveChaseCamera(player_t *player, camera_t *thiscam, boolean resetcalled)
@@ -11264,6 +11267,7 @@ static void P_DoTailsOverlay(player_t *player, mobj_t *tails)
 	tails->destscale = player->mo->destscale;
 	tails->radius = player->mo->radius;
 	tails->height = player->mo->height;
+	P_UpdateBlockThing(tails);
 	zoffs = FixedMul(zoffs, tails->scale);
 
 	if (player->mo->eflags & MFE_VERTICALFLIP)
@@ -1223,6 +1223,70 @@ void R_InitData(void)
 	R_InitColormaps();
 }
 
+// Gets the patch lumps of a sprite frame (see R_InitSprites for more about
+// lumppat, lumpid), returning how many there are.
+static UINT8 R_GetSpriteFrameLumps(const spriteframe_t *sf, lumpnum_t *lumps)
+{
+	UINT8 k, numlumps = 0;
+
+	switch (sf->rotate)
+	{
+		case SRF_SINGLE:
+			lumps[numlumps++] = sf->lumppat[0];
+			break;
+		case SRF_2D:
+			lumps[numlumps++] = sf->lumppat[2];
+			lumps[numlumps++] = sf->lumppat[6];
+			break;
+		default:
+			k = (sf->rotate & SRF_3DGE ? 16 : 8);
+			while (k--)
+				lumps[numlumps++] = sf->lumppat[k];
+			break;
+	}
+
+	return numlumps;
+}
+
+static void R_PrefetchTexture(INT32 texnum)
+{
+	INT16 i;
+
+	if (texnum < 0 || texnum >= numtextures || texturecache[texnum])
+		return;
+
+	for (i = 0; i < textures[texnum]->patchcount; i++)
+		W_PrefetchLumpPwad(textures[texnum]->patches[i].wad, textures[texnum]->patches[i].lump);
+}
+
+//
+// R_PrefetchLevel
+//
+// Gets the lumps of the level's flats and wall textures decompressing in
+// the background while the rest of the level is set up, ahead of
+// R_PrecacheLevel.
+//
+void R_PrefetchLevel(void)
+{
+	size_t i;
+
+	if (demoplayback || rendermode != render_soft)
+		return;
+
+	for (i = 0; i < numlevelflats; i++)
+		if (levelflats[i].type == LEVELFLAT_FLAT)
+			W_PrefetchLump(levelflats[i].u.flat.lumpnum);
+
+	for (i = 0; i < numsides; i++)
+	{
+		R_PrefetchTexture(sides[i].toptexture);
+		R_PrefetchTexture(sides[i].midtexture);
+		R_PrefetchTexture(sides[i].bottomtexture);
+	}
+
+	R_PrefetchTexture(skytexture);
+}
+
 //
 // R_PrecacheLevel
 //
@@ -1232,10 +1296,10 @@ void R_PrecacheLevel(void)
 {
 	char *texturepresent, *spritepresent;
 	size_t i, j, k;
-	lumpnum_t lump;
+	lumpnum_t lumps[16];
+	UINT8 numlumps;
 
 	thinker_t *th;
-	spriteframe_t *sf;
 
 	if (demoplayback)
 		return;
@@ -1244,6 +1308,30 @@ void R_PrecacheLevel(void)
 	if (rendermode != render_soft)
 		return;
 
+	//
+	// Find the sprites in use first, so that their lumps can be decompressing
+	// in the background while the flats and textures are cached.
+	//
+	spritepresent = calloc(numsprites, sizeof (*spritepresent));
+	if (spritepresent == NULL) I_Error("%s: Out of memory looking up sprites", "R_PrecacheLevel");
+
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		if (th->function.acp1 != (actionf_p1)P_RemoveThinkerDelayed)
+			spritepresent[((mobj_t *)th)->sprite] = 1;
+
+	for (i = 0; i < numsprites; i++)
+	{
+		if (!spritepresent[i])
+			continue;
+
+		for (j = 0; j < sprites[i].numframes; j++)
+		{
+			numlumps = R_GetSpriteFrameLumps(&sprites[i].spriteframes[j], lumps);
+			for (k = 0; k < numlumps; k++)
+				W_PrefetchLump(lumps[k]);
+		}
+	}
+
 	// Precache flats.
 	flatmemory = P_PrecacheLevelFlats();
 
@@ -1287,13 +1375,6 @@ void R_PrecacheLevel(void)
 	//
 	// Precache sprites.
 	//
-	spritepresent = calloc(numsprites, sizeof (*spritepresent));
-	if (spritepresent == NULL) I_Error("%s: Out of memory looking up sprites", "R_PrecacheLevel");
-
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
-		if (th->function.acp1 != (actionf_p1)P_RemoveThinkerDelayed)
-			spritepresent[((mobj_t *)th)->sprite] = 1;
-
 	spritememory = 0;
 	for (i = 0; i < numsprites; i++)
 	{
@@ -1302,30 +1383,13 @@ void R_PrecacheLevel(void)
 
 		for (j = 0; j < sprites[i].numframes; j++)
 		{
-			sf = &sprites[i].spriteframes[j];
-#define cacheang(a) {\
-		lump = sf->lumppat[a];\
-		if (devparm)\
-			spritememory += W_LumpLength(lump);\
-		W_CachePatchNum(lump, PU_PATCH);\
-	}
-			// see R_InitSprites for more about lumppat,lumpid
-			switch (sf->rotate)
+			numlumps = R_GetSpriteFrameLumps(&sprites[i].spriteframes[j], lumps);
+			for (k = 0; k < numlumps; k++)
 			{
-				case SRF_SINGLE:
-					cacheang(0);
-					break;
-				case SRF_2D:
-					cacheang(2);
-					cacheang(6);
-					break;
-				default:
-					k = (sf->rotate & SRF_3DGE ? 16 : 8);
-					while (k--)
-						cacheang(k);
-					break;
+				if (devparm)
+					spritememory += W_LumpLength(lumps[k]);
+				W_CachePatchNum(lumps[k], PU_PATCH);
 			}
-#undef cacheang
 		}
 	}
 	free(spritepresent);
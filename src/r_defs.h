@@ -321,6 +321,15 @@ typedef struct sector_s
 	size_t linecount;
 	struct line_s **lines; // [linecount] size
 
+	// distinct sectors across this sector's lines, see P_InitSectorNeighbors
+	size_t neighborcount;
+	struct sector_s **neighbors; // [neighborcount] size
+
+	// lowest and highest planes among the neighbors, until one of them moves
+	boolean surroundingvalid;
+	fixed_t surroundinglowfloor, surroundinghighfloor;
+	fixed_t surroundinglowceiling, surroundinghighceiling;
+
 	// Improved fake floor hack
 	ffloor_t *ffloors;
 	size_t *attached;
@@ -25,6 +25,14 @@
 #include "w_wad.h"
 #include "z_zone.h"
 #include "console.h" // Until buffering gets finished
+#include "i_system.h" // I_AddExitFunc
+#include "i_threads.h"
+
+// SSE2 helps the tilted span drawers along
+#if !defined (NOASM) && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TILTEDSSE2
+#include <emmintrin.h>
+#endif
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -61,13 +69,13 @@ UINT8 *topleft;
 //                      COLUMN DRAWING CODE STUFF
 // =========================================================================
 
-lighttable_t *dc_colormap;
-INT32 dc_x = 0, dc_yl = 0, dc_yh = 0;
+DRAWLOCAL lighttable_t *dc_colormap;
+DRAWLOCAL INT32 dc_x = 0, dc_yl = 0, dc_yh = 0;
 
-fixed_t dc_iscale, dc_texturemid;
-UINT8 dc_hires; // under MSVC boolean is a byte, while on other systems, it a bit,
-               // soo lets make it a byte on all system for the ASM code
-UINT8 *dc_source;
+DRAWLOCAL fixed_t dc_iscale, dc_texturemid;
+DRAWLOCAL UINT8 dc_hires; // under MSVC boolean is a byte, while on other systems, it a bit,
+                          // soo lets make it a byte on all system for the ASM code
+DRAWLOCAL UINT8 *dc_source;
 
 // -----------------------
 // translucency stuff here
@@ -78,7 +86,7 @@ UINT8 *transtables; // translucency tables
 
 /**	\brief R_DrawTransColumn uses this
 */
-UINT8 *dc_transmap; // one of the translucency tables
+DRAWLOCAL UINT8 *dc_transmap; // one of the translucency tables
 
 // ----------------------
 // translation stuff here
@@ -87,33 +95,738 @@ UINT8 *dc_transmap; // one of the translucency tables
 
 /**	\brief R_DrawTranslatedColumn uses this
 */
-UINT8 *dc_translation;
+DRAWLOCAL UINT8 *dc_translation;
 
 struct r_lightlist_s *dc_lightlist = NULL;
-INT32 dc_numlights = 0, dc_maxlights, dc_texheight;
+INT32 dc_numlights = 0, dc_maxlights;
+DRAWLOCAL INT32 dc_texheight;
 
 // =========================================================================
 //                      SPAN DRAWING CODE STUFF
 // =========================================================================
 
-INT32 ds_y, ds_x1, ds_x2;
-lighttable_t *ds_colormap;
-fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
-UINT16 ds_flatwidth, ds_flatheight;
-boolean ds_powersoftwo;
+DRAWLOCAL INT32 ds_y, ds_x1, ds_x2;
+DRAWLOCAL lighttable_t *ds_colormap;
+DRAWLOCAL fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
+DRAWLOCAL UINT16 ds_flatwidth, ds_flatheight;
+DRAWLOCAL boolean ds_powersoftwo;
 
-UINT8 *ds_source; // start of a 64*64 tile image
-UINT8 *ds_transmap; // one of the translucency tables
+DRAWLOCAL UINT8 *ds_source; // start of a 64*64 tile image
+DRAWLOCAL UINT8 *ds_transmap; // one of the translucency tables
+DRAWLOCAL fixed_t ds_viewx, ds_viewy, ds_viewz;
 
 pslope_t *ds_slope; // Current slope being used
 floatv3_t ds_su[MAXVIDHEIGHT], ds_sv[MAXVIDHEIGHT], ds_sz[MAXVIDHEIGHT]; // Vectors for... stuff?
-floatv3_t *ds_sup, *ds_svp, *ds_szp;
-float focallengthf, zeroheight;
+DRAWLOCAL floatv3_t *ds_sup, *ds_svp, *ds_szp;
+float focallengthf;
+DRAWLOCAL float zeroheight;
 
 /**	\brief Variable flat sizes
 */
 
-UINT32 nflatxshift, nflatyshift, nflatshiftup, nflatmask;
+DRAWLOCAL UINT32 nflatxshift, nflatyshift, nflatshiftup, nflatmask;
+
+// =========================================================================
+//                      QUAD COLUMN BATCHING
+// =========================================================================
+
+// Drawing a column walks down the screen a pixel at a time, touching another
+// cache line for each of them. The walls of R_RenderSegLoop and the sprites
+// of R_DrawVisSprite are drawn with a batch open (see R_StartColumnBatch),
+// which holds back the columns of the kinds that have a quad drawer in
+// colfuncs_quad[]. Each run of four side by side columns is then drawn in
+// one go, a row at a time where they overlap (see R_DrawColumnQuad_8).
+//
+// A held column must not be drawn over before it is drawn itself, so all of
+// them are drawn as soon as a column of another kind or one covering the
+// same pixels comes along, and when the batch ends.
+#define QUADRUNS 4 // enough for the pieces of a wall column, or the posts of most sprite columns
+
+typedef struct
+{
+	void (*func)(void);
+	void (*quadfunc)(void); // NULL if it has no quad drawer
+	lighttable_t *colormap;
+	UINT8 *source, *transmap, *translation;
+	fixed_t iscale, texturemid;
+	INT32 x, yl, yh, texheight;
+	UINT8 hires;
+	UINT8 band;
+} drawcolumn_t;
+
+typedef struct
+{
+	drawcolumn_t columns[4];
+	INT32 count;
+} quadrun_t;
+
+static DRAWLOCAL quadrun_t quadruns[QUADRUNS];
+static DRAWLOCAL INT32 numquadruns;
+static DRAWLOCAL void (*quadcolfunc)(void), (*quadfunc)(void); // drawers of the held columns
+static DRAWLOCAL const drawcolumn_t *dc_quad; // the four columns for the quad drawers
+
+static void (*batchcolfunc)(void), (*batchquadfunc)(void); // colfunc and its quad drawer while a batch is open
+
+static void R_SaveColumn(drawcolumn_t *dc)
+{
+	dc->colormap = dc_colormap;
+	dc->source = dc_source;
+	dc->transmap = dc_transmap;
+	dc->translation = dc_translation;
+	dc->iscale = dc_iscale;
+	dc->texturemid = dc_texturemid;
+	dc->x = dc_x;
+	dc->yl = dc_yl;
+	dc->yh = dc_yh;
+	dc->texheight = dc_texheight;
+	dc->hires = dc_hires;
+}
+
+static void R_LoadColumn(const drawcolumn_t *dc)
+{
+	dc_colormap = dc->colormap;
+	dc_source = dc->source;
+	dc_transmap = dc->transmap;
+	dc_translation = dc->translation;
+	dc_iscale = dc->iscale;
+	dc_texturemid = dc->texturemid;
+	dc_x = dc->x;
+	dc_yl = dc->yl;
+	dc_yh = dc->yh;
+	dc_texheight = dc->texheight;
+	dc_hires = dc->hires;
+}
+
+// The quad drawers leave dc_* alone, the others don't.
+static void R_DrawQuadRun(quadrun_t *run)
+{
+	INT32 i;
+
+	if (run->count == 4)
+	{
+		dc_quad = run->columns;
+		quadfunc();
+	}
+	else for (i = 0; i < run->count; i++)
+	{
+		R_LoadColumn(&run->columns[i]);
+		quadcolfunc();
+	}
+
+	run->count = 0;
+}
+
+// Draws all of the held columns. Leaves dc_* alone.
+static void R_FlushQuadRuns(void)
+{
+	drawcolumn_t savedcol;
+	INT32 i;
+
+	if (!numquadruns)
+		return;
+
+	R_SaveColumn(&savedcol);
+	for (i = 0; i < numquadruns; i++)
+		R_DrawQuadRun(&quadruns[i]);
+	R_LoadColumn(&savedcol);
+
+	numquadruns = 0;
+}
+
+// Holds back the column in dc_* to be drawn with func, or with quad along
+// with three others, or draws it right away if quad is NULL.
+static void R_BatchColumn(void (*func)(void), void (*quad)(void))
+{
+	quadrun_t *run = NULL, *freerun = NULL;
+	const drawcolumn_t *last;
+	INT32 i, j;
+
+	if (dc_yl > dc_yh) // The drawers would do nothing anyway
+		return;
+
+	if (func != quadcolfunc || !quad)
+		R_FlushQuadRuns();
+
+	if (!quad)
+	{
+		func();
+		return;
+	}
+
+	quadcolfunc = func;
+	quadfunc = quad;
+
+	// Find the run this column carries on, minding the ones it covers
+	for (i = 0; i < numquadruns; i++)
+	{
+		if (!quadruns[i].count)
+		{
+			if (!freerun)
+				freerun = &quadruns[i];
+			continue;
+		}
+
+		for (j = 0; j < quadruns[i].count; j++)
+		{
+			const drawcolumn_t *dc = &quadruns[i].columns[j];
+			if (dc->x == dc_x && dc->yl <= dc_yh && dc->yh >= dc_yl)
+				break;
+		}
+		if (j < quadruns[i].count)
+		{
+			R_FlushQuadRuns();
+			run = freerun = NULL;
+			break;
+		}
+
+		last = &quadruns[i].columns[quadruns[i].count - 1];
+		if (!run && last->x == dc_x - 1 && last->yl <= dc_yh && last->yh >= dc_yl)
+			run = &quadruns[i];
+	}
+
+	if (!run)
+	{
+		if (freerun)
+			run = freerun;
+		else
+		{
+			if (numquadruns == QUADRUNS)
+				R_FlushQuadRuns();
+			run = &quadruns[numquadruns++];
+		}
+	}
+
+	R_SaveColumn(&run->columns[run->count]);
+	if (++run->count == 4)
+		R_DrawQuadRun(run);
+}
+
+static void R_BatchedColumn(void)
+{
+	R_BatchColumn(batchcolfunc, batchquadfunc);
+}
+
+// =========================================================================
+//                      THREADED DRAWING
+// =========================================================================
+
+#ifdef DRAWTHREADS
+// While a view is rendered with renderthreads above 1, colfuncs[] hold stubs
+// that only record the dc_* variables. R_FlushDrawQueue then draws the
+// recorded columns with one thread per set of vertical bands, the bands being
+// 1<<DRAWBANDSHIFT columns wide and handed out in turn. Each column is drawn
+// by a single thread in the order it was recorded, so the result is exactly
+// what drawing everything right away would have given.
+//
+// The spans of the opaque planes drawn by R_DrawPlanes are recorded the same
+// way (see R_QueueSpans), and split into horizontal bands 1<<SPANBANDSHIFT
+// rows high. Only one kind is queued at a time: recording a span flushes the
+// columns and the other way around, which keeps everything in order.
+//
+// The queue must be flushed before anything else touches the view, such
+// as drawing a translucent plane, and the data it points to must stay around
+// until then (see R_AllocColumnData).
+#define DRAWBANDSHIFT 6
+#define SPANBANDSHIFT 2
+
+typedef struct
+{
+	void (*func)(void);
+	lighttable_t *colormap, **planezlight;
+	UINT8 *source, *transmap;
+	fixed_t xfrac, yfrac, xstep, ystep;
+	fixed_t viewx, viewy, viewz;
+	floatv3_t su, sv, sz; // copied, as the next plane overwrites ds_su[] and co.
+	float zeroheight;
+	UINT32 nflatxshift, nflatyshift, nflatshiftup, nflatmask;
+	INT32 y, x1, x2;
+	UINT16 flatwidth, flatheight;
+	UINT8 band;
+} drawspan_t;
+
+static drawcolumn_t *drawcolumns;
+static size_t numdrawcolumns, maxdrawcolumns;
+static drawspan_t *drawspans;
+static size_t numdrawspans, maxdrawspans;
+static INT32 numdrawbands; // in the view being rendered, 0 if everything is drawn right away
+
+static void (*drawcolfuncs[COLDRAWFUNC_MAX])(void); // the real drawers, while colfuncs[] are stubs
+static void (*drawspanfunc)(void); // the real drawer, while spanfunc is a stub
+
+// Memory for column data, reused once the columns are drawn
+typedef struct drawdata_s
+{
+	struct drawdata_s *next;
+	size_t size, used; // bytes following this header
+} drawdata_t;
+
+#define DRAWDATACHUNK (64<<10)
+
+static drawdata_t *drawdatahead, *drawdatacur;
+
+static I_mutex drawthreads_mutex;
+static I_cond drawthreads_cond; // a batch of columns is ready, a thread is done with it, or a thread quit
+static INT32 numdrawthreads; // running, each drawing band numbers 1 and up
+static INT32 drawthreadsbusy; // threads still drawing the current batch
+static UINT32 drawbatch; // increased for each batch
+static INT32 drawbatchbands; // numdrawbands for the current batch
+static boolean drawthreadsstopping;
+
+#define Lock_drawthreads()   I_lock_mutex(&drawthreads_mutex)
+#define Unlock_drawthreads() I_unlock_mutex(drawthreads_mutex)
+
+static void R_SaveSpan(drawspan_t *ds)
+{
+	ds->colormap = ds_colormap;
+	ds->planezlight = planezlight;
+	ds->source = ds_source;
+	ds->transmap = ds_transmap;
+	ds->xfrac = ds_xfrac;
+	ds->yfrac = ds_yfrac;
+	ds->xstep = ds_xstep;
+	ds->ystep = ds_ystep;
+	ds->viewx = ds_viewx;
+	ds->viewy = ds_viewy;
+	ds->viewz = ds_viewz;
+	if (ds_sup)
+	{
+		ds->su = *ds_sup;
+		ds->sv = *ds_svp;
+		ds->sz = *ds_szp;
+	}
+	ds->zeroheight = zeroheight;
+	ds->nflatxshift = nflatxshift;
+	ds->nflatyshift = nflatyshift;
+	ds->nflatshiftup = nflatshiftup;
+	ds->nflatmask = nflatmask;
+	ds->y = ds_y;
+	ds->x1 = ds_x1;
+	ds->x2 = ds_x2;
+	ds->flatwidth = ds_flatwidth;
+	ds->flatheight = ds_flatheight;
+}
+
+// Points ds_sup and co. at the span's own copies, which the caller
+// must put back if they matter.
+static void R_LoadSpan(drawspan_t *ds)
+{
+	ds_colormap = ds->colormap;
+	planezlight = ds->planezlight;
+	ds_source = ds->source;
+	ds_transmap = ds->transmap;
+	ds_xfrac = ds->xfrac;
+	ds_yfrac = ds->yfrac;
+	ds_xstep = ds->xstep;
+	ds_ystep = ds->ystep;
+	ds_viewx = ds->viewx;
+	ds_viewy = ds->viewy;
+	ds_viewz = ds->viewz;
+	ds_sup = &ds->su;
+	ds_svp = &ds->sv;
+	ds_szp = &ds->sz;
+	zeroheight = ds->zeroheight;
+	nflatxshift = ds->nflatxshift;
+	nflatyshift = ds->nflatyshift;
+	nflatshiftup = ds->nflatshiftup;
+	nflatmask = ds->nflatmask;
+	ds_y = ds->y;
+	ds_x1 = ds->x1;
+	ds_x2 = ds->x2;
+	ds_flatwidth = ds->flatwidth;
+	ds_flatheight = ds->flatheight;
+}
+
+static void R_QueueColumn(INT32 type)
+{
+	drawcolumn_t *dc;
+
+	if (dc_yl > dc_yh) // The drawers would do nothing anyway
+		return;
+
+	if (numdrawspans)
+		R_FlushDrawQueue();
+
+	if (numdrawcolumns == maxdrawcolumns)
+	{
+		maxdrawcolumns = maxdrawcolumns ? maxdrawcolumns*2 : 4096;
+		drawcolumns = realloc(drawcolumns, maxdrawcolumns * sizeof (*drawcolumns));
+		if (!drawcolumns)
+			I_Error("R_QueueColumn: Out of memory");
+	}
+
+	dc = &drawcolumns[numdrawcolumns++];
+	R_SaveColumn(dc);
+	dc->func = drawcolfuncs[type];
+	dc->quadfunc = colfuncs_quad[type];
+	dc->band = (UINT8)(((UINT32)dc_x >> DRAWBANDSHIFT) % numdrawbands);
+}
+
+static void R_QueueSpan(void)
+{
+	drawspan_t *ds;
+
+	if (ds_x1 > ds_x2)
+		return;
+
+	if (numdrawcolumns)
+		R_FlushDrawQueue();
+
+	if (numdrawspans == maxdrawspans)
+	{
+		maxdrawspans = maxdrawspans ? maxdrawspans*2 : 1024;
+		drawspans = realloc(drawspans, maxdrawspans * sizeof (*drawspans));
+		if (!drawspans)
+			I_Error("R_QueueSpan: Out of memory");
+	}
+
+	ds = &drawspans[numdrawspans++];
+	R_SaveSpan(ds);
+	ds->func = drawspanfunc;
+	ds->band = (UINT8)(((UINT32)ds_y >> SPANBANDSHIFT) % numdrawbands);
+}
+
+static void R_QueueBaseColumn(void)                { R_QueueColumn(BASEDRAWFUNC); }
+static void R_QueueFuzzyColumn(void)               { R_QueueColumn(COLDRAWFUNC_FUZZY); }
+static void R_QueueTransColumn(void)               { R_QueueColumn(COLDRAWFUNC_TRANS); }
+static void R_QueueShadeColumn(void)               { R_QueueColumn(COLDRAWFUNC_SHADE); }
+static void R_QueueTransTransColumn(void)          { R_QueueColumn(COLDRAWFUNC_TRANSTRANS); }
+static void R_QueueTwoSMultiPatchColumn(void)      { R_QueueColumn(COLDRAWFUNC_TWOSMULTIPATCH); }
+static void R_QueueTwoSMultiPatchTransColumn(void) { R_QueueColumn(COLDRAWFUNC_TWOSMULTIPATCHTRANS); }
+static void R_QueueFogColumn(void)                 { R_QueueColumn(COLDRAWFUNC_FOG); }
+
+// Reads the lightlist, which changes from column to column, so it is split
+// into pieces right away, and these go through the base column stub.
+static void R_QueueShadowedColumn(void)
+{
+	drawcolfuncs[COLDRAWFUNC_SHADOWED]();
+}
+
+static void (*const queuecolfuncs[COLDRAWFUNC_MAX])(void) =
+{
+	R_QueueBaseColumn,
+	R_QueueFuzzyColumn,
+	R_QueueTransColumn,
+	R_QueueShadeColumn,
+	R_QueueShadowedColumn,
+	R_QueueTransTransColumn,
+	R_QueueTwoSMultiPatchColumn,
+	R_QueueTwoSMultiPatchTransColumn,
+	R_QueueFogColumn,
+};
+
+// Only one of the two is ever queued
+static void R_DrawBand(INT32 band)
+{
+	const drawcolumn_t *dc, *dcend = drawcolumns + numdrawcolumns;
+	drawspan_t *ds, *dsend = drawspans + numdrawspans;
+
+	for (dc = drawcolumns; dc < dcend; dc++)
+		if (dc->band == band)
+		{
+			R_LoadColumn(dc);
+			R_BatchColumn(dc->func, dc->quadfunc);
+		}
+	R_FlushQuadRuns();
+
+	for (ds = drawspans; ds < dsend; ds++)
+		if (ds->band == band)
+		{
+			R_LoadSpan(ds);
+			ds->func();
+		}
+}
+
+static void R_DrawThread(void *userdata)
+{
+	INT32 band = (INT32)(size_t)userdata;
+	UINT32 batch = 0;
+	boolean draw;
+
+	for (;;)
+	{
+		Lock_drawthreads();
+		{
+			while (drawbatch == batch && !drawthreadsstopping)
+				I_hold_cond(&drawthreads_cond, drawthreads_mutex);
+
+			if (drawthreadsstopping)
+			{
+				numdrawthreads--;
+				I_wake_all_cond(&drawthreads_cond);
+				Unlock_drawthreads();
+				return;
+			}
+
+			batch = drawbatch;
+			draw = (band < drawbatchbands);
+		}
+		Unlock_drawthreads();
+
+		if (!draw)
+			continue;
+
+		R_DrawBand(band);
+
+		Lock_drawthreads();
+		{
+			if (!--drawthreadsbusy)
+				I_wake_all_cond(&drawthreads_cond);
+		}
+		Unlock_drawthreads();
+	}
+}
+
+// Makes the threads quit, before I_stop_threads waits for them.
+static void R_StopDrawThreads(void)
+{
+	if (I_thread_is_stopped())
+		return;
+
+	Lock_drawthreads();
+	{
+		drawthreadsstopping = true;
+		I_wake_all_cond(&drawthreads_cond);
+		while (numdrawthreads)
+			I_hold_cond(&drawthreads_cond, drawthreads_mutex);
+	}
+	Unlock_drawthreads();
+}
+
+static void R_StartDrawThreads(INT32 count)
+{
+	while (numdrawthreads < count)
+	{
+		if (!numdrawthreads)
+			I_AddExitFunc(R_StopDrawThreads);
+
+		Lock_drawthreads();
+		numdrawthreads++;
+		Unlock_drawthreads();
+
+		I_spawn_thread("draw-view", R_DrawThread, (void *)(size_t)numdrawthreads);
+	}
+}
+#endif
+
+/** Starts recording columns instead of drawing them, if the view is to be
+  * drawn by several threads.
+  *
+  * \sa R_QueueSpans, R_FlushDrawQueue, R_EndDrawQueue
+  */
+void R_StartDrawQueue(void)
+{
+#ifdef DRAWTHREADS
+	INT32 i;
+
+	numdrawbands = 0;
+	if (cv_renderthreads.value < 2 || rendermode != render_soft || I_thread_is_stopped())
+		return;
+
+	numdrawbands = cv_renderthreads.value;
+	R_StartDrawThreads(numdrawbands - 1);
+
+	for (i = 0; i < COLDRAWFUNC_MAX; i++)
+	{
+		drawcolfuncs[i] = colfuncs[i];
+		colfuncs[i] = queuecolfuncs[i];
+	}
+	colfunc = colfuncs[BASEDRAWFUNC];
+#endif
+}
+
+/** Records the spans drawn with the current spanfunc instead of drawing
+  * them, until the next plane sets another one. Only for planes nothing
+  * else needs to be drawn over in between, as the spans may be drawn late.
+  *
+  * \sa R_StartDrawQueue
+  */
+void R_QueueSpans(void)
+{
+#ifdef DRAWTHREADS
+	if (!numdrawbands)
+		return;
+
+	drawspanfunc = spanfunc;
+	spanfunc = R_QueueSpan;
+#endif
+}
+
+/** Draws all of the recorded columns or spans, and waits until they are done.
+  *
+  * \sa R_StartDrawQueue
+  */
+void R_FlushDrawQueue(void)
+{
+#ifdef DRAWTHREADS
+	drawcolumn_t savedcol;
+	drawspan_t savedspan;
+	floatv3_t *sup = ds_sup, *svp = ds_svp, *szp = ds_szp;
+
+	if (!numdrawcolumns && !numdrawspans)
+		return;
+
+	Lock_drawthreads();
+	{
+		drawbatch++;
+		drawbatchbands = numdrawbands;
+		drawthreadsbusy = numdrawbands - 1;
+		I_wake_all_cond(&drawthreads_cond);
+	}
+	Unlock_drawthreads();
+
+	// Band 0 is ours
+	R_SaveColumn(&savedcol);
+	R_SaveSpan(&savedspan);
+	R_DrawBand(0);
+	R_LoadColumn(&savedcol);
+	R_LoadSpan(&savedspan);
+	ds_sup = sup;
+	ds_svp = svp;
+	ds_szp = szp;
+
+	Lock_drawthreads();
+	{
+		while (drawthreadsbusy)
+			I_hold_cond(&drawthreads_cond, drawthreads_mutex);
+	}
+	Unlock_drawthreads();
+
+	numdrawcolumns = numdrawspans = 0;
+
+	drawdatacur = drawdatahead;
+	if (drawdatahead)
+		drawdatahead->used = 0;
+#endif
+}
+
+/** Draws what is left in the queue and goes back to drawing right away.
+  *
+  * \sa R_StartDrawQueue
+  */
+void R_EndDrawQueue(void)
+{
+#ifdef DRAWTHREADS
+	INT32 i;
+
+	if (!numdrawbands)
+		return;
+
+	R_FlushDrawQueue();
+
+	for (i = 0; i < COLDRAWFUNC_MAX; i++)
+		colfuncs[i] = drawcolfuncs[i];
+	colfunc = colfuncs[BASEDRAWFUNC];
+
+	numdrawbands = 0;
+#endif
+}
+
+/** Gets memory for column data that isn't kept anywhere else, such as a
+  * flipped copy of a sprite column, which lasts until the columns are drawn.
+  *
+  * \param size Size of the data, in bytes.
+  * \return The memory, or NULL if columns are being drawn right away.
+  */
+UINT8 *R_AllocColumnData(size_t size)
+{
+#ifdef DRAWTHREADS
+	drawdata_t *dd, *last = NULL;
+	UINT8 *data;
+
+	if (!numdrawbands)
+		return NULL;
+
+	// Queueing the column would flush the spans, and with them this data
+	if (numdrawspans)
+		R_FlushDrawQueue();
+
+	for (dd = drawdatacur ? drawdatacur : drawdatahead; dd && dd->used + size > dd->size; last = dd, dd = dd->next)
+		if (dd->next)
+			dd->next->used = 0;
+
+	if (!dd)
+	{
+		size_t chunksize = max(size, DRAWDATACHUNK);
+
+		dd = malloc(sizeof (*dd) + chunksize);
+		if (!dd)
+			I_Error("R_AllocColumnData: Out of memory");
+		dd->next = NULL;
+		dd->size = chunksize;
+		dd->used = 0;
+
+		if (last)
+			last->next = dd;
+		else
+			drawdatahead = dd;
+	}
+
+	drawdatacur = dd;
+	data = (UINT8 *)(dd + 1) + dd->used;
+	dd->used += size;
+	return data;
+#else
+	(void)size;
+	return NULL;
+#endif
+}
+
+/** Holds back the columns drawn with colfunc, if it has a quad drawer, so
+  * that they can be drawn four at a time. Nothing else may draw over them
+  * until the batch ends, except for columns drawn with colfunc itself.
+  *
+  * \sa R_FlushColumnBatch, R_EndColumnBatch
+  */
+void R_StartColumnBatch(void)
+{
+	INT32 i;
+
+#ifdef DRAWTHREADS
+	if (numdrawbands) // The threads batch the columns themselves
+		return;
+#endif
+
+	if (batchcolfunc)
+		R_EndColumnBatch();
+
+	for (i = 0; i < COLDRAWFUNC_MAX; i++)
+		if (colfunc == colfuncs[i])
+			break;
+
+	if (i == COLDRAWFUNC_MAX || !colfuncs_quad[i])
+		return;
+
+	batchcolfunc = colfunc;
+	batchquadfunc = colfuncs_quad[i];
+	colfunc = R_BatchedColumn;
+}
+
+/** Draws the columns held back so far, such as before freeing the data
+  * they point to.
+  *
+  * \sa R_StartColumnBatch
+  */
+void R_FlushColumnBatch(void)
+{
+	if (batchcolfunc)
+		R_FlushQuadRuns();
+}
+
+/** Draws the columns held back, and puts colfunc back if it wasn't changed
+  * in the meantime.
+  *
+  * \sa R_StartColumnBatch
+  */
+void R_EndColumnBatch(void)
+{
+	if (!batchcolfunc)
+		return;
+
+	R_FlushQuadRuns();
+	if (colfunc == R_BatchedColumn)
+		colfunc = batchcolfunc;
+	batchcolfunc = batchquadfunc = NULL;
+}
 
 // ==========================================================================
 //                        OLD DOOM FUZZY EFFECT
@@ -29,38 +29,56 @@ extern UINT8 *topleft;
 // COLUMN DRAWING CODE STUFF
 // -------------------------
 
-extern lighttable_t *dc_colormap;
-extern INT32 dc_x, dc_yl, dc_yh;
-extern fixed_t dc_iscale, dc_texturemid;
-extern UINT8 dc_hires;
+// Columns can be drawn by several threads at once (see R_FlushDrawQueue),
+// each with its own copy of the dc_* variables the drawers read.
+// The assembly drawers expect them to be plain globals.
+#if defined (HAVE_THREADS) && !defined (USEASM) && (defined (__GNUC__) || defined (_MSC_VER))
+#define DRAWTHREADS
+#define MAXDRAWTHREADS 8
+#ifdef _MSC_VER
+#define DRAWLOCAL __declspec(thread)
+#else
+#define DRAWLOCAL __thread
+#endif
+#else
+#define DRAWLOCAL
+#endif
 
-extern UINT8 *dc_source; // first pixel in a column
+extern DRAWLOCAL lighttable_t *dc_colormap;
+extern DRAWLOCAL INT32 dc_x, dc_yl, dc_yh;
+extern DRAWLOCAL fixed_t dc_iscale, dc_texturemid;
+extern DRAWLOCAL UINT8 dc_hires;
+
+extern DRAWLOCAL UINT8 *dc_source; // first pixel in a column
 
 // translucency stuff here
 extern UINT8 *transtables; // translucency tables, should be (*transtables)[5][256][256]
-extern UINT8 *dc_transmap;
+extern DRAWLOCAL UINT8 *dc_transmap;
 
 // translation stuff here
 
-extern UINT8 *dc_translation;
+extern DRAWLOCAL UINT8 *dc_translation;
 
 extern struct r_lightlist_s *dc_lightlist;
 extern INT32 dc_numlights, dc_maxlights;
 
 //Fix TUTIFRUTI
-extern INT32 dc_texheight;
+extern DRAWLOCAL INT32 dc_texheight;
 
 // -----------------------
 // SPAN DRAWING CODE STUFF
 // -----------------------
 
-extern INT32 ds_y, ds_x1, ds_x2;
-extern lighttable_t *ds_colormap;
-extern fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
-extern UINT16 ds_flatwidth, ds_flatheight;
-extern boolean ds_powersoftwo;
-extern UINT8 *ds_source;
-extern UINT8 *ds_transmap;
+// Spans can be drawn by several threads too, so these are per thread as well.
+
+extern DRAWLOCAL INT32 ds_y, ds_x1, ds_x2;
+extern DRAWLOCAL lighttable_t *ds_colormap;
+extern DRAWLOCAL fixed_t ds_xfrac, ds_yfrac, ds_xstep, ds_ystep;
+extern DRAWLOCAL UINT16 ds_flatwidth, ds_flatheight;
+extern DRAWLOCAL boolean ds_powersoftwo;
+extern DRAWLOCAL UINT8 *ds_source;
+extern DRAWLOCAL UINT8 *ds_transmap;
+extern DRAWLOCAL fixed_t ds_viewx, ds_viewy, ds_viewz; // viewpoint of the plane being drawn
 
 typedef struct {
 	float x, y, z;
@@ -68,14 +86,15 @@ typedef struct {
 
 extern pslope_t *ds_slope; // Current slope being used
 extern floatv3_t ds_su[MAXVIDHEIGHT], ds_sv[MAXVIDHEIGHT], ds_sz[MAXVIDHEIGHT]; // Vectors for... stuff?
-extern floatv3_t *ds_sup, *ds_svp, *ds_szp;
-extern float focallengthf, zeroheight;
+extern DRAWLOCAL floatv3_t *ds_sup, *ds_svp, *ds_szp;
+extern float focallengthf;
+extern DRAWLOCAL float zeroheight;
 
 // Variable flat sizes
-extern UINT32 nflatxshift;
-extern UINT32 nflatyshift;
-extern UINT32 nflatshiftup;
-extern UINT32 nflatmask;
+extern DRAWLOCAL UINT32 nflatxshift;
+extern DRAWLOCAL UINT32 nflatyshift;
+extern DRAWLOCAL UINT32 nflatshiftup;
+extern DRAWLOCAL UINT32 nflatmask;
 
 /// \brief Top border
 #define BRDR_T 0
@@ -135,6 +154,18 @@ void R_DrawViewBorder(void);
 
 #define TRANSPARENTPIXEL 255
 
+// Threaded drawing
+void R_StartDrawQueue(void);
+void R_FlushDrawQueue(void);
+void R_EndDrawQueue(void);
+void R_QueueSpans(void);
+UINT8 *R_AllocColumnData(size_t size);
+
+// Quad column batching
+void R_StartColumnBatch(void);
+void R_FlushColumnBatch(void);
+void R_EndColumnBatch(void);
+
 // -----------------
 // 8bpp DRAWING CODE
 // -----------------
@@ -149,6 +180,10 @@ void R_Draw2sMultiPatchTranslucentColumn_8(void);
 void R_DrawFogColumn_8(void);
 void R_DrawColumnShadowed_8(void);
 
+void R_DrawColumnQuad_8(void);
+void R_DrawTranslucentColumnQuad_8(void);
+void R_DrawTranslatedColumnQuad_8(void);
+
 void R_DrawSpan_8(void);
 void R_DrawSplat_8(void);
 void R_DrawTranslucentSpan_8(void);
@@ -160,7 +195,9 @@ void R_DrawTiltedTranslucentWaterSpan_8(void);
 #endif
 void R_DrawTiltedSplat_8(void);
 void R_CalcTiltedLighting(fixed_t start, fixed_t end);
-extern INT32 tiltlighting[MAXVIDWIDTH];
+void R_CalcTiltedSpan(void);
+extern DRAWLOCAL INT32 tiltlighting[MAXVIDWIDTH];
+extern DRAWLOCAL UINT32 tiltu[MAXVIDWIDTH], tiltv[MAXVIDWIDTH];
 #ifndef NOWATER
 void R_DrawTranslucentWaterSpan_8(void);
 extern INT32 ds_bgofs;
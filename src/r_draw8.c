@@ -532,6 +532,186 @@ void R_DrawTranslatedColumn_8(void)
 	} while (count--);
 }
 
+// ==========================================================================
+// QUAD COLUMNS
+// ==========================================================================
+
+// Four columns side by side, held back by R_BatchColumn and found in dc_quad.
+// The rows all of them cover are drawn a row at a time, the rest of each
+// column on its own, with the very same texture coordinates as drawing the
+// columns one by one would give.
+
+enum
+{
+	QUAD_BASE,
+	QUAD_TRANSLUCENT,
+	QUAD_TRANSLATED,
+};
+
+typedef struct
+{
+	UINT8 *dest;
+	const UINT8 *source, *transmap, *translation;
+	const lighttable_t *colormap;
+	fixed_t frac, fracstep;
+	INT32 heightmask;
+} quadcolumn_t;
+
+static inline UINT8 R_QuadTexel(const quadcolumn_t *qc, fixed_t frac, UINT8 under, const INT32 kind)
+{
+	UINT8 texel = qc->source[(frac>>FRACBITS) & qc->heightmask];
+
+	switch (kind)
+	{
+		case QUAD_TRANSLUCENT:
+			return *(qc->transmap + (qc->colormap[texel]<<8) + under);
+		case QUAD_TRANSLATED:
+			return qc->colormap[qc->translation[texel]];
+		default:
+			return qc->colormap[texel];
+	}
+}
+
+// Draws the next count rows of one of the columns.
+static inline void R_DrawQuadPart(quadcolumn_t *qc, INT32 count, const INT32 kind)
+{
+	UINT8 *dest = qc->dest;
+	fixed_t frac = qc->frac;
+	const fixed_t fracstep = qc->fracstep;
+
+	for (; count > 0; count--)
+	{
+		*dest = R_QuadTexel(qc, frac, *dest, kind);
+		dest += vid.width;
+		frac += fracstep;
+	}
+
+	qc->dest = dest;
+	qc->frac = frac;
+}
+
+// Textures with heights that aren't powers of two wrap around differently,
+// so those columns are left to the usual drawer.
+static void R_DrawQuadSingly(void (*func)(void))
+{
+	drawcolumn_t savedcol;
+	INT32 i;
+
+	R_SaveColumn(&savedcol);
+	for (i = 0; i < 4; i++)
+	{
+		R_LoadColumn(&dc_quad[i]);
+		func();
+	}
+	R_LoadColumn(&savedcol);
+}
+
+static inline void R_DrawColumnQuad(const INT32 kind)
+{
+	quadcolumn_t qc[4];
+	INT32 top = INT32_MIN, bottom = INT32_MAX;
+	INT32 i, count;
+	UINT8 *dest;
+
+	for (i = 0; i < 4; i++)
+	{
+		const drawcolumn_t *dc = &dc_quad[i];
+
+		if (kind == QUAD_TRANSLATED)
+			qc[i].heightmask = -1; // Sprites don't wrap around
+		else
+		{
+			qc[i].heightmask = dc->texheight - 1;
+			if (dc->texheight & qc[i].heightmask)
+			{
+				R_DrawQuadSingly(kind == QUAD_BASE ? R_DrawColumn_8 : R_DrawTranslucentColumn_8);
+				return;
+			}
+		}
+
+#ifdef RANGECHECK
+		if ((unsigned)dc->x >= (unsigned)vid.width || dc->yl < 0 || dc->yh >= vid.height)
+			I_Error("R_DrawColumnQuad: %d to %d at %d", dc->yl, dc->yh, dc->x);
+#endif
+
+		qc[i].dest = &topleft[dc->yl*vid.width + dc->x];
+		qc[i].source = dc->source;
+		qc[i].transmap = dc->transmap;
+		qc[i].translation = dc->translation;
+		qc[i].colormap = dc->colormap;
+		qc[i].fracstep = dc->iscale;
+		qc[i].frac = (dc->texturemid + FixedMul((dc->yl << FRACBITS) - centeryfrac, dc->iscale))*(!dc->hires);
+
+		top = max(top, dc->yl);
+		bottom = min(bottom, dc->yh);
+	}
+
+	if (top > bottom) // No row in common
+	{
+		for (i = 0; i < 4; i++)
+			R_DrawQuadPart(&qc[i], dc_quad[i].yh - dc_quad[i].yl + 1, kind);
+		return;
+	}
+
+	for (i = 0; i < 4; i++)
+		R_DrawQuadPart(&qc[i], top - dc_quad[i].yl, kind);
+
+	// Now they're all at the top row
+	{
+		const quadcolumn_t *c0 = &qc[0], *c1 = &qc[1], *c2 = &qc[2], *c3 = &qc[3];
+		fixed_t frac0 = c0->frac, frac1 = c1->frac, frac2 = c2->frac, frac3 = c3->frac;
+
+		dest = c0->dest;
+		for (count = bottom - top + 1; count > 0; count--)
+		{
+			dest[0] = R_QuadTexel(c0, frac0, dest[0], kind);
+			dest[1] = R_QuadTexel(c1, frac1, dest[1], kind);
+			dest[2] = R_QuadTexel(c2, frac2, dest[2], kind);
+			dest[3] = R_QuadTexel(c3, frac3, dest[3], kind);
+			dest += vid.width;
+			frac0 += c0->fracstep;
+			frac1 += c1->fracstep;
+			frac2 += c2->fracstep;
+			frac3 += c3->fracstep;
+		}
+
+		qc[0].frac = frac0;
+		qc[1].frac = frac1;
+		qc[2].frac = frac2;
+		qc[3].frac = frac3;
+	}
+
+	for (i = 0; i < 4; i++)
+	{
+		qc[i].dest = dest + i;
+		R_DrawQuadPart(&qc[i], dc_quad[i].yh - bottom, kind);
+	}
+}
+
+/**	\brief The R_DrawColumnQuad_8 function
+	Draws four columns side by side like R_DrawColumn_8 would.
+*/
+void R_DrawColumnQuad_8(void)
+{
+	R_DrawColumnQuad(QUAD_BASE);
+}
+
+/**	\brief The R_DrawTranslucentColumnQuad_8 function
+	Draws four columns side by side like R_DrawTranslucentColumn_8 would.
+*/
+void R_DrawTranslucentColumnQuad_8(void)
+{
+	R_DrawColumnQuad(QUAD_TRANSLUCENT);
+}
+
+/**	\brief The R_DrawTranslatedColumnQuad_8 function
+	Draws four columns side by side like R_DrawTranslatedColumn_8 would.
+*/
+void R_DrawTranslatedColumnQuad_8(void)
+{
+	R_DrawColumnQuad(QUAD_TRANSLATED);
+}
+
 // ==========================================================================
 // SPANS
 // ==========================================================================
@@ -622,19 +802,40 @@ void R_DrawSpan_8 (void)
 
 // R_CalcTiltedLighting
 // Exactly what it says on the tin. I wish I wasn't too lazy to explain things properly.
-INT32 tiltlighting[MAXVIDWIDTH];
+DRAWLOCAL INT32 tiltlighting[MAXVIDWIDTH];
 void R_CalcTiltedLighting(fixed_t start, fixed_t end)
 {
 	// ZDoom uses a different lighting setup to us, and I couldn't figure out how to adapt their version
 	// of this function. Here's my own.
 	INT32 left = ds_x1, right = ds_x2;
 	fixed_t step = (end-start)/(ds_x2-ds_x1+1);
-	INT32 i;
+	INT32 i = left;
 
-	// I wanna do some optimizing by checking for out-of-range segments on either side to fill in all at once,
-	// but I'm too bad at coding to not crash the game trying to do that. I guess this is fast enough for now...
+#ifdef TILTEDSSE2
+	// Four at a time
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i maxlight = _mm_set1_epi32(MAXLIGHTSCALE-1);
+		const __m128i step4 = _mm_set1_epi32((INT32)((UINT32)step*4));
+		__m128i light = _mm_add_epi32(_mm_set1_epi32(start),
+			_mm_set_epi32((INT32)((UINT32)step*4), (INT32)((UINT32)step*3), (INT32)((UINT32)step*2), step));
+		__m128i l, over;
+
+		for (; i + 3 <= right; i += 4)
+		{
+			l = _mm_srai_epi32(light, FRACBITS);
+			l = _mm_andnot_si128(_mm_cmplt_epi32(l, zero), l);
+			over = _mm_cmpgt_epi32(l, maxlight);
+			l = _mm_or_si128(_mm_and_si128(over, maxlight), _mm_andnot_si128(over, l));
+			_mm_storeu_si128((__m128i *)&tiltlighting[i], l);
+			light = _mm_add_epi32(light, step4);
+		}
+
+		start = (fixed_t)((UINT32)start + (UINT32)step*(i - left));
+	}
+#endif
 
-	for (i = left; i <= right; i++) {
+	for (; i <= right; i++) {
 		tiltlighting[i] = (start += step) >> FRACBITS;
 		if (tiltlighting[i] < 0)
 			tiltlighting[i] = 0;
@@ -643,163 +844,63 @@ void R_CalcTiltedLighting(fixed_t start, fixed_t end)
 	}
 }
 
-#define PLANELIGHTFLOAT (BASEVIDWIDTH * BASEVIDWIDTH / vid.width / (zeroheight - FIXED_TO_FLOAT(viewz)) / 21.0f * FIXED_TO_FLOAT(fovtan))
+#define PLANELIGHTFLOAT (BASEVIDWIDTH * BASEVIDWIDTH / vid.width / (zeroheight - FIXED_TO_FLOAT(ds_viewz)) / 21.0f * FIXED_TO_FLOAT(fovtan))
 
-/**	\brief The R_DrawTiltedSpan_8 function
-	Draw slopes! Holy sheit!
-*/
-void R_DrawTiltedSpan_8(void)
-{
-	// x1, x2 = ds_x1, ds_x2
-	int width = ds_x2 - ds_x1;
-	double iz, uz, vz;
-	UINT32 u, v;
-	int i;
-
-	UINT8 *source;
-	UINT8 *colormap;
-	UINT8 *dest;
-
-	double startz, startu, startv;
-	double izstep, uzstep, vzstep;
-	double endz, endu, endv;
-	UINT32 stepu, stepv;
-
-	iz = ds_szp->z + ds_szp->y*(centery-ds_y) + ds_szp->x*(ds_x1-centerx);
-
-	// Lighting is simple. It's just linear interpolation from start to end
-	{
-		float planelightfloat = PLANELIGHTFLOAT;
-		float lightstart, lightend;
+// Texture coordinates of each pixel of the tilted span, ds_viewx/ds_viewy included
+DRAWLOCAL UINT32 tiltu[MAXVIDWIDTH], tiltv[MAXVIDWIDTH];
 
-		lightend = (iz + ds_szp->x*width) * planelightfloat;
-		lightstart = iz * planelightfloat;
-
-		R_CalcTiltedLighting(FLOAT_TO_FIXED(lightstart), FLOAT_TO_FIXED(lightend));
-		//CONS_Printf("tilted lighting %f to %f (foc %f)\n", lightstart, lightend, focallengthf);
-	}
-
-	uz = ds_sup->z + ds_sup->y*(centery-ds_y) + ds_sup->x*(ds_x1-centerx);
-	vz = ds_svp->z + ds_svp->y*(centery-ds_y) + ds_svp->x*(ds_x1-centerx);
-
-	dest = ylookup[ds_y] + columnofs[ds_x1];
-	source = ds_source;
-	//colormap = ds_colormap;
-
-#if 0	// The "perfect" reference version of this routine. Pretty slow.
-		// Use it only to see how things are supposed to look.
-	i = 0;
-	do
+// Steps the texture coordinates linearly from start to end, over count pixels
+static inline void R_StepTiltedSpan(INT32 x, INT32 count, double startu, double startv, double endu, double endv, double scale)
+{
+	UINT32 u = (INT64)(startu) + ds_viewx;
+	UINT32 v = (INT64)(startv) + ds_viewy;
+	UINT32 stepu = (INT64)((endu - startu) * scale);
+	UINT32 stepv = (INT64)((endv - startv) * scale);
+	const INT32 end = x + count;
+
+#ifdef TILTEDSSE2
+	// Four at a time
+	if (count >= 4)
 	{
-		double z = 1.f/iz;
-		u = (INT64)(uz*z) + viewx;
-		v = (INT64)(vz*z) + viewy;
-
-		colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-
-		*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
-		dest++;
-		iz += ds_szp->x;
-		uz += ds_sup->x;
-		vz += ds_svp->x;
-	} while (--width >= 0);
-#else
-#define SPANSIZE 16
-#define INVSPAN	0.0625f
-
-	startz = 1.f/iz;
-	startu = uz*startz;
-	startv = vz*startz;
+		const __m128i stepu4 = _mm_set1_epi32(stepu*4), stepv4 = _mm_set1_epi32(stepv*4);
+		__m128i vu = _mm_add_epi32(_mm_set1_epi32(u), _mm_set_epi32(stepu*3, stepu*2, stepu, 0));
+		__m128i vv = _mm_add_epi32(_mm_set1_epi32(v), _mm_set_epi32(stepv*3, stepv*2, stepv, 0));
 
-	izstep = ds_szp->x * SPANSIZE;
-	uzstep = ds_sup->x * SPANSIZE;
-	vzstep = ds_svp->x * SPANSIZE;
-	//x1 = 0;
-	width++;
-
-	while (width >= SPANSIZE)
-	{
-		iz += izstep;
-		uz += uzstep;
-		vz += vzstep;
-
-		endz = 1.f/iz;
-		endu = uz*endz;
-		endv = vz*endz;
-		stepu = (INT64)((endu - startu) * INVSPAN);
-		stepv = (INT64)((endv - startv) * INVSPAN);
-		u = (INT64)(startu) + viewx;
-		v = (INT64)(startv) + viewy;
-
-		for (i = SPANSIZE-1; i >= 0; i--)
+		for (; x + 4 <= end; x += 4)
 		{
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
-			dest++;
-			u += stepu;
-			v += stepv;
+			_mm_storeu_si128((__m128i *)&tiltu[x], vu);
+			_mm_storeu_si128((__m128i *)&tiltv[x], vv);
+			vu = _mm_add_epi32(vu, stepu4);
+			vv = _mm_add_epi32(vv, stepv4);
 		}
-		startu = endu;
-		startv = endv;
-		width -= SPANSIZE;
-	}
-	if (width > 0)
-	{
-		if (width == 1)
-		{
-			u = (INT64)(startu);
-			v = (INT64)(startv);
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
-		}
-		else
-		{
-			double left = width;
-			iz += ds_szp->x * left;
-			uz += ds_sup->x * left;
-			vz += ds_svp->x * left;
 
-			endz = 1.f/iz;
-			endu = uz*endz;
-			endv = vz*endz;
-			left = 1.f/left;
-			stepu = (INT64)((endu - startu) * left);
-			stepv = (INT64)((endv - startv) * left);
-			u = (INT64)(startu) + viewx;
-			v = (INT64)(startv) + viewy;
-
-			for (; width != 0; width--)
-			{
-				colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-				*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
-				dest++;
-				u += stepu;
-				v += stepv;
-			}
-		}
+		u = (UINT32)_mm_cvtsi128_si32(vu);
+		v = (UINT32)_mm_cvtsi128_si32(vv);
 	}
 #endif
+
+	for (; x < end; x++)
+	{
+		tiltu[x] = u;
+		tiltv[x] = v;
+		u += stepu;
+		v += stepv;
+	}
 }
 
-/**	\brief The R_DrawTiltedTranslucentSpan_8 function
-	Like DrawTiltedSpan, but translucent
+/**	\brief The R_CalcTiltedSpan function
+	Works out the lighting and texture coordinates of every pixel of a
+	tilted span, for the tilted span drawers. The coordinates are
+	perspective correct every cv_slopespansize pixels, and stepped
+	linearly in between.
 */
-void R_DrawTiltedTranslucentSpan_8(void)
+void R_CalcTiltedSpan(void)
 {
 	// x1, x2 = ds_x1, ds_x2
+	INT32 x = ds_x1;
 	int width = ds_x2 - ds_x1;
+	const INT32 size = cv_slopespansize.value;
 	double iz, uz, vz;
-	UINT32 u, v;
-	int i;
-
-	UINT8 *source;
-	UINT8 *colormap;
-	UINT8 *dest;
-
-	double startz, startu, startv;
-	double izstep, uzstep, vzstep;
-	double endz, endu, endv;
-	UINT32 stepu, stepv;
 
 	iz = ds_szp->z + ds_szp->y*(centery-ds_y) + ds_szp->x*(ds_x1-centerx);
 
@@ -818,76 +919,82 @@ void R_DrawTiltedTranslucentSpan_8(void)
 	uz = ds_sup->z + ds_sup->y*(centery-ds_y) + ds_sup->x*(ds_x1-centerx);
 	vz = ds_svp->z + ds_svp->y*(centery-ds_y) + ds_svp->x*(ds_x1-centerx);
 
-	dest = ylookup[ds_y] + columnofs[ds_x1];
-	source = ds_source;
-	//colormap = ds_colormap;
-
 #if 0	// The "perfect" reference version of this routine. Pretty slow.
 		// Use it only to see how things are supposed to look.
-	i = 0;
-	do
+		// (A span size of 1 gives the exact same result.)
+	for (; x <= ds_x2; x++)
 	{
 		double z = 1.f/iz;
-		u = (INT64)(uz*z) + viewx;
-		v = (INT64)(vz*z) + viewy;
-
-		colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-		*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
-		dest++;
+		tiltu[x] = (INT64)(uz*z) + ds_viewx;
+		tiltv[x] = (INT64)(vz*z) + ds_viewy;
 		iz += ds_szp->x;
 		uz += ds_sup->x;
 		vz += ds_svp->x;
-	} while (--width >= 0);
+	}
 #else
-#define SPANSIZE 16
-#define INVSPAN	0.0625f
+	{
+		double startz, startu, startv;
+		double izstep, uzstep, vzstep;
+		double endz, endu, endv;
+		const double invsize = 1.f/size; // exact, the size being a power of two
+
+		startz = 1.f/iz;
+		startu = uz*startz;
+		startv = vz*startz;
+
+		izstep = ds_szp->x * size;
+		uzstep = ds_sup->x * size;
+		vzstep = ds_svp->x * size;
+		width++;
+
+#ifdef TILTEDSSE2
+		// Two perspective divides at once
+		while (width >= size*2)
+		{
+			double izmid = iz + izstep, uzmid = uz + uzstep, vzmid = vz + vzstep;
+			double ends[2][2];
+			__m128d z;
+
+			iz = izmid + izstep;
+			uz = uzmid + uzstep;
+			vz = vzmid + vzstep;
+
+			z = _mm_div_pd(_mm_set1_pd(1.0), _mm_set_pd(iz, izmid));
+			_mm_storeu_pd(ends[0], _mm_mul_pd(_mm_set_pd(uz, uzmid), z));
+			_mm_storeu_pd(ends[1], _mm_mul_pd(_mm_set_pd(vz, vzmid), z));
+
+			R_StepTiltedSpan(x, size, startu, startv, ends[0][0], ends[1][0], invsize);
+			R_StepTiltedSpan(x + size, size, ends[0][0], ends[1][0], ends[0][1], ends[1][1], invsize);
+			x += size*2;
+			startu = ends[0][1];
+			startv = ends[1][1];
+			width -= size*2;
+		}
+#endif
 
-	startz = 1.f/iz;
-	startu = uz*startz;
-	startv = vz*startz;
+		while (width >= size)
+		{
+			iz += izstep;
+			uz += uzstep;
+			vz += vzstep;
 
-	izstep = ds_szp->x * SPANSIZE;
-	uzstep = ds_sup->x * SPANSIZE;
-	vzstep = ds_svp->x * SPANSIZE;
-	//x1 = 0;
-	width++;
+			endz = 1.f/iz;
+			endu = uz*endz;
+			endv = vz*endz;
 
-	while (width >= SPANSIZE)
-	{
-		iz += izstep;
-		uz += uzstep;
-		vz += vzstep;
-
-		endz = 1.f/iz;
-		endu = uz*endz;
-		endv = vz*endz;
-		stepu = (INT64)((endu - startu) * INVSPAN);
-		stepv = (INT64)((endv - startv) * INVSPAN);
-		u = (INT64)(startu) + viewx;
-		v = (INT64)(startv) + viewy;
-
-		for (i = SPANSIZE-1; i >= 0; i--)
-		{
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
-			dest++;
-			u += stepu;
-			v += stepv;
+			R_StepTiltedSpan(x, size, startu, startv, endu, endv, invsize);
+			x += size;
+			startu = endu;
+			startv = endv;
+			width -= size;
 		}
-		startu = endu;
-		startv = endv;
-		width -= SPANSIZE;
-	}
-	if (width > 0)
-	{
+
 		if (width == 1)
 		{
-			u = (INT64)(startu);
-			v = (INT64)(startv);
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
+			tiltu[x] = (INT64)(startu) + ds_viewx;
+			tiltv[x] = (INT64)(startv) + ds_viewy;
 		}
-		else
+		else if (width > 1)
 		{
 			double left = width;
 			iz += ds_szp->x * left;
@@ -897,306 +1004,102 @@ void R_DrawTiltedTranslucentSpan_8(void)
 			endz = 1.f/iz;
 			endu = uz*endz;
 			endv = vz*endz;
-			left = 1.f/left;
-			stepu = (INT64)((endu - startu) * left);
-			stepv = (INT64)((endv - startv) * left);
-			u = (INT64)(startu) + viewx;
-			v = (INT64)(startv) + viewy;
 
-			for (; width != 0; width--)
-			{
-				colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-				*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
-				dest++;
-				u += stepu;
-				v += stepv;
-			}
+			R_StepTiltedSpan(x, width, startu, startv, endu, endv, 1.f/left);
 		}
 	}
 #endif
 }
 
-#ifndef NOWATER
-/**	\brief The R_DrawTiltedTranslucentWaterSpan_8 function
-	Like DrawTiltedTranslucentSpan, but for water
+/**	\brief The R_DrawTiltedSpan_8 function
+	Draw slopes! Holy sheit!
 */
-void R_DrawTiltedTranslucentWaterSpan_8(void)
+void R_DrawTiltedSpan_8(void)
 {
-	// x1, x2 = ds_x1, ds_x2
-	int width = ds_x2 - ds_x1;
-	double iz, uz, vz;
-	UINT32 u, v;
-	int i;
-
-	UINT8 *source;
+	INT32 x;
+	UINT8 *source = ds_source;
+	lighttable_t **planelight = planezlight;
+	const size_t cmapofs = ds_colormap - colormaps;
+	const UINT32 xshift = nflatxshift, yshift = nflatyshift, mask = nflatmask;
 	UINT8 *colormap;
-	UINT8 *dest;
-	UINT8 *dsrc;
+	UINT8 *dest = ylookup[ds_y] + columnofs[ds_x1];
 
-	double startz, startu, startv;
-	double izstep, uzstep, vzstep;
-	double endz, endu, endv;
-	UINT32 stepu, stepv;
+	R_CalcTiltedSpan();
 
-	iz = ds_szp->z + ds_szp->y*(centery-ds_y) + ds_szp->x*(ds_x1-centerx);
-
-	// Lighting is simple. It's just linear interpolation from start to end
+	for (x = ds_x1; x <= ds_x2; x++)
 	{
-		float planelightfloat = PLANELIGHTFLOAT;
-		float lightstart, lightend;
-
-		lightend = (iz + ds_szp->x*width) * planelightfloat;
-		lightstart = iz * planelightfloat;
-
-		R_CalcTiltedLighting(FLOAT_TO_FIXED(lightstart), FLOAT_TO_FIXED(lightend));
-		//CONS_Printf("tilted lighting %f to %f (foc %f)\n", lightstart, lightend, focallengthf);
+		colormap = planelight[tiltlighting[x]] + cmapofs;
+		*dest++ = colormap[source[((tiltv[x] >> yshift) & mask) | (tiltu[x] >> xshift)]];
 	}
+}
 
-	uz = ds_sup->z + ds_sup->y*(centery-ds_y) + ds_sup->x*(ds_x1-centerx);
-	vz = ds_svp->z + ds_svp->y*(centery-ds_y) + ds_svp->x*(ds_x1-centerx);
+/**	\brief The R_DrawTiltedTranslucentSpan_8 function
+	Like DrawTiltedSpan, but translucent
+*/
+void R_DrawTiltedTranslucentSpan_8(void)
+{
+	INT32 x;
+	UINT8 *source = ds_source;
+	lighttable_t **planelight = planezlight;
+	const size_t cmapofs = ds_colormap - colormaps;
+	const UINT32 xshift = nflatxshift, yshift = nflatyshift, mask = nflatmask;
+	UINT8 *colormap;
+	UINT8 *dest = ylookup[ds_y] + columnofs[ds_x1];
 
-	dest = ylookup[ds_y] + columnofs[ds_x1];
-	dsrc = screens[1] + (ds_y+ds_bgofs)*vid.width + ds_x1;
-	source = ds_source;
-	//colormap = ds_colormap;
+	R_CalcTiltedSpan();
 
-#if 0	// The "perfect" reference version of this routine. Pretty slow.
-		// Use it only to see how things are supposed to look.
-	i = 0;
-	do
+	for (x = ds_x1; x <= ds_x2; x++, dest++)
 	{
-		double z = 1.f/iz;
-		u = (INT64)(uz*z) + viewx;
-		v = (INT64)(vz*z) + viewy;
-
-		colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-		*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dsrc++);
-		dest++;
-		iz += ds_szp->x;
-		uz += ds_sup->x;
-		vz += ds_svp->x;
-	} while (--width >= 0);
-#else
-#define SPANSIZE 16
-#define INVSPAN	0.0625f
+		colormap = planelight[tiltlighting[x]] + cmapofs;
+		*dest = *(ds_transmap + (colormap[source[((tiltv[x] >> yshift) & mask) | (tiltu[x] >> xshift)]] << 8) + *dest);
+	}
+}
 
-	startz = 1.f/iz;
-	startu = uz*startz;
-	startv = vz*startz;
+#ifndef NOWATER
+/**	\brief The R_DrawTiltedTranslucentWaterSpan_8 function
+	Like DrawTiltedTranslucentSpan, but for water
+*/
+void R_DrawTiltedTranslucentWaterSpan_8(void)
+{
+	INT32 x;
+	UINT8 *source = ds_source;
+	lighttable_t **planelight = planezlight;
+	const size_t cmapofs = ds_colormap - colormaps;
+	const UINT32 xshift = nflatxshift, yshift = nflatyshift, mask = nflatmask;
+	UINT8 *colormap;
+	UINT8 *dest = ylookup[ds_y] + columnofs[ds_x1];
+	UINT8 *dsrc = screens[1] + (ds_y+ds_bgofs)*vid.width + ds_x1;
 
-	izstep = ds_szp->x * SPANSIZE;
-	uzstep = ds_sup->x * SPANSIZE;
-	vzstep = ds_svp->x * SPANSIZE;
-	//x1 = 0;
-	width++;
+	R_CalcTiltedSpan();
 
-	while (width >= SPANSIZE)
-	{
-		iz += izstep;
-		uz += uzstep;
-		vz += vzstep;
-
-		endz = 1.f/iz;
-		endu = uz*endz;
-		endv = vz*endz;
-		stepu = (INT64)((endu - startu) * INVSPAN);
-		stepv = (INT64)((endv - startv) * INVSPAN);
-		u = (INT64)(startu) + viewx;
-		v = (INT64)(startv) + viewy;
-
-		for (i = SPANSIZE-1; i >= 0; i--)
-		{
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dsrc++);
-			dest++;
-			u += stepu;
-			v += stepv;
-		}
-		startu = endu;
-		startv = endv;
-		width -= SPANSIZE;
-	}
-	if (width > 0)
+	for (x = ds_x1; x <= ds_x2; x++)
 	{
-		if (width == 1)
-		{
-			u = (INT64)(startu);
-			v = (INT64)(startv);
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dsrc++);
-		}
-		else
-		{
-			double left = width;
-			iz += ds_szp->x * left;
-			uz += ds_sup->x * left;
-			vz += ds_svp->x * left;
-
-			endz = 1.f/iz;
-			endu = uz*endz;
-			endv = vz*endz;
-			left = 1.f/left;
-			stepu = (INT64)((endu - startu) * left);
-			stepv = (INT64)((endv - startv) * left);
-			u = (INT64)(startu) + viewx;
-			v = (INT64)(startv) + viewy;
-
-			for (; width != 0; width--)
-			{
-				colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-				*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dsrc++);
-				dest++;
-				u += stepu;
-				v += stepv;
-			}
-		}
+		colormap = planelight[tiltlighting[x]] + cmapofs;
+		*dest++ = *(ds_transmap + (colormap[source[((tiltv[x] >> yshift) & mask) | (tiltu[x] >> xshift)]] << 8) + *dsrc++);
 	}
-#endif
 }
 #endif // NOWATER
 
 void R_DrawTiltedSplat_8(void)
 {
-	// x1, x2 = ds_x1, ds_x2
-	int width = ds_x2 - ds_x1;
-	double iz, uz, vz;
-	UINT32 u, v;
-	int i;
-
-	UINT8 *source;
+	INT32 x;
+	UINT8 *source = ds_source;
+	lighttable_t **planelight = planezlight;
+	const size_t cmapofs = ds_colormap - colormaps;
+	const UINT32 xshift = nflatxshift, yshift = nflatyshift, mask = nflatmask;
 	UINT8 *colormap;
-	UINT8 *dest;
-
+	UINT8 *dest = ylookup[ds_y] + columnofs[ds_x1];
 	UINT8 val;
 
-	double startz, startu, startv;
-	double izstep, uzstep, vzstep;
-	double endz, endu, endv;
-	UINT32 stepu, stepv;
-
-	iz = ds_szp->z + ds_szp->y*(centery-ds_y) + ds_szp->x*(ds_x1-centerx);
-
-	// Lighting is simple. It's just linear interpolation from start to end
-	{
-		float planelightfloat = PLANELIGHTFLOAT;
-		float lightstart, lightend;
-
-		lightend = (iz + ds_szp->x*width) * planelightfloat;
-		lightstart = iz * planelightfloat;
-
-		R_CalcTiltedLighting(FLOAT_TO_FIXED(lightstart), FLOAT_TO_FIXED(lightend));
-		//CONS_Printf("tilted lighting %f to %f (foc %f)\n", lightstart, lightend, focallengthf);
-	}
-
-	uz = ds_sup->z + ds_sup->y*(centery-ds_y) + ds_sup->x*(ds_x1-centerx);
-	vz = ds_svp->z + ds_svp->y*(centery-ds_y) + ds_svp->x*(ds_x1-centerx);
-
-	dest = ylookup[ds_y] + columnofs[ds_x1];
-	source = ds_source;
-	//colormap = ds_colormap;
+	R_CalcTiltedSpan();
 
-#if 0	// The "perfect" reference version of this routine. Pretty slow.
-		// Use it only to see how things are supposed to look.
-	i = 0;
-	do
+	for (x = ds_x1; x <= ds_x2; x++, dest++)
 	{
-		double z = 1.f/iz;
-		u = (INT64)(uz*z) + viewx;
-		v = (INT64)(vz*z) + viewy;
-
-		colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-
-		val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
+		colormap = planelight[tiltlighting[x]] + cmapofs;
+		val = source[((tiltv[x] >> yshift) & mask) | (tiltu[x] >> xshift)];
 		if (val != TRANSPARENTPIXEL)
 			*dest = colormap[val];
-
-		dest++;
-		iz += ds_szp->x;
-		uz += ds_sup->x;
-		vz += ds_svp->x;
-	} while (--width >= 0);
-#else
-#define SPANSIZE 16
-#define INVSPAN	0.0625f
-
-	startz = 1.f/iz;
-	startu = uz*startz;
-	startv = vz*startz;
-
-	izstep = ds_szp->x * SPANSIZE;
-	uzstep = ds_sup->x * SPANSIZE;
-	vzstep = ds_svp->x * SPANSIZE;
-	//x1 = 0;
-	width++;
-
-	while (width >= SPANSIZE)
-	{
-		iz += izstep;
-		uz += uzstep;
-		vz += vzstep;
-
-		endz = 1.f/iz;
-		endu = uz*endz;
-		endv = vz*endz;
-		stepu = (INT64)((endu - startu) * INVSPAN);
-		stepv = (INT64)((endv - startv) * INVSPAN);
-		u = (INT64)(startu) + viewx;
-		v = (INT64)(startv) + viewy;
-
-		for (i = SPANSIZE-1; i >= 0; i--)
-		{
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
-			if (val != TRANSPARENTPIXEL)
-				*dest = colormap[val];
-			dest++;
-			u += stepu;
-			v += stepv;
-		}
-		startu = endu;
-		startv = endv;
-		width -= SPANSIZE;
 	}
-	if (width > 0)
-	{
-		if (width == 1)
-		{
-			u = (INT64)(startu);
-			v = (INT64)(startv);
-			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-			val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
-			if (val != TRANSPARENTPIXEL)
-				*dest = colormap[val];
-		}
-		else
-		{
-			double left = width;
-			iz += ds_szp->x * left;
-			uz += ds_sup->x * left;
-			vz += ds_svp->x * left;
-
-			endz = 1.f/iz;
-			endu = uz*endz;
-			endv = vz*endz;
-			left = 1.f/left;
-			stepu = (INT64)((endu - startu) * left);
-			stepv = (INT64)((endv - startv) * left);
-			u = (INT64)(startu) + viewx;
-			v = (INT64)(startv) + viewy;
-
-			for (; width != 0; width--)
-			{
-				colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
-				val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
-				if (val != TRANSPARENTPIXEL)
-					*dest = colormap[val];
-				dest++;
-				u += stepu;
-				v += stepv;
-			}
-		}
-	}
-#endif
 }
 
 /**	\brief The R_DrawSplat_8 function
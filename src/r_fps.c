@@ -0,0 +1,279 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 1993-1996 by id Software, Inc.
+// Copyright (C) 1998-2000 by DooM Legacy Team.
+// Copyright (C) 1999-2020 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  r_fps.c
+/// \brief Frame interpolation, for drawing more frames than there are tics.
+///
+/// The game still runs at TICRATE. At the start of each tic, P_Ticker has
+/// everything that moves remember where it is (see R_StartInterpolationTic),
+/// and the frames drawn until the next tic show everything somewhere between
+/// there and where the tic left it, rendertimefrac of the way. This puts
+/// the view one tic behind the game, which is the price for smooth motion.
+
+#include "doomdef.h"
+#include "doomstat.h"
+#include "d_clisrv.h" // dedicated
+#include "g_game.h"
+#include "r_fps.h"
+#include "r_main.h"
+#include "p_tick.h"
+#include "p_polyobj.h"
+#include "z_zone.h"
+
+static void FPSCap_OnChange(void);
+
+static CV_PossibleValue_t fpscap_cons_t[] = {{TICRATE, "MIN"}, {1000, "MAX"}, {0, "Unlimited"}, {0, NULL}};
+consvar_t cv_fpscap = {"fpscap", "35", CV_SAVE|CV_CALL|CV_NOINIT, fpscap_cons_t, FPSCap_OnChange, 0, NULL, NULL, 0, 0, NULL};
+
+fixed_t rendertimefrac = FRACUNIT;
+
+// Where the sector planes and polyobject vertices were at the start of the
+// tic, and where they really are while a frame is drawn
+static fixed_t *oldsectorheights, *cursectorheights; // floor and ceiling of each sector
+static size_t numinterpsectors;
+static fixed_t *oldpolyverts, *curpolyverts; // x and y of each vertex of each polyobject
+static size_t numinterppolyverts;
+static boolean levelinterpolated;
+
+/** Gets the most frames that may be drawn each second.
+  *
+  * \return The cap, or 0 if there is none.
+  */
+UINT32 R_GetFramerateCap(void)
+{
+	return cv_fpscap.value;
+}
+
+/** Checks whether frames are drawn in between tics.
+  */
+boolean R_UsingFrameInterpolation(void)
+{
+	return (R_GetFramerateCap() != TICRATE && !dedicated && !singletics);
+}
+
+/** Goes from one value to another, by rendertimefrac.
+  */
+fixed_t R_InterpolateFixed(fixed_t from, fixed_t to)
+{
+	if (rendertimefrac >= FRACUNIT)
+		return to;
+	return from + FixedMul(rendertimefrac, to - from);
+}
+
+/** Turns from one angle to another the short way, by rendertimefrac.
+  */
+angle_t R_InterpolateAngle(angle_t from, angle_t to)
+{
+	if (rendertimefrac >= FRACUNIT)
+		return to;
+	return from + (angle_t)FixedMul(rendertimefrac, (INT32)(to - from));
+}
+
+void R_InterpolateMobjState(mobj_t *mobj, interpmobjstate_t *out)
+{
+	// Not in the thinker list, so R_StartInterpolationTic never sees it
+	if (mobj->flags & MF_NOTHINK)
+	{
+		out->x = mobj->x;
+		out->y = mobj->y;
+		out->z = mobj->z;
+		out->angle = mobj->angle;
+		return;
+	}
+
+	out->x = R_InterpolateFixed(mobj->old_x, mobj->x);
+	out->y = R_InterpolateFixed(mobj->old_y, mobj->y);
+	out->z = R_InterpolateFixed(mobj->old_z, mobj->z);
+	out->angle = R_InterpolateAngle(mobj->old_angle, mobj->angle);
+}
+
+void R_InterpolatePrecipMobjState(precipmobj_t *mobj, interpmobjstate_t *out)
+{
+	out->x = R_InterpolateFixed(mobj->old_x, mobj->x);
+	out->y = R_InterpolateFixed(mobj->old_y, mobj->y);
+	out->z = R_InterpolateFixed(mobj->old_z, mobj->z);
+	out->angle = R_InterpolateAngle(mobj->old_angle, mobj->angle);
+}
+
+void R_ResetMobjInterpolationState(mobj_t *mobj)
+{
+	mobj->old_x = mobj->x;
+	mobj->old_y = mobj->y;
+	mobj->old_z = mobj->z;
+	mobj->old_angle = mobj->angle;
+
+	if (mobj->player)
+	{
+		mobj->player->old_viewz = mobj->player->viewz;
+		mobj->player->old_drawangle = mobj->player->drawangle;
+	}
+}
+
+void R_ResetPrecipitationMobjInterpolationState(precipmobj_t *mobj)
+{
+	mobj->old_x = mobj->x;
+	mobj->old_y = mobj->y;
+	mobj->old_z = mobj->z;
+	mobj->old_angle = mobj->angle;
+}
+
+void R_ResetCameraInterpolationState(camera_t *thiscam)
+{
+	thiscam->old_x = thiscam->x;
+	thiscam->old_y = thiscam->y;
+	thiscam->old_z = thiscam->z;
+	thiscam->old_angle = thiscam->angle;
+	thiscam->old_aiming = thiscam->aiming;
+}
+
+static void R_StartLevelInterpolationTic(void)
+{
+	size_t i, j, v;
+
+	// The level's memory goes away with it, which clears these
+	if (!oldsectorheights || numinterpsectors != numsectors)
+	{
+		numinterpsectors = numsectors;
+		Z_Malloc(numsectors * 2 * sizeof (fixed_t), PU_LEVEL, &oldsectorheights);
+		Z_Malloc(numsectors * 2 * sizeof (fixed_t), PU_LEVEL, &cursectorheights);
+	}
+
+	for (i = 0; i < numsectors; i++)
+	{
+		oldsectorheights[i*2] = sectors[i].floorheight;
+		oldsectorheights[i*2 + 1] = sectors[i].ceilingheight;
+	}
+
+	for (v = 0, i = 0; i < (size_t)numPolyObjects; i++)
+		v += PolyObjects[i].numVertices;
+
+	if (!v)
+		numinterppolyverts = 0;
+	else
+	{
+		if (!oldpolyverts || numinterppolyverts != v)
+		{
+			numinterppolyverts = v;
+			Z_Malloc(v * 2 * sizeof (fixed_t), PU_LEVEL, &oldpolyverts);
+			Z_Malloc(v * 2 * sizeof (fixed_t), PU_LEVEL, &curpolyverts);
+		}
+
+		for (v = 0, i = 0; i < (size_t)numPolyObjects; i++)
+			for (j = 0; j < PolyObjects[i].numVertices; j++, v += 2)
+			{
+				oldpolyverts[v] = PolyObjects[i].vertices[j]->x;
+				oldpolyverts[v + 1] = PolyObjects[i].vertices[j]->y;
+			}
+	}
+}
+
+/** Remembers where everything that moves is, before the tic moves it.
+  * Called by P_Ticker, even when the game is paused so that nothing keeps
+  * sliding about.
+  */
+void R_StartInterpolationTic(void)
+{
+	thinker_t *th;
+	INT32 i;
+
+	if (!R_UsingFrameInterpolation())
+		return;
+
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		if (th->function.acp1 != (actionf_p1)P_RemoveThinkerDelayed)
+			R_ResetMobjInterpolationState((mobj_t *)th);
+
+	for (i = 0; i < MAXPLAYERS; i++)
+		if (playeringame[i])
+		{
+			players[i].old_viewz = players[i].viewz;
+			players[i].old_drawangle = players[i].drawangle;
+		}
+
+	R_ResetCameraInterpolationState(&camera);
+	R_ResetCameraInterpolationState(&camera2);
+
+	R_StartLevelInterpolationTic();
+}
+
+// Turning the interpolation on halfway through a tic starts it from there
+static void FPSCap_OnChange(void)
+{
+	if (gamestate == GS_LEVEL || gamestate == GS_TITLESCREEN)
+		R_StartInterpolationTic();
+}
+
+/** Moves the sector planes and polyobjects to where they are in the frame
+  * being drawn. Nothing but drawing may happen until they are put back.
+  *
+  * \sa R_RestoreLevelInterpolators
+  */
+void R_ApplyLevelInterpolators(void)
+{
+	size_t i, j, v;
+
+	if (!R_UsingFrameInterpolation() || !oldsectorheights || numinterpsectors != numsectors)
+		return;
+
+	for (i = 0; i < numsectors; i++)
+	{
+		sector_t *sec = &sectors[i];
+
+		cursectorheights[i*2] = sec->floorheight;
+		cursectorheights[i*2 + 1] = sec->ceilingheight;
+		sec->floorheight = R_InterpolateFixed(oldsectorheights[i*2], sec->floorheight);
+		sec->ceilingheight = R_InterpolateFixed(oldsectorheights[i*2 + 1], sec->ceilingheight);
+	}
+
+	if (oldpolyverts && numinterppolyverts)
+	{
+		for (v = 0, i = 0; i < (size_t)numPolyObjects; i++)
+			for (j = 0; j < PolyObjects[i].numVertices; j++, v += 2)
+			{
+				vertex_t *vert = PolyObjects[i].vertices[j];
+
+				curpolyverts[v] = vert->x;
+				curpolyverts[v + 1] = vert->y;
+				vert->x = R_InterpolateFixed(oldpolyverts[v], vert->x);
+				vert->y = R_InterpolateFixed(oldpolyverts[v + 1], vert->y);
+			}
+	}
+
+	levelinterpolated = true;
+}
+
+/** Puts the sector planes and polyobjects back where the game has them.
+  *
+  * \sa R_ApplyLevelInterpolators
+  */
+void R_RestoreLevelInterpolators(void)
+{
+	size_t i, j, v;
+
+	if (!levelinterpolated)
+		return;
+	levelinterpolated = false;
+
+	for (i = 0; i < numsectors; i++)
+	{
+		sectors[i].floorheight = cursectorheights[i*2];
+		sectors[i].ceilingheight = cursectorheights[i*2 + 1];
+	}
+
+	if (oldpolyverts && numinterppolyverts)
+	{
+		for (v = 0, i = 0; i < (size_t)numPolyObjects; i++)
+			for (j = 0; j < PolyObjects[i].numVertices; j++, v += 2)
+			{
+				PolyObjects[i].vertices[j]->x = curpolyverts[v];
+				PolyObjects[i].vertices[j]->y = curpolyverts[v + 1];
+			}
+	}
+}
@@ -0,0 +1,56 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 1993-1996 by id Software, Inc.
+// Copyright (C) 1998-2000 by DooM Legacy Team.
+// Copyright (C) 1999-2020 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  r_fps.h
+/// \brief Frame interpolation, for drawing more frames than there are tics.
+
+#ifndef __R_FPS__
+#define __R_FPS__
+
+#include "m_fixed.h"
+#include "p_local.h"
+#include "command.h"
+
+extern consvar_t cv_fpscap;
+
+/** How far the frame being drawn is between the start of the current tic
+  * and its end, where everything is at the moment. Always FRACUNIT when
+  * frames aren't interpolated.
+  */
+extern fixed_t rendertimefrac;
+
+UINT32 R_GetFramerateCap(void);
+boolean R_UsingFrameInterpolation(void);
+
+fixed_t R_InterpolateFixed(fixed_t from, fixed_t to);
+angle_t R_InterpolateAngle(angle_t from, angle_t to);
+
+/** Where a mobj is drawn, between its position at the start of the tic
+  * and its current one.
+  */
+typedef struct
+{
+	fixed_t x, y, z;
+	angle_t angle;
+} interpmobjstate_t;
+
+void R_InterpolateMobjState(mobj_t *mobj, interpmobjstate_t *out);
+void R_InterpolatePrecipMobjState(precipmobj_t *mobj, interpmobjstate_t *out);
+
+// Forget where something was, so that it doesn't glide over from there
+void R_ResetMobjInterpolationState(mobj_t *mobj);
+void R_ResetPrecipitationMobjInterpolationState(precipmobj_t *mobj);
+void R_ResetCameraInterpolationState(camera_t *thiscam);
+
+void R_StartInterpolationTic(void);
+void R_ApplyLevelInterpolators(void);
+void R_RestoreLevelInterpolators(void);
+
+#endif
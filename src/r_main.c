@@ -33,8 +33,10 @@
 #include "z_zone.h"
 #include "m_random.h" // quake camera shake
 #include "r_portal.h"
+#include "r_fps.h"
 #include "r_main.h"
 #include "i_system.h" // I_GetTimeMicros
+#include "m_trace.h"
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -111,6 +113,7 @@ int rs_bsptime = 0;
 int rs_sw_portaltime = 0;
 int rs_sw_planetime = 0;
 int rs_sw_maskedtime = 0;
+int rs_sw_spritesorttime = 0;
 
 int rs_numbspcalls = 0;
 int rs_numsprites = 0;
@@ -169,6 +172,16 @@ consvar_t cv_maxportals = {"maxportals", "2", CV_SAVE, maxportals_cons_t, NULL,
 
 consvar_t cv_renderstats = {"renderstats", "Off", 0, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
 
+#ifdef DRAWTHREADS
+// Threads drawing the view, see R_FlushDrawQueue
+static CV_PossibleValue_t renderthreads_cons_t[] = {{1, "MIN"}, {MAXDRAWTHREADS, "MAX"}, {0, NULL}};
+consvar_t cv_renderthreads = {"renderthreads", "1", CV_SAVE, renderthreads_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+#endif
+
+// Pixels between each perspective correction on slopes, see R_CalcTiltedSpan
+static CV_PossibleValue_t slopespansize_cons_t[] = {{1, "1"}, {2, "2"}, {4, "4"}, {8, "8"}, {16, "16"}, {32, "32"}, {0, NULL}};
+consvar_t cv_slopespansize = {"slopespansize", "16", CV_SAVE, slopespansize_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+
 void SplitScreen_OnChange(void)
 {
 	if (!cv_debug && netgame)
@@ -1112,6 +1125,7 @@ void R_SetupFrame(player_t *player)
 {
 	camera_t *thiscam;
 	boolean chasecam = false;
+	interpmobjstate_t viewmobjstate;
 
 	if (splitscreen && player == &players[secondarydisplayplayer]
 		&& player != &players[consoleplayer])
@@ -1143,28 +1157,30 @@ void R_SetupFrame(player_t *player)
 		// cut-away view stuff
 		r_viewmobj = player->awayviewmobj; // should be a MT_ALTVIEWMAN
 		I_Assert(r_viewmobj != NULL);
-		viewz = r_viewmobj->z + 20*FRACUNIT;
+		R_InterpolateMobjState(r_viewmobj, &viewmobjstate);
+		viewz = viewmobjstate.z + 20*FRACUNIT;
 		aimingangle = player->awayviewaiming;
-		viewangle = r_viewmobj->angle;
+		viewangle = viewmobjstate.angle;
 	}
 	else if (!player->spectator && chasecam)
 	// use outside cam view
 	{
 		r_viewmobj = NULL;
-		viewz = thiscam->z + (thiscam->height>>1);
-		aimingangle = thiscam->aiming;
-		viewangle = thiscam->angle;
+		viewz = R_InterpolateFixed(thiscam->old_z, thiscam->z) + (thiscam->height>>1);
+		aimingangle = R_InterpolateAngle(thiscam->old_aiming, thiscam->aiming);
+		viewangle = R_InterpolateAngle(thiscam->old_angle, thiscam->angle);
 	}
 	else
 	// use the player's eyes view
 	{
-		viewz = player->viewz;
+		viewz = R_InterpolateFixed(player->old_viewz, player->viewz);
 
 		r_viewmobj = player->mo;
 		I_Assert(r_viewmobj != NULL);
+		R_InterpolateMobjState(r_viewmobj, &viewmobjstate);
 
 		aimingangle = player->aiming;
-		viewangle = r_viewmobj->angle;
+		viewangle = viewmobjstate.angle;
 
 		if (!demoplayback && player->playerstate != PST_DEAD)
 		{
@@ -1186,24 +1202,24 @@ void R_SetupFrame(player_t *player)
 
 	if (chasecam && !player->awayviewtics && !player->spectator)
 	{
-		viewx = thiscam->x;
-		viewy = thiscam->y;
+		viewx = R_InterpolateFixed(thiscam->old_x, thiscam->x);
+		viewy = R_InterpolateFixed(thiscam->old_y, thiscam->y);
 		viewx += quake.x;
 		viewy += quake.y;
 
-		if (thiscam->subsector)
+		if (thiscam->subsector && rendertimefrac >= FRACUNIT)
 			viewsector = thiscam->subsector->sector;
 		else
 			viewsector = R_PointInSubsector(viewx, viewy)->sector;
 	}
 	else
 	{
-		viewx = r_viewmobj->x;
-		viewy = r_viewmobj->y;
+		viewx = viewmobjstate.x;
+		viewy = viewmobjstate.y;
 		viewx += quake.x;
 		viewy += quake.y;
 
-		if (r_viewmobj->subsector)
+		if (r_viewmobj->subsector && rendertimefrac >= FRACUNIT)
 			viewsector = r_viewmobj->subsector->sector;
 		else
 			viewsector = R_PointInSubsector(viewx, viewy)->sector;
@@ -1218,6 +1234,7 @@ void R_SetupFrame(player_t *player)
 void R_SkyboxFrame(player_t *player)
 {
 	camera_t *thiscam;
+	interpmobjstate_t skyboxstate, viewpointstate;
 
 	if (splitscreen && player == &players[secondarydisplayplayer]
 	&& player != &players[consoleplayer])
@@ -1234,20 +1251,24 @@ void R_SkyboxFrame(player_t *player)
 		I_Error("R_SkyboxFrame: r_viewmobj null (player %s)", sizeu1(playeri));
 	}
 #endif
+	R_InterpolateMobjState(r_viewmobj, &skyboxstate);
+
 	if (player->awayviewtics)
 	{
+		R_InterpolateMobjState(player->awayviewmobj, &viewpointstate);
 		aimingangle = player->awayviewaiming;
-		viewangle = player->awayviewmobj->angle;
+		viewangle = viewpointstate.angle;
 	}
 	else if (thiscam->chase)
 	{
-		aimingangle = thiscam->aiming;
-		viewangle = thiscam->angle;
+		aimingangle = R_InterpolateAngle(thiscam->old_aiming, thiscam->aiming);
+		viewangle = R_InterpolateAngle(thiscam->old_angle, thiscam->angle);
 	}
 	else
 	{
+		R_InterpolateMobjState(player->mo, &viewpointstate);
 		aimingangle = player->aiming;
-		viewangle = player->mo->angle;
+		viewangle = viewpointstate.angle;
 		if (!demoplayback && player->playerstate != PST_DEAD)
 		{
 			if (player == &players[consoleplayer])
@@ -1266,9 +1287,9 @@ void R_SkyboxFrame(player_t *player)
 
 	viewplayer = player;
 
-	viewx = r_viewmobj->x;
-	viewy = r_viewmobj->y;
-	viewz = r_viewmobj->z; // 26/04/17: use actual Z position instead of spawnpoint angle!
+	viewx = skyboxstate.x;
+	viewy = skyboxstate.y;
+	viewz = skyboxstate.z; // 26/04/17: use actual Z position instead of spawnpoint angle!
 
 	if (mapheaderinfo[gamemap-1])
 	{
@@ -1276,17 +1297,17 @@ void R_SkyboxFrame(player_t *player)
 		vector3_t campos = {0,0,0}; // Position of player's actual view point
 
 		if (player->awayviewtics) {
-			campos.x = player->awayviewmobj->x;
-			campos.y = player->awayviewmobj->y;
-			campos.z = player->awayviewmobj->z + 20*FRACUNIT;
+			campos.x = viewpointstate.x;
+			campos.y = viewpointstate.y;
+			campos.z = viewpointstate.z + 20*FRACUNIT;
 		} else if (thiscam->chase) {
-			campos.x = thiscam->x;
-			campos.y = thiscam->y;
-			campos.z = thiscam->z + (thiscam->height>>1);
+			campos.x = R_InterpolateFixed(thiscam->old_x, thiscam->x);
+			campos.y = R_InterpolateFixed(thiscam->old_y, thiscam->y);
+			campos.z = R_InterpolateFixed(thiscam->old_z, thiscam->z) + (thiscam->height>>1);
 		} else {
-			campos.x = player->mo->x;
-			campos.y = player->mo->y;
-			campos.z = player->viewz;
+			campos.x = viewpointstate.x;
+			campos.y = viewpointstate.y;
+			campos.z = R_InterpolateFixed(player->old_viewz, player->viewz);
 		}
 
 		// Earthquake effects should be scaled in the skybox
@@ -1341,7 +1362,7 @@ void R_SkyboxFrame(player_t *player)
 			viewz += campos.z * -mh->skybox_scalez;
 	}
 
-	if (r_viewmobj->subsector)
+	if (r_viewmobj->subsector && rendertimefrac >= FRACUNIT)
 		viewsector = r_viewmobj->subsector->sector;
 	else
 		viewsector = R_PointInSubsector(viewx, viewy)->sector;
@@ -1442,6 +1463,8 @@ void R_RenderPlayerView(player_t *player)
 	UINT8			nummasks	= 1;
 	maskcount_t*	masks		= malloc(sizeof(maskcount_t));
 
+	TRACE_BEGIN("R_RenderPlayerView");
+
 	if (cv_homremoval.value && player == &players[displayplayer]) // if this is display player 1
 	{
 		if (cv_homremoval.value == 1)
@@ -1454,6 +1477,8 @@ void R_RenderPlayerView(player_t *player)
 	framecount++;
 	validcount++;
 
+	R_StartDrawQueue();
+
 	// Clear buffers.
 	R_ClearPlanes();
 	if (viewmorph.use)
@@ -1562,11 +1587,16 @@ void R_RenderPlayerView(player_t *player)
 
 	// draw mid texture and sprite
 	// And now 3D floors/sides!
+	rs_sw_spritesorttime = 0;
 	rs_sw_maskedtime = I_GetTimeMicros();
 	R_DrawMasked(masks, nummasks);
 	rs_sw_maskedtime = I_GetTimeMicros() - rs_sw_maskedtime;
 
+	R_EndDrawQueue();
+
 	free(masks);
+
+	TRACE_END();
 }
 
 #ifdef HWRENDER
@@ -1609,6 +1639,11 @@ void R_RegisterEngineStuff(void)
 	CV_RegisterVar(&cv_drawdist_nights);
 	CV_RegisterVar(&cv_drawdist_precip);
 	CV_RegisterVar(&cv_fov);
+#ifdef DRAWTHREADS
+	CV_RegisterVar(&cv_renderthreads);
+#endif
+	CV_RegisterVar(&cv_slopespansize);
+	CV_RegisterVar(&cv_fpscap);
 
 	CV_RegisterVar(&cv_chasecam);
 	CV_RegisterVar(&cv_chasecam2);
@@ -91,6 +91,7 @@ extern int rs_bsptime;
 extern int rs_sw_portaltime;
 extern int rs_sw_planetime;
 extern int rs_sw_maskedtime;
+extern int rs_sw_spritesorttime; // part of rs_sw_maskedtime
 
 extern int rs_numbspcalls;
 extern int rs_numsprites;
@@ -112,6 +113,8 @@ extern consvar_t cv_drawdist, cv_drawdist_nights, cv_drawdist_precip;
 extern consvar_t cv_fov;
 extern consvar_t cv_skybox;
 extern consvar_t cv_tailspickup;
+extern consvar_t cv_renderthreads;
+extern consvar_t cv_slopespansize;
 
 // Called by startup code.
 void R_Init(void);
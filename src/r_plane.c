@@ -83,8 +83,9 @@ static INT32 spanstart[MAXVIDHEIGHT];
 //
 // texture mapping
 //
-lighttable_t **planezlight;
+DRAWLOCAL lighttable_t **planezlight;
 static fixed_t planeheight;
+static boolean queueplanespans; // let R_DrawSinglePlane record the spans, see R_QueueSpans
 
 //added : 10-02-98: yslopetab is what yslope used to be,
 //                yslope points somewhere into yslopetab,
@@ -586,6 +587,8 @@ void R_DrawPlanes(void)
 	// R_DrawSinglePlane and R_DrawSkyPlane do span/column drawer resets themselves anyway
 	spanfunc = spanfuncs[BASEDRAWFUNC];
 
+	// These are opaque and don't overlap, so they can be drawn in any order
+	queueplanespans = true;
 	for (i = 0; i < MAXVISPLANES; i++, pl++)
 	{
 		for (pl = visplanes[i]; pl; pl = pl->next)
@@ -596,6 +599,8 @@ void R_DrawPlanes(void)
 			R_DrawSinglePlane(pl);
 		}
 	}
+	queueplanespans = false;
+	spanfunc = spanfuncs[BASEDRAWFUNC];
 #ifndef NOWATER
 	ds_waterofs = (leveltime & 1)*16384;
 	wtofs = leveltime * 140;
@@ -756,6 +761,10 @@ void R_DrawSinglePlane(visplane_t *pl)
 		return;
 	}
 
+	// Spans are drawn right away, so what was recorded so far must be done
+	if (!queueplanespans)
+		R_FlushDrawQueue();
+
 #ifndef NOWATER
 	itswater = false;
 #endif
@@ -1029,6 +1038,9 @@ void R_DrawSinglePlane(visplane_t *pl)
 	else
 		spanfunc = spanfuncs[spanfunctype];
 
+	if (queueplanespans)
+		R_QueueSpans();
+
 	// set the maximum value for unsigned
 	pl->top[pl->maxx+1] = 0xffff;
 	pl->top[pl->minx-1] = 0xffff;
@@ -1045,6 +1057,10 @@ void R_DrawSinglePlane(visplane_t *pl)
 	if (viewz != pl->viewz)
 		viewz = pl->viewz;
 
+	ds_viewx = viewx;
+	ds_viewy = viewy;
+	ds_viewz = viewz;
+
 	for (x = pl->minx; x <= stop; x++)
 	{
 		R_MakeSpans(x, pl->top[x-1], pl->bottom[x-1],
@@ -18,6 +18,7 @@
 #include "r_data.h"
 #include "r_textures.h"
 #include "p_polyobj.h"
+#include "r_draw.h" // DRAWLOCAL
 
 #define MAXVISPLANES 512
 
@@ -69,7 +70,7 @@ extern fixed_t cachedystep[MAXVIDHEIGHT];
 extern fixed_t basexscale, baseyscale;
 
 extern fixed_t *yslope;
-extern lighttable_t **planezlight;
+extern DRAWLOCAL lighttable_t **planezlight;
 
 void R_InitPlanes(void);
 void R_ClearPlanes(void);
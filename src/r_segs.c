@@ -1235,6 +1235,8 @@ static void R_RenderSegLoop (void)
 	INT32     bottom;
 	INT32     i;
 
+	R_StartColumnBatch();
+
 	for (; rw_x < rw_stopx; rw_x++)
 	{
 		// mark floor / ceiling areas
@@ -1562,6 +1564,8 @@ static void R_RenderSegLoop (void)
 		topfrac += topstep;
 		bottomfrac += bottomstep;
 	}
+
+	R_EndColumnBatch();
 }
 
 // Uses precalculated seg->length
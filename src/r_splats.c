@@ -572,6 +572,8 @@ void R_DrawVisibleFloorSplats(void)
 	vertex_t *v3d;
 	vertex_t v2d[4];
 
+	R_FlushDrawQueue(); // Splats are drawn right away
+
 	pSplat = visfloorsplats;
 	while (pSplat)
 	{
@@ -27,6 +27,7 @@
 #include "r_picformats.h"
 #include "r_plane.h"
 #include "r_portal.h"
+#include "r_fps.h"
 #include "p_tick.h"
 #include "p_local.h"
 #include "p_slopes.h"
@@ -689,7 +690,7 @@ void R_DrawFlippedMaskedColumn(column_t *column)
 	INT32 bottomscreen;
 	fixed_t basetexturemid = dc_texturemid;
 	INT32 topdelta, prevdelta = -1;
-	UINT8 *d,*s;
+	UINT8 *d,*s,*flipped;
 
 	for (; column->topdelta != 0xff ;)
 	{
@@ -726,7 +727,9 @@ void R_DrawFlippedMaskedColumn(column_t *column)
 
 		if (dc_yl <= dc_yh && dc_yh > 0)
 		{
-			dc_source = ZZ_Alloc(column->length);
+			// Recorded columns are drawn later, so the copy must last until then
+			flipped = R_AllocColumnData(column->length);
+			dc_source = flipped ? flipped : ZZ_Alloc(column->length);
 			for (s = (UINT8 *)column+2+column->length, d = dc_source; d < dc_source+column->length; --s)
 				*d++ = *s;
 			dc_texturemid = basetexturemid - (topdelta<<FRACBITS);
@@ -738,7 +741,11 @@ void R_DrawFlippedMaskedColumn(column_t *column)
 			else
 				I_Error("R_DrawMaskedColumn: Invalid ylookup for dc_yl %d", dc_yl);
 #endif
-			Z_Free(dc_source);
+			if (!flipped)
+			{
+				R_FlushColumnBatch();
+				Z_Free(dc_source);
+			}
 		}
 		column = (column_t *)((UINT8 *)column + column->length + 4);
 	}
@@ -907,6 +914,8 @@ static void R_DrawVisSprite(vissprite_t *vis)
 	localcolfunc = (vis->cut & SC_VFLIP) ? R_DrawFlippedMaskedColumn : R_DrawMaskedColumn;
 	lengthcol = SHORT(patch->height);
 
+	R_StartColumnBatch();
+
 	// Split drawing loops for paper and non-paper to reduce conditional checks per sprite
 	if (vis->scalestep)
 	{
@@ -953,6 +962,8 @@ static void R_DrawVisSprite(vissprite_t *vis)
 		}
 	}
 
+	R_EndColumnBatch();
+
 	colfunc = colfuncs[BASEDRAWFUNC];
 	dc_hires = 0;
 
@@ -1226,7 +1237,7 @@ fixed_t R_GetShadowZ(mobj_t *thing, pslope_t **shadowslope)
 #undef CHECKZ
 }
 
-static void R_ProjectDropShadow(mobj_t *thing, vissprite_t *vis, fixed_t scale, fixed_t tx, fixed_t tz)
+static void R_ProjectDropShadow(mobj_t *thing, interpmobjstate_t *interp, vissprite_t *vis, fixed_t scale, fixed_t tx, fixed_t tz)
 {
 	vissprite_t *shadow;
 	patch_t *patch;
@@ -1242,7 +1253,7 @@ static void R_ProjectDropShadow(mobj_t *thing, vissprite_t *vis, fixed_t scale,
 
 	if (abs(groundz-viewz)/tz > 4) return; // Prevent stretchy shadows and possible crashes
 
-	floordiff = abs((isflipped ? thing->height : 0) + thing->z - groundz);
+	floordiff = abs((isflipped ? thing->height : 0) + interp->z - groundz);
 
 	trans = floordiff / (100*FRACUNIT) + 3;
 	if (trans >= 9) return;
@@ -1262,7 +1273,7 @@ static void R_ProjectDropShadow(mobj_t *thing, vissprite_t *vis, fixed_t scale,
 	{
 		// haha let's try some dumb stuff
 		fixed_t xslope, zslope;
-		angle_t sloperelang = (R_PointToAngle(thing->x, thing->y) - groundslope->xydirection) >> ANGLETOFINESHIFT;
+		angle_t sloperelang = (R_PointToAngle(interp->x, interp->y) - groundslope->xydirection) >> ANGLETOFINESHIFT;
 
 		xslope = FixedMul(FINESINE(sloperelang), groundslope->zdelta);
 		zslope = FixedMul(FINECOSINE(sloperelang), groundslope->zdelta);
@@ -1300,8 +1311,8 @@ static void R_ProjectDropShadow(mobj_t *thing, vissprite_t *vis, fixed_t scale,
 	shadow->mobjflags = 0;
 	shadow->sortscale = vis->sortscale;
 	shadow->dispoffset = vis->dispoffset - 5;
-	shadow->gx = thing->x;
-	shadow->gy = thing->y;
+	shadow->gx = interp->x;
+	shadow->gy = interp->y;
 	shadow->gzt = (isflipped ? shadow->pzt : shadow->pz) + SHORT(patch->height) * shadowyscale / 2;
 	shadow->gz = shadow->gzt - SHORT(patch->height) * shadowyscale;
 	shadow->texturemid = FixedMul(thing->scale, FixedDiv(shadow->gzt - viewz, shadowyscale));
@@ -1368,6 +1379,7 @@ static void R_ProjectDropShadow(mobj_t *thing, vissprite_t *vis, fixed_t scale,
 static void R_ProjectSprite(mobj_t *thing)
 {
 	mobj_t *oldthing = thing;
+	interpmobjstate_t interp, linkinterp; // where oldthing and thing are drawn
 	fixed_t tr_x, tr_y;
 	fixed_t tx, tz;
 	fixed_t xscale, yscale, sortscale; //added : 02-02-98 : aaargll..if I were a math-guy!!!
@@ -1419,9 +1431,12 @@ static void R_ProjectSprite(mobj_t *thing)
 	INT32 rollangle = 0;
 #endif
 
+	R_InterpolateMobjState(thing, &interp);
+	linkinterp = interp;
+
 	// transform the origin point
-	tr_x = thing->x - viewx;
-	tr_y = thing->y - viewy;
+	tr_x = interp.x - viewx;
+	tr_y = interp.y - viewy;
 
 	tz = FixedMul(tr_x, viewcos) + FixedMul(tr_y, viewsin); // near/far distance
 
@@ -1497,7 +1512,7 @@ static void R_ProjectSprite(mobj_t *thing)
 
 	if (sprframe->rotate != SRF_SINGLE || papersprite)
 	{
-		ang = R_PointToAngle (thing->x, thing->y) - (thing->player ? thing->player->drawangle : thing->angle);
+		ang = R_PointToAngle (interp.x, interp.y) - (thing->player ? R_InterpolateAngle(thing->player->old_drawangle, thing->player->drawangle) : interp.angle);
 		if (mirrored)
 			ang = InvAngle(ang);
 	}
@@ -1581,8 +1596,8 @@ static void R_ProjectSprite(mobj_t *thing)
 			offset2 *= -1;
 		}
 
-		cosmul = FINECOSINE(thing->angle>>ANGLETOFINESHIFT);
-		sinmul = FINESINE(thing->angle>>ANGLETOFINESHIFT);
+		cosmul = FINECOSINE(interp.angle>>ANGLETOFINESHIFT);
+		sinmul = FINESINE(interp.angle>>ANGLETOFINESHIFT);
 
 		tr_x += FixedMul(offset, cosmul);
 		tr_y += FixedMul(offset, sinmul);
@@ -1598,7 +1613,7 @@ static void R_ProjectSprite(mobj_t *thing)
 			paperoffset = -paperoffset;
 			paperdistance = -paperdistance;
 		}
-		centerangle = viewangle - thing->angle;
+		centerangle = viewangle - interp.angle;
 
 		tr_x += FixedMul(offset2, cosmul);
 		tr_y += FixedMul(offset2, sinmul);
@@ -1684,8 +1699,10 @@ static void R_ProjectSprite(mobj_t *thing)
 		if (! R_ThingVisible(thing))
 			return;
 
-		tr_x = thing->x - viewx;
-		tr_y = thing->y - viewy;
+		R_InterpolateMobjState(thing, &linkinterp);
+
+		tr_x = linkinterp.x - viewx;
+		tr_y = linkinterp.y - viewy;
 		tz = FixedMul(tr_x, viewcos) + FixedMul(tr_y, viewsin);
 		linkscale = FixedDiv(projectiony, tz);
 
@@ -1705,7 +1722,7 @@ static void R_ProjectSprite(mobj_t *thing)
 		if (x2 < portalclipstart || x1 >= portalclipend)
 			return;
 
-		if (P_PointOnLineSide(thing->x, thing->y, portalclipline) != 0)
+		if (P_PointOnLineSide(linkinterp.x, linkinterp.y, portalclipline) != 0)
 			return;
 	}
 
@@ -1715,12 +1732,12 @@ static void R_ProjectSprite(mobj_t *thing)
 		// When vertical flipped, draw sprites from the top down, at least as far as offsets are concerned.
 		// sprite height - sprite topoffset is the proper inverse of the vertical offset, of course.
 		// remember gz and gzt should be seperated by sprite height, not thing height - thing height can be shorter than the sprite itself sometimes!
-		gz = oldthing->z + oldthing->height - FixedMul(spr_topoffset, this_scale);
+		gz = interp.z + oldthing->height - FixedMul(spr_topoffset, this_scale);
 		gzt = gz + FixedMul(spr_height, this_scale);
 	}
 	else
 	{
-		gzt = oldthing->z + FixedMul(spr_topoffset, this_scale);
+		gzt = interp.z + FixedMul(spr_topoffset, this_scale);
 		gz = gzt - FixedMul(spr_height, this_scale);
 	}
 
@@ -1737,7 +1754,7 @@ static void R_ProjectSprite(mobj_t *thing)
 
 		// R_GetPlaneLight won't work on sloped lights!
 		for (lightnum = 1; lightnum < thing->subsector->sector->numlights; lightnum++) {
-			fixed_t h = P_GetLightZAt(&thing->subsector->sector->lightlist[lightnum], thing->x, thing->y);
+			fixed_t h = P_GetLightZAt(&thing->subsector->sector->lightlist[lightnum], linkinterp.x, linkinterp.y);
 			if (h <= gzt) {
 				light = lightnum - 1;
 				break;
@@ -1763,12 +1780,12 @@ static void R_ProjectSprite(mobj_t *thing)
 	if (heightsec != -1 && phs != -1) // only clip things which are in special sectors
 	{
 		if (viewz < sectors[phs].floorheight ?
-		thing->z >= sectors[heightsec].floorheight :
+		linkinterp.z >= sectors[heightsec].floorheight :
 		gzt < sectors[heightsec].floorheight)
 			return;
 		if (viewz > sectors[phs].ceilingheight ?
 		gzt < sectors[heightsec].ceilingheight && viewz >= sectors[heightsec].ceilingheight :
-		thing->z >= sectors[heightsec].ceilingheight)
+		linkinterp.z >= sectors[heightsec].ceilingheight)
 			return;
 	}
 
@@ -1779,12 +1796,12 @@ static void R_ProjectSprite(mobj_t *thing)
 	vis->scale = yscale; //<<detailshift;
 	vis->sortscale = sortscale;
 	vis->dispoffset = dispoffset; // Monster Iestyn: 23/11/15
-	vis->gx = thing->x;
-	vis->gy = thing->y;
+	vis->gx = linkinterp.x;
+	vis->gy = linkinterp.y;
 	vis->gz = gz;
 	vis->gzt = gzt;
 	vis->thingheight = thing->height;
-	vis->pz = thing->z;
+	vis->pz = linkinterp.z;
 	vis->pzt = vis->pz + vis->thingheight;
 	vis->texturemid = vis->gzt - viewz;
 	vis->scalestep = scalestep;
@@ -1877,7 +1894,7 @@ static void R_ProjectSprite(mobj_t *thing)
 		R_SplitSprite(vis);
 
 	if (oldthing->shadowscale && cv_shadow.value)
-		R_ProjectDropShadow(oldthing, vis, oldthing->shadowscale, basetx, tz);
+		R_ProjectDropShadow(oldthing, &interp, vis, oldthing->shadowscale, basetx, tz);
 
 	// Debug
 	++objectsdrawn;
@@ -1902,9 +1919,12 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	//SoM: 3/17/2000
 	fixed_t gz, gzt;
 
+	interpmobjstate_t interp;
+	R_InterpolatePrecipMobjState(thing, &interp);
+
 	// transform the origin point
-	tr_x = thing->x - viewx;
-	tr_y = thing->y - viewy;
+	tr_x = interp.x - viewx;
+	tr_y = interp.y - viewy;
 
 	tz = FixedMul(tr_x, viewcos) + FixedMul(tr_y, viewsin); // near/far distance
 
@@ -1968,13 +1988,13 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 		if (x2 < portalclipstart || x1 >= portalclipend)
 			return;
 
-		if (P_PointOnLineSide(thing->x, thing->y, portalclipline) != 0)
+		if (P_PointOnLineSide(interp.x, interp.y, portalclipline) != 0)
 			return;
 	}
 
 
 	//SoM: 3/17/2000: Disregard sprites that are out of view..
-	gzt = thing->z + spritecachedinfo[lump].topoffset;
+	gzt = interp.z + spritecachedinfo[lump].topoffset;
 	gz = gzt - spritecachedinfo[lump].height;
 
 	if (thing->subsector->sector->cullheight)
@@ -1987,12 +2007,12 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	vis = R_NewVisSprite();
 	vis->scale = vis->sortscale = yscale; //<<detailshift;
 	vis->dispoffset = 0; // Monster Iestyn: 23/11/15
-	vis->gx = thing->x;
-	vis->gy = thing->y;
+	vis->gx = interp.x;
+	vis->gy = interp.y;
 	vis->gz = gz;
 	vis->gzt = gzt;
 	vis->thingheight = 4*FRACUNIT;
-	vis->pz = thing->z;
+	vis->pz = interp.z;
 	vis->pzt = vis->pz + vis->thingheight;
 	vis->texturemid = vis->gzt - viewz;
 	vis->scalestep = 0;
@@ -2037,14 +2057,7 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 
 weatherthink:
 	// okay... this is a hack, but weather isn't networked, so it should be ok
-	if (!(thing->precipflags & PCF_THUNK))
-	{
-		if (thing->precipflags & PCF_RAIN)
-			P_RainThinker(thing);
-		else
-			P_SnowThinker(thing);
-		thing->precipflags |= PCF_THUNK;
-	}
+	P_PrecipThink(thing);
 }
 
 // R_AddSprites
@@ -2108,61 +2121,102 @@ void R_AddSprites(sector_t *sec, INT32 lightlevel)
 //
 // R_SortVisSprites
 //
-static void R_SortVisSprites(vissprite_t* vsprsortedhead, UINT32 start, UINT32 end)
-{
-	UINT32       i, linkedvissprites = 0;
-	vissprite_t *ds, *dsprev, *dsnext, *dsfirst;
-	vissprite_t *best = NULL;
-	vissprite_t  unsorted;
-	fixed_t      bestscale;
-	INT32        bestdispoffset;
+// Sprites are drawn farthest first: by sortscale, then by dispoffset, and in
+// the order they were added when both are the same. Linkdraw sprites are
+// taken out first and hung off the sprite of their mobj they are drawn with.
+//
+
+// Hash of the sprites linkdraw sprites can be attached to, by mobj
+#define LINKHASHSIZE 256
+#define LINKHASH(mobj) ((((size_t)(mobj)) >> 6) & (LINKHASHSIZE-1))
+
+static INT32 linkhash[LINKHASHSIZE]; // newest sprite of each chain, -1 if none
+static INT32 linknext[MAXVISSPRITES]; // next (older) sprite of the chain, by number
+
+static vissprite_t *sortvissprites[MAXVISSPRITES];
+static vissprite_t *sorttemp[MAXVISSPRITES];
 
-	unsorted.next = unsorted.prev = &unsorted;
+// Is a drawn before b?
+static inline boolean R_VisSpriteBefore(const vissprite_t *a, const vissprite_t *b)
+{
+	if (a->sortscale != b->sortscale)
+		return (a->sortscale < b->sortscale);
+	return (a->dispoffset < b->dispoffset);
+}
 
-	dsfirst = R_GetVisSprite(start);
+// Stable merge sort, returns which of the two arrays ended up sorted
+static vissprite_t **R_MergeSortVisSprites(vissprite_t **list, vissprite_t **temp, UINT32 count)
+{
+	vissprite_t **src = list, **dst = temp, **swap;
+	UINT32 width, lo, mid, hi, a, b, k;
 
-	// The first's prev and last's next will be set to
-	// nonsense, but are fixed in a moment
-	for (i = start, dsnext = dsfirst, ds = NULL; i < end; i++)
+	for (width = 1; width < count; width <<= 1)
 	{
-		dsprev = ds;
-		ds = dsnext;
-		if (i < end - 1) dsnext = R_GetVisSprite(i + 1);
+		for (lo = 0; lo < count; lo += width<<1)
+		{
+			mid = min(lo + width, count);
+			hi = min(lo + (width<<1), count);
 
-		ds->next = dsnext;
-		ds->prev = dsprev;
-		ds->linkdraw = NULL;
+			for (a = lo, b = mid, k = lo; k < hi; k++)
+			{
+				// Take the left one on ties, to keep the order they were added in
+				if (a < mid && (b >= hi || !R_VisSpriteBefore(src[b], src[a])))
+					dst[k] = src[a++];
+				else
+					dst[k] = src[b++];
+			}
+		}
+
+		swap = src;
+		src = dst;
+		dst = swap;
 	}
 
-	// Fix first and last. ds still points to the last one after the loop
-	dsfirst->prev = &unsorted;
-	unsorted.next = dsfirst;
-	if (ds)
+	return src;
+}
+
+static void R_SortVisSprites(vissprite_t* vsprsortedhead, UINT32 start, UINT32 end)
+{
+	UINT32       i, numsorted = 0, numlinks = 0;
+	INT32        j;
+	vissprite_t *ds, *dsfirst, *dsnext;
+	vissprite_t **sorted;
+	int          sorttime = I_GetTimeMicros();
+
+	memset(linkhash, -1, sizeof (linkhash));
+
+	for (i = start; i < end; i++)
 	{
-		ds->next = &unsorted;
+		ds = R_GetVisSprite(i);
 		ds->linkdraw = NULL;
+
+		if ((ds->cut & (SC_LINKDRAW|SC_SHADOW)) == SC_LINKDRAW)
+		{
+			numlinks++;
+			continue; // drawn along with another sprite, or not at all
+		}
+
+		sortvissprites[numsorted++] = ds;
+
+		// don't connect to a link or your shadow!
+		if (!(ds->cut & (SC_LINKDRAW|SC_SHADOW)))
+		{
+			linknext[i - start] = linkhash[LINKHASH(ds->mobj)];
+			linkhash[LINKHASH(ds->mobj)] = (INT32)(i - start);
+		}
 	}
-	unsorted.prev = ds;
 
-	// bundle linkdraw
-	for (ds = unsorted.prev; ds != &unsorted; ds = ds->prev)
+	// bundle linkdraw, newest first
+	for (i = end; numlinks && i-- > start;)
 	{
-		if (!(ds->cut & SC_LINKDRAW))
-			continue;
-
-		if (ds->cut & SC_SHADOW)
+		ds = R_GetVisSprite(i);
+		if ((ds->cut & (SC_LINKDRAW|SC_SHADOW)) != SC_LINKDRAW)
 			continue;
+		numlinks--;
 
-		// reuse dsfirst...
-		for (dsfirst = unsorted.prev; dsfirst != &unsorted; dsfirst = dsfirst->prev)
+		for (j = linkhash[LINKHASH(ds->mobj)]; j != -1; j = linknext[j])
 		{
-			// don't connect if it's also a link
-			if (dsfirst->cut & SC_LINKDRAW)
-				continue;
-
-			// don't connect to your shadow!
-			if (dsfirst->cut & SC_SHADOW)
-				continue;
+			dsfirst = R_GetVisSprite(start + j);
 
 			// don't connect if it's not the tracer
 			if (dsfirst->mobj != ds->mobj)
@@ -2181,68 +2235,44 @@ static void R_SortVisSprites(vissprite_t* vsprsortedhead, UINT32 start, UINT32 e
 			break;
 		}
 
-		// remove from chain
-		ds->next->prev = ds->prev;
-		ds->prev->next = ds->next;
-		linkedvissprites++;
+		if (j == -1) // no tracer, discard it
+			continue;
 
-		if (dsfirst != &unsorted)
-		{
-			if (!(ds->cut & SC_FULLBRIGHT))
-				ds->colormap = dsfirst->colormap;
-			ds->extra_colormap = dsfirst->extra_colormap;
+		if (!(ds->cut & SC_FULLBRIGHT))
+			ds->colormap = dsfirst->colormap;
+		ds->extra_colormap = dsfirst->extra_colormap;
 
-			// reusing dsnext...
-			dsnext = dsfirst->linkdraw;
+		// reusing dsnext...
+		dsnext = dsfirst->linkdraw;
 
-			if (!dsnext || ds->dispoffset < dsnext->dispoffset)
-			{
-				ds->next = dsnext;
-				dsfirst->linkdraw = ds;
-			}
-			else
-			{
-				for (; dsnext->next != NULL; dsnext = dsnext->next)
-					if (ds->dispoffset < dsnext->next->dispoffset)
-						break;
-				ds->next = dsnext->next;
-				dsnext->next = ds;
-			}
+		if (!dsnext || ds->dispoffset < dsnext->dispoffset)
+		{
+			ds->next = dsnext;
+			dsfirst->linkdraw = ds;
+		}
+		else
+		{
+			for (; dsnext->next != NULL; dsnext = dsnext->next)
+				if (ds->dispoffset < dsnext->next->dispoffset)
+					break;
+			ds->next = dsnext->next;
+			dsnext->next = ds;
 		}
 	}
 
-	// pull the vissprites out by scale
+	sorted = R_MergeSortVisSprites(sortvissprites, sorttemp, numsorted);
+
 	vsprsortedhead->next = vsprsortedhead->prev = vsprsortedhead;
-	for (i = start; i < end-linkedvissprites; i++)
+	for (i = 0; i < numsorted; i++)
 	{
-		bestscale = bestdispoffset = INT32_MAX;
-		for (ds = unsorted.next; ds != &unsorted; ds = ds->next)
-		{
-#ifdef PARANOIA
-			if (ds->cut & SC_LINKDRAW)
-				I_Error("R_SortVisSprites: no link or discardal made for linkdraw!");
-#endif
-
-			if (ds->sortscale < bestscale)
-			{
-				bestscale = ds->sortscale;
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-			// order visprites of same scale by dispoffset, smallest first
-			else if (ds->sortscale == bestscale && ds->dispoffset < bestdispoffset)
-			{
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-		}
-		best->next->prev = best->prev;
-		best->prev->next = best->next;
-		best->next = vsprsortedhead;
-		best->prev = vsprsortedhead->prev;
-		vsprsortedhead->prev->next = best;
-		vsprsortedhead->prev = best;
+		ds = sorted[i];
+		ds->next = vsprsortedhead;
+		ds->prev = vsprsortedhead->prev;
+		vsprsortedhead->prev->next = ds;
+		vsprsortedhead->prev = ds;
 	}
+
+	rs_sw_spritesorttime += I_GetTimeMicros() - sorttime;
 }
 
 //
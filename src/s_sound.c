@@ -29,6 +29,7 @@
 #include "fastcmp.h"
 #include "m_misc.h" // for tunes command
 #include "m_cond.h" // for conditionsets
+#include "m_trace.h"
 
 #ifdef HAVE_LUA_MUSICPLUS
 #include "lua_hook.h" // MusicChange hook
@@ -845,6 +846,8 @@ void S_UpdateSounds(void)
 	memset(&listener, 0, sizeof(listener_t));
 	memset(&listener2, 0, sizeof(listener_t));
 
+	TRACE_BEGIN("S_UpdateSounds");
+
 	// Update sound/music volumes, if changed manually at console
 	if (actualsfxvolume != cv_soundvolume.value)
 		S_SetSfxVolume (cv_soundvolume.value);
@@ -865,7 +868,10 @@ void S_UpdateSounds(void)
 	}
 
 	if (dedicated || sound_disabled)
+	{
+		TRACE_END();
 		return;
+	}
 
 	if (players[displayplayer].awayviewtics)
 		listenmobj = players[displayplayer].awayviewmobj;
@@ -990,6 +996,8 @@ void S_UpdateSounds(void)
 
 notinlevel:
 	I_UpdateSound();
+
+	TRACE_END();
 }
 
 void S_UpdateClosedCaptions(void)
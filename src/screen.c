@@ -32,6 +32,7 @@
 #include "s_sound.h" // ditto
 #include "g_game.h" // ditto
 #include "p_local.h" // P_AutoPause()
+#include "r_fps.h"
 
 
 #if defined (USEASM) && !defined (NORUSEASM)//&& (!defined (_MSC_VER) || (_MSC_VER <= 1200))
@@ -43,6 +44,7 @@
 // --------------------------------------------
 void (*colfunc)(void);
 void (*colfuncs[COLDRAWFUNC_MAX])(void);
+void (*colfuncs_quad[COLDRAWFUNC_MAX])(void);
 
 void (*spanfunc)(void);
 void (*spanfuncs[SPANDRAWFUNC_MAX])(void);
@@ -120,6 +122,11 @@ void SCR_SetDrawFuncs(void)
 		colfuncs[COLDRAWFUNC_TWOSMULTIPATCHTRANS] = R_Draw2sMultiPatchTranslucentColumn_8;
 		colfuncs[COLDRAWFUNC_FOG] = R_DrawFogColumn_8;
 
+		// Quad column drawers, for walls and sprites
+		colfuncs_quad[BASEDRAWFUNC] = R_DrawColumnQuad_8;
+		colfuncs_quad[COLDRAWFUNC_FUZZY] = R_DrawTranslucentColumnQuad_8;
+		colfuncs_quad[COLDRAWFUNC_TRANS] = R_DrawTranslatedColumnQuad_8;
+
 		spanfuncs[SPANDRAWFUNC_TRANS] = R_DrawTranslucentSpan_8;
 		spanfuncs[SPANDRAWFUNC_SPLAT] = R_DrawSplat_8;
 		spanfuncs[SPANDRAWFUNC_TRANSSPLAT] = R_DrawTranslucentSplat_8;
@@ -156,6 +163,7 @@ void SCR_SetDrawFuncs(void)
 			if (R_MMX)
 			{
 				colfuncs[BASEDRAWFUNC] = R_DrawColumn_8_MMX;
+				colfuncs_quad[BASEDRAWFUNC] = NULL;
 				//colfuncs[COLDRAWFUNC_SHADE] = R_DrawShadeColumn_8_ASM;
 				//colfuncs[COLDRAWFUNC_FUZZY] = R_DrawTranslucentColumn_8_ASM;
 				colfuncs[COLDRAWFUNC_TWOSMULTIPATCH] = R_Draw2sMultiPatchColumn_8_MMX;
@@ -164,6 +172,7 @@ void SCR_SetDrawFuncs(void)
 			else
 			{
 				colfuncs[BASEDRAWFUNC] = R_DrawColumn_8_ASM;
+				colfuncs_quad[BASEDRAWFUNC] = NULL;
 				//colfuncs[COLDRAWFUNC_SHADE] = R_DrawShadeColumn_8_ASM;
 				//colfuncs[COLDRAWFUNC_FUZZY] = R_DrawTranslucentColumn_8_ASM;
 				colfuncs[COLDRAWFUNC_TWOSMULTIPATCH] = R_Draw2sMultiPatchColumn_8_ASM;
@@ -515,6 +524,41 @@ boolean SCR_IsAspectCorrect(INT32 width, INT32 height)
 static boolean fpsgraph[TICRATE];
 static tic_t lasttic;
 
+// With frame interpolation the frames aren't tied to tics, so count them
+// over each second instead
+static void SCR_DisplayFrameRate(void)
+{
+	static int secondstart = 0;
+	static UINT32 frames = 0, lastframes = 0;
+	const int now = I_GetTimeMicros();
+	const UINT32 cap = R_GetFramerateCap();
+	const INT32 h = vid.height-(8*vid.dupy);
+	INT32 ticcntcolor = 0;
+	const char *fpsstr;
+
+	frames++;
+	if ((UINT32)(now - secondstart) >= 1000000)
+	{
+		lastframes = frames;
+		frames = 0;
+		secondstart = now;
+	}
+
+	if (lastframes < TICRATE) ticcntcolor = V_REDMAP;
+	else if (cap && lastframes >= cap) ticcntcolor = V_GREENMAP;
+
+	if (cv_ticrate.value == 2 || !cap) // compact counter
+		fpsstr = va("%u", lastframes);
+	else
+		fpsstr = va("%u/%u", lastframes, cap);
+
+	if (cv_ticrate.value == 1)
+		V_DrawString(vid.width-(((INT32)strlen(fpsstr)+4)*8*vid.dupx), h,
+			V_YELLOWMAP|V_NOSCALESTART|V_USERHUDTRANS, "FPS:");
+	V_DrawString(vid.width-((INT32)strlen(fpsstr)*8*vid.dupx), h,
+		ticcntcolor|V_NOSCALESTART|V_USERHUDTRANS, fpsstr);
+}
+
 void SCR_DisplayTicRate(void)
 {
 	tic_t i;
@@ -526,6 +570,12 @@ void SCR_DisplayTicRate(void)
 	if (gamestate == GS_NULL)
 		return;
 
+	if (R_UsingFrameInterpolation())
+	{
+		SCR_DisplayFrameRate();
+		return;
+	}
+
 	for (i = lasttic + 1; i < TICRATE+lasttic && i < ontic; ++i)
 		fpsgraph[i % TICRATE] = false;
 
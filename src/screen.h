@@ -129,6 +129,7 @@ enum
 
 extern void (*colfunc)(void);
 extern void (*colfuncs[COLDRAWFUNC_MAX])(void);
+extern void (*colfuncs_quad[COLDRAWFUNC_MAX])(void); // four columns side by side, NULL if there is no such drawer
 
 enum
 {
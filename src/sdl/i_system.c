@@ -54,6 +54,11 @@ typedef LPVOID (WINAPI *p_MapViewOfFile) (HANDLE, DWORD, DWORD, DWORD, SIZE_T);
 #include <fcntl.h>
 #endif
 
+#if defined (__linux__) || defined (__FreeBSD__)
+#include <time.h> // clock_nanosleep
+#define HAVE_CLOCK_NANOSLEEP
+#endif
+
 #if defined (_WIN32)
 DWORD TimeFunction(int requested_frequency);
 #else
@@ -2123,22 +2128,24 @@ static void I_ShutdownTimer(void)
 // returns time in 1/TICRATE second tics
 //
 
-// millisecond precision only
+// uses the high resolution counter, so that I_GetTimeMicros really has
+// microsecond precision
 int TimeFunction(int requested_frequency)
 {
-	static Uint64 basetime = 0;
-		   Uint64 ticks = SDL_GetTicks();
+	static Uint64 basetime = 0, frequency = 0;
+		   Uint64 ticks = SDL_GetPerformanceCounter();
 
 	if (!basetime)
+	{
 		basetime = ticks;
+		frequency = SDL_GetPerformanceFrequency();
+	}
 
 	ticks -= basetime;
 
-	ticks = (ticks*requested_frequency);
-
-	ticks = (ticks/1000);
-
-	return ticks;
+	// whole seconds and the rest apart, so the product can't overflow
+	return (int)((ticks / frequency) * requested_frequency
+		+ (ticks % frequency) * requested_frequency / frequency);
 }
 #endif
 
@@ -2152,6 +2159,22 @@ int I_GetTimeMicros(void)
 	return TimeFunction(1000000);
 }
 
+UINT64 I_GetPreciseTime(void)
+{
+	return SDL_GetPerformanceCounter();
+}
+
+UINT64 I_GetPrecision(void)
+{
+	return SDL_GetPerformanceFrequency();
+}
+
+fixed_t I_GetTimeFrac(void)
+{
+	// the same clock as I_GetTime, counted in fractions of a tic
+	return (fixed_t)(TimeFunction(NEWTICRATE*FRACUNIT) & (FRACUNIT-1));
+}
+
 //
 //I_StartupTimer
 //
@@ -2184,6 +2207,40 @@ void I_Sleep(void)
 		SDL_Delay(cv_sleep.value);
 }
 
+void I_SleepUntilMicros(int deadline)
+{
+	INT32 left = (INT32)((UINT32)deadline - (UINT32)I_GetTimeMicros());
+
+	if (left <= 0)
+		return;
+
+#ifdef HAVE_CLOCK_NANOSLEEP
+	{
+		struct timespec wake;
+
+		// An absolute wake-up time stays right when a signal cuts the sleep short
+		clock_gettime(CLOCK_MONOTONIC, &wake);
+		wake.tv_sec += left / 1000000;
+		wake.tv_nsec += (left % 1000000) * 1000;
+		if (wake.tv_nsec >= 1000000000)
+		{
+			wake.tv_sec++;
+			wake.tv_nsec -= 1000000000;
+		}
+
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) == EINTR)
+			;
+	}
+#else
+	// SDL_Delay only goes by whole milliseconds and may oversleep by one,
+	// so sleep through most of the wait and spin through the rest
+	if (left > 2000)
+		SDL_Delay((left - 1000) / 1000);
+	while ((INT32)((UINT32)deadline - (UINT32)I_GetTimeMicros()) > 0)
+		;
+#endif
+}
+
 #ifdef NEWSIGNALHANDLER
 static void newsignalhandler_Warn(const char *pr)
 {
@@ -197,6 +197,12 @@ I_thread_is_stopped (void)
 	return ( ! SDL_AtomicGet(&i_threads_running) );
 }
 
+unsigned long
+I_thread_id (void)
+{
+	return SDL_ThreadID();
+}
+
 void
 I_start_threads (void)
 {
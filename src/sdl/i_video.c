@@ -1727,6 +1727,11 @@ void I_StartupGraphics(void)
 
 	keyboard_started = true;
 
+	// The demo benchmarks run on machines without a display; SDL's dummy
+	// driver gives them a window that never appears.
+	if (M_CheckParm("-simdemo") || M_CheckParm("-renderdemo"))
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+
 #if !defined(HAVE_TTF)
 	// Previously audio was init here for questionable reasons?
 	if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0)
@@ -1748,7 +1753,7 @@ void I_StartupGraphics(void)
 	}
 
 #ifdef HWRENDER
-	if (M_CheckParm("-opengl"))
+	if (M_CheckParm("-opengl") && !M_CheckParm("-simdemo") && !M_CheckParm("-renderdemo"))
 		chosenrendermode = rendermode = render_opengl;
 	else if (M_CheckParm("-software"))
 #endif
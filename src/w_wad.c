@@ -33,6 +33,15 @@
 #include <unistd.h>
 #endif
 
+#include <sys/stat.h>
+
+#if defined (UNIXCOMMON) && !defined (NOMMAP)
+#include <sys/mman.h>
+#ifdef MAP_FAILED
+#define HAVE_MMAP
+#endif
+#endif
+
 #define ZWAD
 
 #ifdef ZWAD
@@ -65,6 +74,9 @@
 #include "p_setup.h" // P_ScanThings
 #endif
 #include "m_misc.h" // M_MapNumber
+#include "m_argv.h" // M_CheckParm
+#include "d_main.h" // srb2home
+#include "i_threads.h"
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -98,6 +110,183 @@ typedef struct lumpnum_cache_s
 static lumpnum_cache_t lumpnumcache[LUMPNUMCACHESIZE];
 static UINT16 lumpnumcacheindex = 0;
 
+static void W_StopDecompressWorkers(void);
+
+//
+// Lump name index
+//
+// Every file gets hash chains for its lump names, long names and full names,
+// so that looking up a lump doesn't need to compare against every lump of
+// every file. The chains are kept in lump order, so the first match is the
+// same lump a forward scan would have found.
+//
+// PK3s also get a table of their folders, with the first lump in each folder
+// and the end of the run of lumps following it, for
+// W_CheckNumForFolderStartPK3 and W_CheckNumForFolderEndPK3.
+//
+
+#define LUMPINDEX_NONE 0xFFFF // end of a hash chain
+#define WHOLENAME ((size_t)-1) // for W_HashName
+
+typedef struct
+{
+	UINT16 first; // first lump in the folder
+	UINT16 end; // first lump past the run of lumps starting at first
+	UINT16 length; // length of the folder path, trailing '/' included
+	UINT32 next; // next folder in the same hash bucket
+} lumpfolder_t;
+
+typedef struct lumpindex_s
+{
+	UINT32 hashmask; // number of buckets - 1
+
+	UINT16 *namefirst, *namenext; // lumpinfo_t name
+	UINT16 *longnamefirst, *longnamenext; // lumpinfo_t longname
+	UINT16 *fullnamefirst, *fullnamenext; // lumpinfo_t fullname, ignoring case
+
+	lumpfolder_t *folders;
+	UINT32 *folderfirst; // first folder of each hash bucket
+	UINT32 numfolders, maxfolders;
+} lumpindex_t;
+
+// Case insensitive, so the same hash serves lookups that ignore case.
+static UINT32 W_HashName(const char *name, size_t maxlength)
+{
+	UINT32 hash = 5381;
+	while (maxlength-- && *name)
+		hash = hash * 33 + toupper((UINT8)*name++);
+	return hash;
+}
+
+static void W_IndexFolder(lumpindex_t *index, const lumpinfo_t *lumpinfo, UINT16 lump, size_t length)
+{
+	const char *path = lumpinfo[lump].fullname;
+	UINT32 bucket = W_HashName(path, length) & index->hashmask;
+	UINT32 i;
+	lumpfolder_t *folder;
+
+	for (i = index->folderfirst[bucket]; i != UINT32_MAX; i = index->folders[i].next)
+	{
+		folder = &index->folders[i];
+		if (folder->length == length && !strnicmp(lumpinfo[folder->first].fullname, path, length))
+		{
+			if (folder->end == lump) // still in the first run
+				folder->end++;
+			return;
+		}
+	}
+
+	if (index->numfolders == index->maxfolders)
+	{
+		index->maxfolders = index->maxfolders ? index->maxfolders * 2 : 64;
+		index->folders = Z_Realloc(index->folders, index->maxfolders * sizeof (*index->folders), PU_STATIC, NULL);
+	}
+
+	folder = &index->folders[index->numfolders];
+	folder->first = lump;
+	folder->end = lump + 1;
+	folder->length = (UINT16)length;
+	folder->next = index->folderfirst[bucket];
+	index->folderfirst[bucket] = index->numfolders++;
+}
+
+/** Builds the lump name index of a newly added file.
+  *
+  * \param wadfile The file, with its lumpinfo filled in.
+  * \sa W_CheckNumForNamePwad, W_CheckNumForFolderStartPK3
+  */
+static void W_BuildLumpIndex(wadfile_t *wadfile)
+{
+	lumpindex_t *index;
+	UINT32 numbuckets = 16, bucket;
+	UINT16 i;
+	size_t j;
+
+	while (numbuckets < wadfile->numlumps)
+		numbuckets <<= 1;
+
+	index = Z_Calloc(sizeof (*index), PU_STATIC, NULL);
+	index->hashmask = numbuckets - 1;
+	index->namefirst = Z_Malloc(numbuckets * sizeof (UINT16), PU_STATIC, NULL);
+	index->longnamefirst = Z_Malloc(numbuckets * sizeof (UINT16), PU_STATIC, NULL);
+	index->fullnamefirst = Z_Malloc(numbuckets * sizeof (UINT16), PU_STATIC, NULL);
+	memset(index->namefirst, 0xFF, numbuckets * sizeof (UINT16));
+	memset(index->longnamefirst, 0xFF, numbuckets * sizeof (UINT16));
+	memset(index->fullnamefirst, 0xFF, numbuckets * sizeof (UINT16));
+	index->namenext = Z_Malloc(wadfile->numlumps * sizeof (UINT16), PU_STATIC, NULL);
+	index->longnamenext = Z_Malloc(wadfile->numlumps * sizeof (UINT16), PU_STATIC, NULL);
+	index->fullnamenext = Z_Malloc(wadfile->numlumps * sizeof (UINT16), PU_STATIC, NULL);
+
+	// Link backwards, so each chain ends up in lump order
+	for (i = wadfile->numlumps; i--;)
+	{
+		lumpinfo_t *lump_p = wadfile->lumpinfo + i;
+
+		bucket = W_HashName(lump_p->name, 8) & index->hashmask;
+		index->namenext[i] = index->namefirst[bucket];
+		index->namefirst[bucket] = i;
+
+		bucket = W_HashName(lump_p->longname, WHOLENAME) & index->hashmask;
+		index->longnamenext[i] = index->longnamefirst[bucket];
+		index->longnamefirst[bucket] = i;
+
+		bucket = W_HashName(lump_p->fullname, WHOLENAME) & index->hashmask;
+		index->fullnamenext[i] = index->fullnamefirst[bucket];
+		index->fullnamefirst[bucket] = i;
+	}
+
+	if (wadfile->type == RET_PK3)
+	{
+		index->folderfirst = Z_Malloc(numbuckets * sizeof (UINT32), PU_STATIC, NULL);
+		memset(index->folderfirst, 0xFF, numbuckets * sizeof (UINT32));
+
+		// Every path up to a '/' is a folder
+		for (i = 0; i < wadfile->numlumps; i++)
+		{
+			const char *fullname = wadfile->lumpinfo[i].fullname;
+			for (j = 0; fullname[j]; j++)
+				if (fullname[j] == '/')
+					W_IndexFolder(index, wadfile->lumpinfo, i, j + 1);
+		}
+	}
+
+	wadfile->index = index;
+}
+
+static void W_FreeLumpIndex(lumpindex_t *index)
+{
+	Z_Free(index->namefirst);
+	Z_Free(index->namenext);
+	Z_Free(index->longnamefirst);
+	Z_Free(index->longnamenext);
+	Z_Free(index->fullnamefirst);
+	Z_Free(index->fullnamenext);
+	if (index->folderfirst)
+		Z_Free(index->folderfirst);
+	if (index->folders)
+		Z_Free(index->folders);
+	Z_Free(index);
+}
+
+// Finds a folder of a PK3 from its path, trailing '/' included.
+static lumpfolder_t *W_FindLumpFolder(UINT16 wad, const char *path, size_t length)
+{
+	lumpindex_t *index = wadfiles[wad]->index;
+	UINT32 i;
+
+	if (!index->folderfirst)
+		return NULL;
+
+	for (i = index->folderfirst[W_HashName(path, length) & index->hashmask]; i != UINT32_MAX; i = index->folders[i].next)
+	{
+		lumpfolder_t *folder = &index->folders[i];
+		if (folder->length == length && !strnicmp(wadfiles[wad]->lumpinfo[folder->first].fullname, path, length))
+			return folder;
+	}
+
+	return NULL;
+}
+
 //===========================================================================
 //                                                                    GLOBALS
 //===========================================================================
@@ -111,11 +300,18 @@ wadfile_t *wadfiles[MAX_WADFILES]; // 0 to numwadfiles-1 are valid
 // being ejected
 void W_Shutdown(void)
 {
+	W_StopDecompressWorkers();
+
 	while (numwadfiles--)
 	{
 		wadfile_t *wad = wadfiles[numwadfiles];
 
+#ifdef HAVE_MMAP
+		if (wad->mapping)
+			munmap(wad->mapping, wad->filesize);
+#endif
 		fclose(wad->handle);
+		W_FreeLumpIndex(wad->index);
 		Z_Free(wad->filename);
 		while (wad->numlumps--)
 		{
@@ -285,7 +481,317 @@ static inline void W_LoadDehackedLumps(UINT16 wadnum, boolean mainfile)
 #endif
 }
 
+#ifndef NOMD5
+//
+// File MD5 cache
+//
+// Hashing every added file is slow with big addons, so the MD5s are kept,
+// in memory and in MD5CACHEFILE in srb2home, along with the size and
+// modification time of the file they were made from. Files that haven't
+// changed since are not read again.
+//
+// W_InitMultipleFiles hashes the files that aren't cached yet on worker
+// threads before adding them one by one. The workers only touch the cache
+// under md5cache_mutex, and use malloc rather than the zone.
+//
+
+#define MD5CACHEFILE "md5cache.dat"
+#define MD5CACHEBUCKETS 256
+#define MD5WORKERS 4
+
+typedef struct md5cache_s
+{
+	char *path;
+	UINT32 size;
+	unsigned long mtime;
+	UINT8 md5sum[16];
+	struct md5cache_s *next;
+} md5cache_t;
+
+static md5cache_t *md5cache[MD5CACHEBUCKETS];
+static boolean md5cacheloaded = false;
+static boolean md5cachedirty = false; // has entries MD5CACHEFILE doesn't
+static boolean md5cachebatch = false; // save only once the batch is done
+
+#ifdef HAVE_THREADS
+static I_mutex md5cache_mutex;
+static I_cond md5workers_cond;
+
+#  define Lock_md5cache()   I_lock_mutex(&md5cache_mutex)
+#  define Unlock_md5cache() I_unlock_mutex(md5cache_mutex)
+#else/*HAVE_THREADS*/
+#  define Lock_md5cache()
+#  define Unlock_md5cache()
+#endif/*HAVE_THREADS*/
+
+static UINT32 W_HashPath(const char *path)
+{
+	UINT32 hash = 5381;
+	while (*path)
+		hash = hash * 33 + (UINT8)*path++;
+	return hash % MD5CACHEBUCKETS;
+}
+
+// Gets what the cache is keyed on besides the path.
+static boolean W_GetFileStamp(const char *path, UINT32 *size, unsigned long *mtime)
+{
+	struct stat st;
+
+	if (stat(path, &st) != 0)
+		return false;
+
+	*size = (UINT32)st.st_size;
+	*mtime = (unsigned long)st.st_mtime;
+	return true;
+}
+
+// Call with the cache locked.
+static md5cache_t *W_FindMD5Cache(const char *path)
+{
+	md5cache_t *entry;
+
+	for (entry = md5cache[W_HashPath(path)]; entry; entry = entry->next)
+		if (!strcmp(entry->path, path))
+			return entry;
+
+	return NULL;
+}
+
+// Call with the cache locked.
+static void W_PutMD5Cache(const char *path, UINT32 size, unsigned long mtime, const UINT8 *md5sum)
+{
+	md5cache_t *entry = W_FindMD5Cache(path);
+
+	if (!entry)
+	{
+		UINT32 bucket = W_HashPath(path);
+
+		entry = malloc(sizeof (*entry));
+		if (!entry)
+			return;
+		entry->path = malloc(strlen(path) + 1);
+		if (!entry->path)
+		{
+			free(entry);
+			return;
+		}
+		strcpy(entry->path, path);
+		entry->next = md5cache[bucket];
+		md5cache[bucket] = entry;
+	}
+
+	entry->size = size;
+	entry->mtime = mtime;
+	memcpy(entry->md5sum, md5sum, 16);
+	md5cachedirty = true;
+}
+
+static void W_LoadMD5Cache(void)
+{
+	FILE *f;
+	char line[MAX_WADPATH + 64];
+
+	md5cacheloaded = true;
+
+	f = fopen(va("%s" PATHSEP MD5CACHEFILE, srb2home), "r");
+	if (!f)
+		return;
+
+	// One file per line: md5 size mtime path
+	while (fgets(line, sizeof line, f))
+	{
+		UINT8 md5sum[16];
+		unsigned int size;
+		unsigned long mtime;
+		char *path;
+		size_t i;
+
+		for (i = 0; i < 32; i++)
+		{
+			char c = (char)tolower(line[i]);
+			UINT8 nibble;
+
+			if (c >= '0' && c <= '9')
+				nibble = (UINT8)(c - '0');
+			else if (c >= 'a' && c <= 'f')
+				nibble = (UINT8)(c - 'a' + 10);
+			else
+				break;
+
+			if (i & 1)
+				md5sum[i/2] |= nibble;
+			else
+				md5sum[i/2] = (UINT8)(nibble << 4);
+		}
+
+		if (i < 32 || sscanf(line + 32, " %u %lu", &size, &mtime) != 2)
+			continue;
+
+		// The path is the rest of the line, past the third space
+		path = strchr(line + 33, ' ');
+		if (path)
+			path = strchr(path + 1, ' ');
+		if (!path++)
+			continue;
+		path[strcspn(path, "\r\n")] = '\0';
+
+		W_PutMD5Cache(path, (UINT32)size, mtime, md5sum);
+	}
+
+	fclose(f);
+	md5cachedirty = false;
+}
+
+static void W_SaveMD5Cache(void)
+{
+	FILE *f;
+	md5cache_t *entry;
+	size_t i, j;
+
+	if (!md5cachedirty)
+		return;
+
+	f = fopen(va("%s" PATHSEP MD5CACHEFILE, srb2home), "w");
+	if (!f)
+		return;
+
+	for (i = 0; i < MD5CACHEBUCKETS; i++)
+		for (entry = md5cache[i]; entry; entry = entry->next)
+		{
+			for (j = 0; j < 16; j++)
+				fprintf(f, "%02x", entry->md5sum[j]);
+			fprintf(f, " %u %lu %s\n", entry->size, entry->mtime, entry->path);
+		}
+
+	fclose(f);
+	md5cachedirty = false;
+}
+
+// Doesn't use the zone or the console, so workers can call it.
+static boolean W_HashFile(const char *filename, void *resblock)
+{
+	FILE *fhandle;
+	int ret;
+
+	if ((fhandle = fopen(filename, "rb")) == NULL)
+		return false;
+
+	ret = md5_stream(fhandle, resblock);
+	fclose(fhandle);
+	return (ret == 0);
+}
+
+#ifdef HAVE_THREADS
+static const char **md5jobs;
+static size_t nummd5jobs, nextmd5job;
+static INT32 nummd5workers;
+
+static void W_MD5Worker(void *userdata)
+{
+	(void)userdata;
+
+	for (;;)
+	{
+		const char *filename = NULL;
+		UINT32 size;
+		unsigned long mtime;
+		UINT8 md5sum[16];
+
+		Lock_md5cache();
+		{
+			if (nextmd5job < nummd5jobs && !I_thread_is_stopped())
+				filename = md5jobs[nextmd5job++];
+		}
+		Unlock_md5cache();
+
+		if (!filename)
+			break;
+
+		if (!W_GetFileStamp(filename, &size, &mtime) || !W_HashFile(filename, md5sum))
+			continue; // W_InitFile will complain about it
+
+		Lock_md5cache();
+		{
+			W_PutMD5Cache(filename, size, mtime, md5sum);
+		}
+		Unlock_md5cache();
+	}
+
+	Lock_md5cache();
+	{
+		nummd5workers--;
+		I_wake_all_cond(&md5workers_cond);
+	}
+	Unlock_md5cache();
+}
+#endif
+
+/** Makes sure the MD5s of a list of files are in the cache, hashing the
+  * files that aren't on worker threads.
+  *
+  * \param filenames A null-terminated list of files.
+  * \sa W_MakeFileMD5
+  */
+static void W_HashMultipleFiles(char **filenames)
+{
+#ifdef HAVE_THREADS
+	size_t i, numfiles = 0;
+	INT32 numworkers;
+
+	if (!md5cacheloaded)
+		W_LoadMD5Cache();
+
+	while (filenames[numfiles])
+		numfiles++;
+
+	md5jobs = malloc(numfiles * sizeof (*md5jobs));
+	if (!md5jobs)
+		return;
+
+	nummd5jobs = nextmd5job = 0;
+	for (i = 0; i < numfiles; i++)
+	{
+		md5cache_t *entry = W_FindMD5Cache(filenames[i]);
+		UINT32 size;
+		unsigned long mtime;
+
+		if (!W_GetFileStamp(filenames[i], &size, &mtime))
+			continue; // it has to be looked for, let W_InitFile do it
+		if (entry && entry->size == size && entry->mtime == mtime)
+			continue;
+
+		md5jobs[nummd5jobs++] = filenames[i];
+	}
+
+	// Not worth a thread for one file
+	if (nummd5jobs > 1)
+	{
+		numworkers = (INT32)min(nummd5jobs, MD5WORKERS);
+		CONS_Debug(DBG_SETUP, "Making MD5s for %s files on %d threads\n", sizeu1(nummd5jobs), numworkers);
+
+		Lock_md5cache();
+		{
+			nummd5workers = numworkers;
+			for (i = 0; i < (size_t)numworkers; i++)
+				I_spawn_thread("md5-worker", W_MD5Worker, NULL);
+
+			while (nummd5workers)
+				I_hold_cond(&md5workers_cond, md5cache_mutex);
+		}
+		Unlock_md5cache();
+	}
+
+	free(md5jobs);
+	md5jobs = NULL;
+	nummd5jobs = nextmd5job = 0;
+#else
+	(void)filenames;
+#endif
+}
+#endif/*NOMD5*/
+
 /** Compute MD5 message digest for bytes read from STREAM of this filname.
+  * Unchanged files are looked up in the MD5 cache instead of being read.
   *
   * The resulting message digest number will be written into the 16 bytes
   * beginning at RESBLOCK.
@@ -294,26 +800,59 @@ static inline void W_LoadDehackedLumps(UINT16 wadnum, boolean mainfile)
   * \param resblock resulting MD5 checksum
   * \return 0 if MD5 checksum was made, and is at resblock, 1 if error was found
   */
-static inline INT32 W_MakeFileMD5(const char *filename, void *resblock)
+INT32 W_MakeFileMD5(const char *filename, void *resblock)
 {
 #ifdef NOMD5
 	(void)filename;
 	memset(resblock, 0x00, 16);
 #else
-	FILE *fhandle;
+	UINT32 size;
+	unsigned long mtime;
+	boolean stamped;
+	tic_t t;
 
-	if ((fhandle = fopen(filename, "rb")) != NULL)
+	if (!md5cacheloaded)
+		W_LoadMD5Cache();
+
+	stamped = W_GetFileStamp(filename, &size, &mtime);
+	if (stamped)
 	{
-		tic_t t = I_GetTime();
-		CONS_Debug(DBG_SETUP, "Making MD5 for %s\n",filename);
-		if (md5_stream(fhandle, resblock) == 1)
+		md5cache_t *entry;
+		boolean found = false;
+
+		Lock_md5cache();
 		{
-			fclose(fhandle);
-			return 1;
+			entry = W_FindMD5Cache(filename);
+			if (entry && entry->size == size && entry->mtime == mtime)
+			{
+				memcpy(resblock, entry->md5sum, 16);
+				found = true;
+			}
 		}
+		Unlock_md5cache();
+
+		if (found)
+			return 0;
+	}
+
+	t = I_GetTime();
+	CONS_Debug(DBG_SETUP, "Making MD5 for %s\n",filename);
+	if (W_HashFile(filename, resblock))
+	{
 		CONS_Debug(DBG_SETUP, "MD5 calc for %s took %f seconds\n",
 			filename, (float)(I_GetTime() - t)/NEWTICRATE);
-		fclose(fhandle);
+
+		if (stamped)
+		{
+			Lock_md5cache();
+			{
+				W_PutMD5Cache(filename, size, mtime, resblock);
+			}
+			Unlock_md5cache();
+
+			if (!md5cachebatch)
+				W_SaveMD5Cache();
+		}
 		return 0;
 	}
 #endif
@@ -677,6 +1216,35 @@ static lumpinfo_t* ResGetLumpsZip (FILE* handle, UINT16* nlmp)
 	return lumpinfo;
 }
 
+/** Maps a whole wad file into memory, read-only, so that its uncompressed
+  * lumps can be read without going through the FILE * handle.
+  * Disabled with the -nommap parameter.
+  *
+  * \param handle The opened wad file.
+  * \param filesize Size of the file, in bytes.
+  * \return The mapping, or NULL if the file couldn't be mapped.
+  * \sa W_GetMappedLumpPwad
+  */
+static UINT8 *W_MapWadFile(FILE *handle, UINT32 filesize)
+{
+#ifdef HAVE_MMAP
+	void *mapping;
+
+	if (!filesize || M_CheckParm("-nommap"))
+		return NULL;
+
+	mapping = mmap(NULL, filesize, PROT_READ, MAP_PRIVATE, fileno(handle), 0);
+	if (mapping == MAP_FAILED)
+		return NULL;
+
+	return mapping;
+#else
+	(void)handle;
+	(void)filesize;
+	return NULL;
+#endif
+}
+
 static UINT16 W_InitFileError (const char *filename, boolean exitworthy)
 {
 	if (exitworthy)
@@ -822,7 +1390,9 @@ UINT16 W_InitFile(const char *filename, boolean mainfile, boolean startup)
 	wadfile->important = important;
 	fseek(handle, 0, SEEK_END);
 	wadfile->filesize = (unsigned)ftell(handle);
+	wadfile->mapping = W_MapWadFile(handle, wadfile->filesize);
 	wadfile->type = type;
+	W_BuildLumpIndex(wadfile);
 
 	// already generated, just copy it over
 	M_Memcpy(&wadfile->md5sum, &md5sum, 16);
@@ -889,12 +1459,22 @@ UINT16 W_InitFile(const char *filename, boolean mainfile, boolean startup)
   */
 void W_InitMultipleFiles(char **filenames)
 {
+#ifndef NOMD5
+	md5cachebatch = true;
+	W_HashMultipleFiles(filenames);
+#endif
+
 	// will be realloced as lumps are added
 	for (; *filenames; filenames++)
 	{
 		//CONS_Debug(DBG_SETUP, "Loading %s\n", *filenames);
 		W_InitFile(*filenames, numwadfiles < mainwads, true);
 	}
+
+#ifndef NOMD5
+	md5cachebatch = false;
+	W_SaveMD5Cache();
+#endif
 }
 
 /** Make sure a lump number is valid.
@@ -952,9 +1532,9 @@ UINT16 W_CheckNumForNamePwad(const char *name, UINT16 wad, UINT16 startlump)
 	//
 	if (startlump < wadfiles[wad]->numlumps)
 	{
-		lumpinfo_t *lump_p = wadfiles[wad]->lumpinfo + startlump;
-		for (i = startlump; i < wadfiles[wad]->numlumps; i++, lump_p++)
-			if (!strncmp(lump_p->name, uname, sizeof(uname) - 1))
+		lumpindex_t *index = wadfiles[wad]->index;
+		for (i = index->namefirst[W_HashName(uname, 8) & index->hashmask]; i != LUMPINDEX_NONE; i = index->namenext[i])
+			if (i >= startlump && !strncmp(wadfiles[wad]->lumpinfo[i].name, uname, sizeof(uname) - 1))
 				return i;
 	}
 
@@ -986,9 +1566,9 @@ UINT16 W_CheckNumForLongNamePwad(const char *name, UINT16 wad, UINT16 startlump)
 	//
 	if (startlump < wadfiles[wad]->numlumps)
 	{
-		lumpinfo_t *lump_p = wadfiles[wad]->lumpinfo + startlump;
-		for (i = startlump; i < wadfiles[wad]->numlumps; i++, lump_p++)
-			if (!strcmp(lump_p->longname, uname))
+		lumpindex_t *index = wadfiles[wad]->index;
+		for (i = index->longnamefirst[W_HashName(uname, WHOLENAME) & index->hashmask]; i != LUMPINDEX_NONE; i = index->longnamenext[i])
+			if (i >= startlump && !strcmp(wadfiles[wad]->lumpinfo[i].longname, uname))
 				return i;
 	}
 
@@ -1011,8 +1591,26 @@ UINT16 W_CheckNumForFolderStartPK3(const char *name, UINT16 wad, UINT16 startlum
 {
 	size_t name_length;
 	INT32 i;
-	lumpinfo_t *lump_p = wadfiles[wad]->lumpinfo + startlump;
+	lumpinfo_t *lump_p;
 	name_length = strlen(name);
+
+	// Whole folders can be found in the index
+	if (name_length && name[name_length - 1] == '/' && startlump < wadfiles[wad]->numlumps)
+	{
+		lumpfolder_t *folder = W_FindLumpFolder(wad, name, name_length);
+		if (!folder)
+			return wadfiles[wad]->numlumps;
+		if (startlump <= folder->first)
+		{
+			i = folder->first;
+			/* SLADE is special and puts a single directory entry. Skip that. */
+			if (strlen(wadfiles[wad]->lumpinfo[i].fullname) == name_length)
+				i++;
+			return i;
+		}
+	}
+
+	lump_p = wadfiles[wad]->lumpinfo + startlump;
 	for (i = startlump; i < wadfiles[wad]->numlumps; i++, lump_p++)
 	{
 		if (strnicmp(name, lump_p->fullname, name_length) == 0)
@@ -1032,7 +1630,18 @@ UINT16 W_CheckNumForFolderStartPK3(const char *name, UINT16 wad, UINT16 startlum
 UINT16 W_CheckNumForFolderEndPK3(const char *name, UINT16 wad, UINT16 startlump)
 {
 	INT32 i;
-	lumpinfo_t *lump_p = wadfiles[wad]->lumpinfo + startlump;
+	size_t name_length = strlen(name);
+	lumpinfo_t *lump_p;
+
+	// Starting inside the folder's first run of lumps?
+	if (name_length && name[name_length - 1] == '/')
+	{
+		lumpfolder_t *folder = W_FindLumpFolder(wad, name, name_length);
+		if (folder && startlump >= folder->first && startlump <= folder->end)
+			return folder->end;
+	}
+
+	lump_p = wadfiles[wad]->lumpinfo + startlump;
 	for (i = startlump; i < wadfiles[wad]->numlumps; i++, lump_p++)
 	{
 		if (strnicmp(name, lump_p->fullname, strlen(name)))
@@ -1042,11 +1651,20 @@ UINT16 W_CheckNumForFolderEndPK3(const char *name, UINT16 wad, UINT16 startlump)
 }
 
 // In a PK3 type of resource file, it looks for an entry with the specified full name.
+// An exact match (ignoring case) is looked up in the index first; failing that,
+// the first entry the name is a beginning of is returned.
 // Returns lump position in PK3's lumpinfo, or INT16_MAX if not found.
 UINT16 W_CheckNumForFullNamePK3(const char *name, UINT16 wad, UINT16 startlump)
 {
 	INT32 i;
-	lumpinfo_t *lump_p = wadfiles[wad]->lumpinfo + startlump;
+	lumpinfo_t *lump_p;
+	lumpindex_t *index = wadfiles[wad]->index;
+
+	for (i = index->fullnamefirst[W_HashName(name, WHOLENAME) & index->hashmask]; i != LUMPINDEX_NONE; i = index->fullnamenext[i])
+		if (i >= startlump && !stricmp(wadfiles[wad]->lumpinfo[i].fullname, name))
+			return i;
+
+	lump_p = wadfiles[wad]->lumpinfo + startlump;
 	for (i = startlump; i < wadfiles[wad]->numlumps; i++, lump_p++)
 	{
 		if (!strnicmp(name, lump_p->fullname, strlen(name)))
@@ -1163,7 +1781,8 @@ lumpnum_t W_CheckNumForMap(const char *name)
 	{
 		if (wadfiles[i]->type == RET_WAD)
 		{
-			for (lumpNum = 0; lumpNum < wadfiles[i]->numlumps; lumpNum++)
+			lumpindex_t *index = wadfiles[i]->index;
+			for (lumpNum = index->namefirst[W_HashName(name, 8) & index->hashmask]; lumpNum != LUMPINDEX_NONE; lumpNum = index->namenext[lumpNum])
 				if (!strncmp(name, (wadfiles[i]->lumpinfo + lumpNum)->name, 8))
 					return (i<<16) + lumpNum;
 		}
@@ -1252,12 +1871,14 @@ lumpnum_t W_CheckNumForNameInBlock(const char *name, const char *blockstart, con
 #include "fastcmp.h"
 UINT8 W_LumpExists(const char *name)
 {
-	INT32 i,j;
+	INT32 i;
+	UINT16 j;
+	UINT32 hash = W_HashName(name, WHOLENAME);
 	for (i = numwadfiles - 1; i >= 0; i--)
 	{
-		lumpinfo_t *lump_p = wadfiles[i]->lumpinfo;
-		for (j = 0; j < wadfiles[i]->numlumps; ++j, ++lump_p)
-			if (fastcmp(lump_p->longname, name))
+		lumpindex_t *index = wadfiles[i]->index;
+		for (j = index->longnamefirst[hash & index->hashmask]; j != LUMPINDEX_NONE; j = index->longnamenext[j])
+			if (fastcmp(wadfiles[i]->lumpinfo[j].longname, name))
 				return true;
 	}
 	return false;
@@ -1341,22 +1962,499 @@ void zerr(int ret)
 }
 #endif
 
-/** Reads bytes from the head of a lump.
-  * Note: If the lump is compressed, the whole thing has to be read anyway.
-  *
-  * \param wad Wad number to read from.
-  * \param lump Lump number to read from.
-  * \param dest Buffer in memory to serve as destination.
-  * \param size Number of bytes to read.
-  * \param offest Number of bytes to offset.
+// Where a lump's raw (on-disk) data starts in its file's mapping,
+// or NULL if the file isn't mapped or the lump runs past its end.
+static UINT8 *W_MappedRawLump(const wadfile_t *wadfile, const lumpinfo_t *l, size_t rawsize)
+{
+	if (!wadfile->mapping || l->position > wadfile->filesize || rawsize > wadfile->filesize - l->position)
+		return NULL;
+	return wadfile->mapping + l->position;
+}
+
+//
+// Decompressed lump cache
+//
+// Compressed lumps are kept decompressed in a bounded LRU cache, so that
+// reading just the header of one, or reading it again after its zone copy
+// got purged, doesn't inflate it all over again.
+//
+// W_PrefetchLumpPwad queues lumps that are about to be needed (see
+// R_PrefetchLevel) for worker threads to decompress, straight out of the
+// file's mapping, while the main thread gets on with something else. When
+// the main thread gets to a lump that is still queued, it decompresses it
+// itself instead of waiting its turn. The workers don't use the zone or the
+// console, and only touch the cache under decompcache_mutex.
+//
+
+#define DECOMPCACHESIZE (32<<20) // decompressed bytes kept around
+#define DECOMPCACHEBUCKETS 1024
+#define DECOMPWORKERS 2
+
+typedef enum
+{
+	DL_QUEUED, // waiting for a worker
+	DL_WORKING, // being decompressed
+	DL_READY, // data is valid
+	DL_FAILED, // let the main thread retry and complain
+} decompstate_t;
+
+typedef struct decomplump_s
+{
+	UINT16 wad, lump;
+	decompstate_t state;
+	UINT8 *data; // malloc'd, lumpinfo size bytes
+
+	struct decomplump_s *hashnext; // same bucket
+	struct decomplump_s *lruprev, *lrunext; // most recently used first
+	struct decomplump_s *jobnext; // work queue
+} decomplump_t;
+
+static decomplump_t *decompbuckets[DECOMPCACHEBUCKETS];
+static decomplump_t *decomplruhead, *decomplrutail;
+static size_t decompcachebytes; // in DL_READY lumps
+static size_t decomppendingbytes; // in DL_QUEUED and DL_WORKING lumps
+
+#ifdef HAVE_THREADS
+static decomplump_t *decompjobhead, *decompjobtail;
+static I_mutex decompcache_mutex;
+static I_cond decompcache_cond; // a lump became ready, or a worker quit
+static INT32 numdecompworkers;
+static boolean decompstopping;
+
+#  define Lock_decompcache()   I_lock_mutex(&decompcache_mutex)
+#  define Unlock_decompcache() I_unlock_mutex(decompcache_mutex)
+#else/*HAVE_THREADS*/
+#  define Lock_decompcache()
+#  define Unlock_decompcache()
+#endif/*HAVE_THREADS*/
+
+#define DECOMPBUCKET(wad, lump) ((((UINT32)(wad) << 16) | (lump)) % DECOMPCACHEBUCKETS)
+
+/** Decompresses a whole lump. Doesn't use the zone or the console, so the
+  * workers can call it.
+  *
+  * \param l The lump.
+  * \param raw Its compressed data.
+  * \param dest Where to put the decompressed data, l->size bytes.
+  * \param error Set to errno for LZF, or the zlib error for DEFLATE, on failure.
+  * \return Number of bytes decompressed, 0 on failure.
+  */
+static size_t W_DecompressLump(const lumpinfo_t *l, void *raw, void *dest, int *error)
+{
+	*error = 0;
+
+	switch (l->compression)
+	{
+#ifdef ZWAD
+	case CM_LZF:
+		{
+			size_t retval;
+#ifndef AVOID_ERRNO
+			errno = 0;
+#endif
+			retval = lzf_decompress(raw, l->disksize, dest, l->size);
+#ifndef AVOID_ERRNO
+			if (retval == 0)
+				*error = errno;
+#endif
+			return retval;
+		}
+#endif
+#ifdef HAVE_ZLIB
+	case CM_DEFLATE:
+		{
+			int zErr;
+			z_stream strm;
+
+			strm.zalloc = Z_NULL;
+			strm.zfree = Z_NULL;
+			strm.opaque = Z_NULL;
+
+			strm.total_in = strm.avail_in = l->disksize;
+			strm.total_out = strm.avail_out = l->size;
+
+			strm.next_in = raw; // inflate never writes to its input
+			strm.next_out = dest;
+
+			zErr = inflateInit2(&strm, -15);
+			if (zErr == Z_OK)
+			{
+				zErr = inflate(&strm, Z_FINISH);
+				(void)inflateEnd(&strm);
+				if (zErr == Z_STREAM_END)
+					return l->size;
+			}
+			*error = zErr;
+			return 0;
+		}
+#endif
+	default:
+		return 0;
+	}
+}
+
+// All of these are to be called with the cache locked.
+static decomplump_t *W_FindDecompressedLump(UINT16 wad, UINT16 lump)
+{
+	decomplump_t *dl;
+
+	for (dl = decompbuckets[DECOMPBUCKET(wad, lump)]; dl; dl = dl->hashnext)
+		if (dl->wad == wad && dl->lump == lump)
+			return dl;
+
+	return NULL;
+}
+
+static void W_UnlinkDecompressedLumpLRU(decomplump_t *dl)
+{
+	if (dl->lruprev)
+		dl->lruprev->lrunext = dl->lrunext;
+	else
+		decomplruhead = dl->lrunext;
+	if (dl->lrunext)
+		dl->lrunext->lruprev = dl->lruprev;
+	else
+		decomplrutail = dl->lruprev;
+}
+
+static void W_TouchDecompressedLump(decomplump_t *dl)
+{
+	if (decomplruhead == dl)
+		return;
+
+	W_UnlinkDecompressedLumpLRU(dl);
+	dl->lruprev = NULL;
+	dl->lrunext = decomplruhead;
+	if (decomplruhead)
+		decomplruhead->lruprev = dl;
+	decomplruhead = dl;
+	if (!decomplrutail)
+		decomplrutail = dl;
+}
+
+static decomplump_t *W_NewDecompressedLump(UINT16 wad, UINT16 lump, decompstate_t state)
+{
+	decomplump_t *dl = malloc(sizeof (*dl));
+	UINT32 bucket = DECOMPBUCKET(wad, lump);
+
+	if (!dl)
+		return NULL;
+
+	dl->wad = wad;
+	dl->lump = lump;
+	dl->state = state;
+	dl->data = NULL;
+	dl->jobnext = NULL;
+
+	dl->hashnext = decompbuckets[bucket];
+	decompbuckets[bucket] = dl;
+
+	dl->lruprev = NULL;
+	dl->lrunext = decomplruhead;
+	if (decomplruhead)
+		decomplruhead->lruprev = dl;
+	decomplruhead = dl;
+	if (!decomplrutail)
+		decomplrutail = dl;
+
+	return dl;
+}
+
+static void W_FreeDecompressedLump(decomplump_t *dl)
+{
+	decomplump_t **link = &decompbuckets[DECOMPBUCKET(dl->wad, dl->lump)];
+
+	while (*link != dl)
+		link = &(*link)->hashnext;
+	*link = dl->hashnext;
+
+	W_UnlinkDecompressedLumpLRU(dl);
+
+	if (dl->state == DL_READY)
+		decompcachebytes -= wadfiles[dl->wad]->lumpinfo[dl->lump].size;
+	free(dl->data);
+	free(dl);
+}
+
+// Throws out the least recently used lumps until the cache fits its budget.
+// keep is the lump that was just filled in; the caller still holds it.
+static void W_TrimDecompressedLumps(const decomplump_t *keep)
+{
+	decomplump_t *dl = decomplrutail;
+
+	while (dl && decompcachebytes > DECOMPCACHESIZE)
+	{
+		decomplump_t *prev = dl->lruprev;
+		if (dl != keep && (dl->state == DL_READY || dl->state == DL_FAILED))
+			W_FreeDecompressedLump(dl);
+		dl = prev;
+	}
+}
+
+static void W_SetDecompressedLumpData(decomplump_t *dl, UINT8 *data)
+{
+	if (dl->state == DL_QUEUED || dl->state == DL_WORKING)
+		decomppendingbytes -= wadfiles[dl->wad]->lumpinfo[dl->lump].size;
+
+	if (data)
+	{
+		dl->data = data;
+		dl->state = DL_READY;
+		decompcachebytes += wadfiles[dl->wad]->lumpinfo[dl->lump].size;
+		W_TrimDecompressedLumps(dl);
+	}
+	else
+		dl->state = DL_FAILED;
+}
+
+#ifdef HAVE_THREADS
+static void W_DecompressWorker(void *userdata)
+{
+	(void)userdata;
+
+	for (;;)
+	{
+		decomplump_t *dl = NULL;
+		const lumpinfo_t *l;
+		UINT8 *raw, *data;
+		int error;
+
+		Lock_decompcache();
+		{
+			// Skip over the lumps the main thread took for itself
+			while (decompjobhead && !decompstopping && !I_thread_is_stopped())
+			{
+				dl = decompjobhead;
+				decompjobhead = dl->jobnext;
+				if (!decompjobhead)
+					decompjobtail = NULL;
+
+				if (dl->state == DL_QUEUED)
+				{
+					dl->state = DL_WORKING;
+					break;
+				}
+				dl = NULL;
+			}
+
+			if (!dl)
+			{
+				numdecompworkers--;
+				I_wake_all_cond(&decompcache_cond);
+			}
+		}
+		Unlock_decompcache();
+
+		if (!dl)
+			return;
+
+		l = wadfiles[dl->wad]->lumpinfo + dl->lump;
+		raw = W_MappedRawLump(wadfiles[dl->wad], l, l->disksize);
+		data = malloc(l->size);
+		if (data && (!raw || W_DecompressLump(l, raw, data, &error) != l->size))
+		{
+			free(data);
+			data = NULL;
+		}
+
+		Lock_decompcache();
+		{
+			W_SetDecompressedLumpData(dl, data);
+			I_wake_all_cond(&decompcache_cond);
+		}
+		Unlock_decompcache();
+	}
+}
+#endif
+
+// Waits for the workers to be done, so the files can be closed.
+static void W_StopDecompressWorkers(void)
+{
+#ifdef HAVE_THREADS
+	// After I_stop_threads, they are all gone already
+	if (I_thread_is_stopped())
+		return;
+
+	Lock_decompcache();
+	{
+		decompstopping = true;
+		while (numdecompworkers)
+			I_hold_cond(&decompcache_cond, decompcache_mutex);
+	}
+	Unlock_decompcache();
+#endif
+}
+
+/** Queues a compressed lump to be decompressed in the background, so that
+  * reading it later is just a copy. Does nothing if the lump isn't
+  * compressed, is already in the cache, or its file isn't mapped.
+  *
+  * \param wad Wad number of the lump.
+  * \param lump Lump number in that wad.
+  * \sa W_ReadLumpHeaderPwad
+  */
+void W_PrefetchLumpPwad(UINT16 wad, UINT16 lump)
+{
+#ifdef HAVE_THREADS
+	lumpinfo_t *l;
+
+	if (!TestValidLump(wad, lump))
+		return;
+
+	l = wadfiles[wad]->lumpinfo + lump;
+	if (l->compression == CM_NOCOMPRESSION || !l->size
+		|| !W_MappedRawLump(wadfiles[wad], l, l->disksize))
+		return;
+
+	Lock_decompcache();
+	{
+		if (!decompstopping && !W_FindDecompressedLump(wad, lump)
+			&& decomppendingbytes + l->size <= DECOMPCACHESIZE)
+		{
+			decomplump_t *dl = W_NewDecompressedLump(wad, lump, DL_QUEUED);
+			if (dl)
+			{
+				decomppendingbytes += l->size;
+				if (decompjobtail)
+					decompjobtail->jobnext = dl;
+				else
+					decompjobhead = dl;
+				decompjobtail = dl;
+
+				if (numdecompworkers < DECOMPWORKERS)
+				{
+					numdecompworkers++;
+					I_spawn_thread("decompress-lumps", W_DecompressWorker, NULL);
+				}
+			}
+		}
+	}
+	Unlock_decompcache();
+#else
+	(void)wad;
+	(void)lump;
+#endif
+}
+
+void W_PrefetchLump(lumpnum_t lumpnum)
+{
+	W_PrefetchLumpPwad(WADFILENUM(lumpnum), LUMPNUM(lumpnum));
+}
+
+/** Copies part of a compressed lump out of the decompressed lump cache.
+  * A lump that is still queued gets decompressed right away, and one a
+  * worker is on gets waited for.
+  *
+  * \return true if dest was filled, false if the lump has to be decompressed
+  *         by the caller.
+  */
+static boolean W_ReadDecompressedLump(UINT16 wad, UINT16 lump, void *dest, size_t size, size_t offset)
+{
+	decomplump_t *dl;
+	boolean done = false;
+
+	Lock_decompcache();
+	{
+		for (;;)
+		{
+			dl = W_FindDecompressedLump(wad, lump);
+			if (!dl || dl->state == DL_FAILED)
+				break;
+
+			if (dl->state == DL_READY)
+			{
+				M_Memcpy(dest, dl->data + offset, size);
+				W_TouchDecompressedLump(dl);
+				done = true;
+				break;
+			}
+
+#ifdef HAVE_THREADS
+			if (dl->state == DL_WORKING)
+			{
+				I_hold_cond(&decompcache_cond, decompcache_mutex);
+				continue;
+			}
+
+			// Still queued, don't wait for it
+			{
+				const lumpinfo_t *l = wadfiles[wad]->lumpinfo + lump;
+				UINT8 *data;
+				int error;
+
+				dl->state = DL_WORKING;
+				Unlock_decompcache();
+
+				data = malloc(l->size);
+				if (data && W_DecompressLump(l, W_MappedRawLump(wadfiles[wad], l, l->disksize), data, &error) != l->size)
+				{
+					free(data);
+					data = NULL;
+				}
+
+				Lock_decompcache();
+				W_SetDecompressedLumpData(dl, data);
+				I_wake_all_cond(&decompcache_cond);
+			}
+#else
+			break;
+#endif
+		}
+	}
+	Unlock_decompcache();
+
+	return done;
+}
+
+// Hands a lump the main thread decompressed over to the cache.
+static void W_PutDecompressedLump(UINT16 wad, UINT16 lump, UINT8 *data)
+{
+	decomplump_t *dl;
+
+	if (wadfiles[wad]->lumpinfo[lump].size > DECOMPCACHESIZE/4)
+	{
+		free(data); // not worth pushing everything else out
+		return;
+	}
+
+	Lock_decompcache();
+	{
+		dl = W_FindDecompressedLump(wad, lump);
+		if (!dl)
+			dl = W_NewDecompressedLump(wad, lump, DL_FAILED);
+
+		if (dl && (dl->state == DL_FAILED))
+		{
+			W_TouchDecompressedLump(dl);
+			W_SetDecompressedLumpData(dl, data);
+			data = NULL;
+		}
+	}
+	Unlock_decompcache();
+
+	free(data); // someone beat us to it
+}
+
+/** Reads bytes from the head of a lump.
+  * Note: If the lump is compressed, the whole thing has to be read anyway.
+  * It is then kept in the decompressed lump cache for later reads.
+  * If the wad file is memory-mapped, the lump is copied or decompressed
+  * straight from the mapping instead of being read through the file handle.
+  *
+  * \param wad Wad number to read from.
+  * \param lump Lump number to read from.
+  * \param dest Buffer in memory to serve as destination.
+  * \param size Number of bytes to read.
+  * \param offest Number of bytes to offset.
   * \return Number of bytes read (should equal size).
-  * \sa W_ReadLump, W_RawReadLumpHeader
+  * \sa W_ReadLump, W_RawReadLumpHeader, W_GetMappedLumpPwad, W_PrefetchLumpPwad
   */
 size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, size_t offset)
 {
 	size_t lumpsize;
 	lumpinfo_t *l;
 	FILE *handle;
+	UINT8 *mapped;
 
 	if (!TestValidLump(wad,lump))
 		return 0;
@@ -1370,46 +2468,73 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 	if (!size || size+offset > lumpsize)
 		size = lumpsize - offset;
 
-	// Let's get the raw lump data.
-	// We setup the desired file handle to read the lump data.
 	l = wadfiles[wad]->lumpinfo + lump;
+
+	// Already decompressed?
+	if (l->compression != CM_NOCOMPRESSION && W_ReadDecompressedLump(wad, lump, dest, size, offset))
+	{
+#ifdef NO_PNG_LUMPS
+		if (Picture_IsLumpPNG((UINT8 *)dest, size))
+			Picture_ThrowPNGError(l->fullname, wadfiles[wad]->filename);
+#endif
+		return size;
+	}
+
+	// Let's get the raw lump data.
+	// If the file is mapped, the raw data is already in memory; otherwise,
+	// we setup the desired file handle to read the lump data.
 	handle = wadfiles[wad]->handle;
-	fseek(handle, (long)(l->position + offset), SEEK_SET);
+	mapped = W_MappedRawLump(wadfiles[wad], l, (l->compression == CM_NOCOMPRESSION) ? lumpsize : l->disksize);
+	if (!mapped)
+		fseek(handle, (long)(l->position + ((l->compression == CM_NOCOMPRESSION) ? offset : 0)), SEEK_SET);
 
 	// But let's not copy it yet. We support different compression formats on lumps, so we need to take that into account.
 	switch(wadfiles[wad]->lumpinfo[lump].compression)
 	{
 	case CM_NOCOMPRESSION:		// If it's uncompressed, we directly write the data into our destination, and return the bytes read.
-#ifdef NO_PNG_LUMPS
 		{
-			size_t bytesread = fread(dest, 1, size, handle);
+			size_t bytesread;
+			if (mapped)
+			{
+				M_Memcpy(dest, mapped + offset, size);
+				bytesread = size;
+			}
+			else
+				bytesread = fread(dest, 1, size, handle);
+#ifdef NO_PNG_LUMPS
 			if (Picture_IsLumpPNG((UINT8 *)dest, bytesread))
 				Picture_ThrowPNGError(l->fullname, wadfiles[wad]->filename);
+#endif
 			return bytesread;
 		}
-#else
-		return fread(dest, 1, size, handle);
-#endif
 	case CM_LZF:		// Is it LZF compressed? Used by ZWADs.
 		{
 #ifdef ZWAD
-			char *rawData; // The lump's raw data.
-			char *decData; // Lump's decompressed real data.
+			char *rawData = NULL; // The lump's raw data.
+			UINT8 *decData; // Lump's decompressed real data.
 			size_t retval; // Helper var, lzf_decompress returns 0 when an error occurs.
+			int error;
 
-			rawData = Z_Malloc(l->disksize, PU_STATIC, NULL);
-			decData = Z_Malloc(l->size, PU_STATIC, NULL);
+			decData = malloc(l->size);
+			if (!decData) // Did we get no data at all?
+				I_Error("wad %d, lump %d: out of memory decompressing", wad, lump);
 
-			if (fread(rawData, 1, l->disksize, handle) < l->disksize)
-				I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
-			retval = lzf_decompress(rawData, l->disksize, decData, l->size);
+			if (!mapped)
+			{
+				rawData = Z_Malloc(l->disksize, PU_STATIC, NULL);
+				if (fread(rawData, 1, l->disksize, handle) < l->disksize)
+					I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
+			}
+			retval = W_DecompressLump(l, mapped ? (void *)mapped : rawData, decData, &error);
+			if (rawData)
+				Z_Free(rawData);
 #ifndef AVOID_ERRNO
 			if (retval == 0) // If this was returned, check if errno was set
 			{
 				// errno is a global var set by the lzf functions when something goes wrong.
-				if (errno == E2BIG)
+				if (error == E2BIG)
 					I_Error("wad %d, lump %d: compressed data too big (bigger than %s)", wad, lump, sizeu1(l->size));
-				else if (errno == EINVAL)
+				else if (error == EINVAL)
 					I_Error("wad %d, lump %d: invalid compressed data", wad, lump);
 			}
 			// Otherwise, fall back on below error (if zero was actually the correct size then ???)
@@ -1419,11 +2544,8 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 				I_Error("wad %d, lump %d: decompressed to wrong number of bytes (expected %s, got %s)", wad, lump, sizeu1(l->size), sizeu2(retval));
 			}
 
-			if (!decData) // Did we get no data at all?
-				return 0;
 			M_Memcpy(dest, decData + offset, size);
-			Z_Free(rawData);
-			Z_Free(decData);
+			W_PutDecompressedLump(wad, lump, decData);
 #ifdef NO_PNG_LUMPS
 			if (Picture_IsLumpPNG((UINT8 *)dest, size))
 				Picture_ThrowPNGError(l->fullname, wadfiles[wad]->filename);
@@ -1438,54 +2560,35 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 #ifdef HAVE_ZLIB
 	case CM_DEFLATE: // Is it compressed via DEFLATE? Very common in ZIPs/PK3s, also what most doom-related editors support.
 		{
-			UINT8 *rawData; // The lump's raw data.
+			UINT8 *rawData = NULL; // The lump's raw data.
 			UINT8 *decData; // Lump's decompressed real data.
-
 			int zErr; // Helper var.
-			z_stream strm;
-			unsigned long rawSize = l->disksize;
-			unsigned long decSize = l->size;
 
-			rawData = Z_Malloc(rawSize, PU_STATIC, NULL);
-			decData = Z_Malloc(decSize, PU_STATIC, NULL);
+			decData = malloc(l->size);
+			if (!decData)
+				I_Error("wad %d, lump %d: out of memory decompressing", wad, lump);
 
-			if (fread(rawData, 1, rawSize, handle) < rawSize)
-				I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
-
-			strm.zalloc = Z_NULL;
-			strm.zfree = Z_NULL;
-			strm.opaque = Z_NULL;
-
-			strm.total_in = strm.avail_in = rawSize;
-			strm.total_out = strm.avail_out = decSize;
-
-			strm.next_in = rawData;
-			strm.next_out = decData;
-
-			zErr = inflateInit2(&strm, -15);
-			if (zErr == Z_OK)
+			if (!mapped)
 			{
-				zErr = inflate(&strm, Z_FINISH);
-				if (zErr == Z_STREAM_END)
-				{
-					M_Memcpy(dest, decData, size);
-				}
-				else
-				{
-					size = 0;
-					zerr(zErr);
-				}
+				rawData = Z_Malloc(l->disksize, PU_STATIC, NULL);
+				if (fread(rawData, 1, l->disksize, handle) < l->disksize)
+					I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
+			}
 
-				(void)inflateEnd(&strm);
+			if (W_DecompressLump(l, mapped ? mapped : rawData, decData, &zErr) == l->size)
+			{
+				M_Memcpy(dest, decData + offset, size);
+				W_PutDecompressedLump(wad, lump, decData);
 			}
 			else
 			{
 				size = 0;
 				zerr(zErr);
+				free(decData);
 			}
 
-			Z_Free(rawData);
-			Z_Free(decData);
+			if (rawData)
+				Z_Free(rawData);
 
 #ifdef NO_PNG_LUMPS
 			if (Picture_IsLumpPNG((UINT8 *)dest, size))
@@ -1522,6 +2625,40 @@ void W_ReadLumpPwad(UINT16 wad, UINT16 lump, void *dest)
 	W_ReadLumpHeaderPwad(wad, lump, dest, 0, 0);
 }
 
+/** Gets an uncompressed lump straight from its memory-mapped wad file,
+  * without copying it anywhere.
+  *
+  * \param wad Wad number to look in.
+  * \param lump Lump number to get.
+  * \return Read-only pointer to the lump's data, or NULL if the lump is
+  *         empty, compressed or in a file that isn't mapped; use
+  *         W_ReadLumpPwad or W_CacheLumpNumPwad in that case.
+  * \sa W_ReadLumpHeaderPwad
+  */
+static UINT8 *W_MappedLumpPwad(UINT16 wad, UINT16 lump)
+{
+	lumpinfo_t *l;
+
+	if (!TestValidLump(wad, lump))
+		return NULL;
+
+	l = wadfiles[wad]->lumpinfo + lump;
+	if (!l->size || l->compression != CM_NOCOMPRESSION)
+		return NULL;
+
+	return W_MappedRawLump(wadfiles[wad], l, l->size);
+}
+
+const void *W_GetMappedLumpPwad(UINT16 wad, UINT16 lump)
+{
+	return W_MappedLumpPwad(wad, lump);
+}
+
+const void *W_GetMappedLump(lumpnum_t lumpnum)
+{
+	return W_GetMappedLumpPwad(WADFILENUM(lumpnum), LUMPNUM(lumpnum));
+}
+
 // ==========================================================================
 // W_CacheLumpNum
 // ==========================================================================
@@ -2088,6 +3225,31 @@ int W_VerifyNMUSlumps(const char *filename)
 	return W_VerifyFile(filename, NMUSlist, false);
 }
 
+/** \brief Fills a virtual lump with its data.
+ *
+ * Binary map lumps in memory-mapped files are used right where they are.
+ * Everything else, including TEXTMAP which is parsed as a string, gets
+ * copied.
+ *
+ * \param vlump Virtual lump, with its name and size already set
+ * \param data Lump data to use or copy
+ * \param mapped Whether data is in a mapped file
+ */
+static void vres_SetData(virtlump_t *vlump, UINT8 *data, boolean mapped)
+{
+	if (mapped && !fastcmp(vlump->name, "TEXTMAP"))
+	{
+		vlump->data = data;
+		vlump->mapped = true;
+		return;
+	}
+
+	vlump->data = Z_Malloc(vlump->size + 1, PU_LEVEL, NULL);
+	memcpy(vlump->data, data, vlump->size);
+	vlump->data[vlump->size] = '\0';
+	vlump->mapped = false;
+}
+
 /** \brief Generates a virtual resource used for level data loading.
  *
  * \param lumpnum_t reference
@@ -2104,7 +3266,9 @@ virtres_t* vres_GetMap(lumpnum_t lumpnum)
 	if (W_IsLumpWad(lumpnum))
 	{
 		// Remember that we're assuming that the WAD will have a specific set of lumps in a specific order.
-		UINT8 *wadData = W_CacheLumpNum(lumpnum, PU_LEVEL);
+		UINT8 *mapped = W_MappedLumpPwad(WADFILENUM(lumpnum), LUMPNUM(lumpnum));
+		UINT8 *wadData = mapped ? mapped : W_CacheLumpNum(lumpnum, PU_LEVEL);
+		size_t wadSize = W_LumpLength(lumpnum);
 		filelump_t *fileinfo = (filelump_t *)(wadData + ((wadinfo_t *)wadData)->infotableofs);
 		numlumps = ((wadinfo_t *)wadData)->numlumps;
 		vlumps = Z_Malloc(sizeof(virtlump_t)*numlumps, PU_LEVEL, NULL);
@@ -2116,11 +3280,12 @@ virtres_t* vres_GetMap(lumpnum_t lumpnum)
 			// Play it safe with the name in this case.
 			memcpy(vlumps[i].name, (fileinfo + i)->name, 8);
 			vlumps[i].name[8] = '\0';
-			vlumps[i].data = Z_Malloc(vlumps[i].size, PU_LEVEL, NULL); // This is memory inefficient, sorry about that.
-			memcpy(vlumps[i].data, wadData + (fileinfo + i)->filepos, vlumps[i].size);
+			vres_SetData(&vlumps[i], wadData + (fileinfo + i)->filepos,
+				mapped && (fileinfo + i)->filepos <= wadSize && vlumps[i].size <= wadSize - (fileinfo + i)->filepos);
 		}
 
-		Z_Free(wadData);
+		if (!mapped)
+			Z_Free(wadData);
 	}
 	else
 	{
@@ -2134,10 +3299,18 @@ virtres_t* vres_GetMap(lumpnum_t lumpnum)
 		vlumps = Z_Malloc(sizeof(virtlump_t)*numlumps, PU_LEVEL, NULL);
 		for (i = 0; i < numlumps; i++, lumpnum++)
 		{
+			UINT8 *mapped = W_MappedLumpPwad(WADFILENUM(lumpnum), LUMPNUM(lumpnum));
+
 			vlumps[i].size = W_LumpLength(lumpnum);
 			memcpy(vlumps[i].name, W_CheckNameForNum(lumpnum), 8);
 			vlumps[i].name[8] = '\0';
-			vlumps[i].data = W_CacheLumpNum(lumpnum, PU_LEVEL);
+			if (mapped)
+				vres_SetData(&vlumps[i], mapped, true);
+			else
+			{
+				vlumps[i].data = W_CacheLumpNum(lumpnum, PU_LEVEL);
+				vlumps[i].mapped = false;
+			}
 		}
 	}
 	vres = Z_Malloc(sizeof(virtres_t), PU_LEVEL, NULL);
@@ -2154,7 +3327,8 @@ virtres_t* vres_GetMap(lumpnum_t lumpnum)
 void vres_Free(virtres_t* vres)
 {
 	while (vres->numlumps--)
-		Z_Free(vres->vlumps[vres->numlumps].data);
+		if (!vres->vlumps[vres->numlumps].mapped)
+			Z_Free(vres->vlumps[vres->numlumps].data);
 	Z_Free(vres->vlumps);
 	Z_Free(vres);
 }
@@ -81,6 +81,7 @@ typedef struct {
 	char name[9];
 	UINT8* data;
 	size_t size;
+	boolean mapped; // data points into a mapped wad file, don't free it
 } virtlump_t;
 
 typedef struct {
@@ -128,6 +129,8 @@ typedef struct wadfile_s
 #endif
 	UINT16 numlumps; // this wad's number of resources
 	FILE *handle;
+	UINT8 *mapping; // read-only mapping of the whole file, NULL if the file isn't mapped
+	struct lumpindex_s *index; // hashed lump names, for the W_CheckNumFor* functions
 	UINT32 filesize; // for network
 	UINT8 md5sum[16];
 
@@ -149,6 +152,9 @@ FILE *W_OpenWadFile(const char **filename, boolean useerrors);
 // Load and add a wadfile to the active wad files, returns numbers of lumps, INT16_MAX on error
 UINT16 W_InitFile(const char *filename, boolean mainfile, boolean startup);
 
+// MD5 of a file, from the MD5 cache if the file hasn't changed since it was last hashed
+INT32 W_MakeFileMD5(const char *filename, void *resblock);
+
 // W_InitMultipleFiles exits if a file was not found, but not if all is okay.
 void W_InitMultipleFiles(char **filenames);
 
@@ -188,6 +194,16 @@ size_t W_ReadLumpHeader(lumpnum_t lump, void *dest, size_t size, size_t offest);
 void W_ReadLumpPwad(UINT16 wad, UINT16 lump, void *dest);
 void W_ReadLump(lumpnum_t lump, void *dest);
 
+// Decompresses a compressed lump in the background, ahead of reading it
+void W_PrefetchLumpPwad(UINT16 wad, UINT16 lump);
+void W_PrefetchLump(lumpnum_t lumpnum);
+
+// Zero-copy access to uncompressed lumps of memory-mapped files;
+// returns NULL if the lump has to be read with the functions above instead.
+// The data is read-only and must not be freed.
+const void *W_GetMappedLumpPwad(UINT16 wad, UINT16 lump);
+const void *W_GetMappedLump(lumpnum_t lumpnum);
+
 void *W_CacheLumpNumPwad(UINT16 wad, UINT16 lump, INT32 tag);
 void *W_CacheLumpNum(lumpnum_t lump, INT32 tag);
 void *W_CacheLumpNumForce(lumpnum_t lumpnum, INT32 tag);
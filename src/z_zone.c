@@ -83,12 +83,68 @@ typedef struct memblock_s
 	struct memblock_s *next, *prev;
 } ATTRPACK memblock_t;
 
-// both the head and tail of the zone memory block list
-static memblock_t head;
+// Every tag has its own block list, so freeing or measuring a tag only
+// has to visit that tag's blocks. Tags past the known ones all share the
+// last list, whose blocks are still checked one by one.
+#define NUMTAGLISTS (PU_HWRMODELTEXTURE_UNLOCKED + 1)
+#define TAGLIST(tag) ((UINT32)(tag) < NUMTAGLISTS ? (UINT32)(tag) : NUMTAGLISTS)
+
+// both the head and tail of each tag's block list
+static memblock_t taglists[NUMTAGLISTS + 1];
+
+// bytes allocated in each tag list, blocks included
+static size_t tagusage[NUMTAGLISTS + 1];
+
+// running totals, never reset, for measuring a stretch of play
+static UINT32 totalblockallocs, totalpoolallocs;
+static UINT64 totalblockbytes;
+
+#define ZPOOLID 0xa441d13e
+
+// Pooled objects get a header laid out exactly like memhdr_t,
+// so Z_Free can tell them apart from regular blocks by the id.
+typedef struct
+{
+	zpool_t *pool; // The pool this object belongs to
+	UINT32 id; // Should be ZPOOLID
+} ATTRPACK poolhdr_t;
+
+// Slots start on a cache line, and the object follows the header.
+#define ZPOOL_ALIGNBITS 6
+#define ZPOOL_ALIGN (1<<ZPOOL_ALIGNBITS)
+#define ZPOOL_HDRSIZE 16
+#define ZPOOL_SLABSIZE (64<<10)
+
+// all pools that have allocated memory at least once
+static zpool_t *pools = NULL;
+
+#define ZARENAID 0xa441d13f
+
+// Arena allocations remember their size, so they can be reallocated.
+// The id still comes last, right before the data.
+typedef struct
+{
+	size_t size; // Size of the data, in bytes
+	zarena_t *arena; // The arena this was carved out of
+	UINT32 id; // Should be ZARENAID
+} ATTRPACK arenahdr_t;
+
+#define ZARENA_ALIGNBITS 6
+#define ZARENA_ALIGN 16
+#define ZARENA_HDRSIZE 32
+#define ZARENA_CHUNKSIZE (1<<20)
+
+// all arenas that have allocated memory at least once
+static zarena_t *arenas = NULL;
+
+// Every kind of header ends with its id, so this tells them apart.
+#define HDRID(ptr) (((memhdr_t *)((UINT8 *)(ptr) - sizeof (memhdr_t)))->id)
 
 //
 // Function prototypes
 //
+static void Z_CheckTagList(INT32 i, memblock_t *list);
+static void *Z_ArenaRealloc(void *ptr, size_t size, INT32 tag, void *user, INT32 alignbits);
 static void Command_Memfree_f(void);
 #ifdef ZDEBUG
 static void Command_Memdump_f(void);
@@ -106,10 +162,13 @@ static void Command_Memdump_f(void);
 void Z_Init(void)
 {
 	UINT32 total, memfree;
+	size_t i;
 
-	memset(&head, 0x00, sizeof(head));
+	memset(taglists, 0x00, sizeof(taglists));
+	memset(tagusage, 0x00, sizeof(tagusage));
 
-	head.next = head.prev = &head;
+	for (i = 0; i <= NUMTAGLISTS; i++)
+		taglists[i].next = taglists[i].prev = &taglists[i];
 
 	memfree = I_GetFreeMem(&total)>>20;
 	CONS_Printf("System memory: %uMB - Free: %uMB\n", total>>20, memfree);
@@ -207,14 +266,29 @@ void Z_Free(void *ptr)
 #endif
 
 #ifdef ZDEBUG
-	block = Ptr2Memblock2(ptr, "Z_Free", file, line);
-#else
-	block = Ptr2Memblock(ptr, "Z_Free");
+	// Write every Z_Free call to a debug file.
+	CONS_Debug(DBG_MEMORY, "Z_Free at %s:%d\n", file, line);
+#endif
+
+	// Pooled objects and arena allocations have their own headers.
+#ifdef VALGRIND_MAKE_MEM_DEFINED
+	VALGRIND_MAKE_MEM_DEFINED((UINT8 *)ptr - sizeof (memhdr_t), sizeof (memhdr_t));
 #endif
+	if (HDRID(ptr) == ZPOOLID)
+	{
+		// Mobjs and the like may have Lua userdata attached.
+		if (((poolhdr_t *)((UINT8 *)ptr - sizeof (poolhdr_t)))->pool->tag != PU_LUA)
+			LUA_InvalidateUserdata(ptr);
+		Z_PoolFree(ptr);
+		return;
+	}
+	else if (HDRID(ptr) == ZARENAID)
+		return; // Only freed along with the whole arena.
 
 #ifdef ZDEBUG
-	// Write every Z_Free call to a debug file.
-	CONS_Debug(DBG_MEMORY, "Z_Free at %s:%d\n", file, line);
+	block = Ptr2Memblock2(ptr, "Z_Free", file, line);
+#else
+	block = Ptr2Memblock(ptr, "Z_Free");
 #endif
 
 	// anything that isn't by lua gets passed to lua just in case.
@@ -233,11 +307,34 @@ void Z_Free(void *ptr)
 #ifdef VALGRIND_DESTROY_MEMPOOL
 	VALGRIND_DESTROY_MEMPOOL(block);
 #endif
+	tagusage[TAGLIST(block->tag)] -= block->size + sizeof *block;
 	block->prev->next = block->next;
 	block->next->prev = block->prev;
 	free(block);
 }
 
+/** Returns a pooled object to its pool's free list.
+  * Unlike Z_Free, this skips invalidating Lua userdata, so it
+  * should only be used for objects that are never exposed to Lua.
+  *
+  * \param ptr A pointer to memory allocated with Z_PoolMalloc.
+  * \sa Z_Free, Z_PoolMalloc
+  */
+void Z_PoolFree(void *ptr)
+{
+	poolhdr_t *hdr = (poolhdr_t *)((UINT8 *)ptr - sizeof *hdr);
+	zpool_t *pool = hdr->pool;
+
+#ifdef PARANOIA
+	if (hdr->id != ZPOOLID)
+		I_Error("Z_PoolFree: wrong id");
+#endif
+
+	*(void **)ptr = pool->freelist;
+	pool->freelist = ptr;
+	pool->numused--;
+}
+
 /** malloc() that doesn't accept failure.
   *
   * \param size Amount of memory to be allocated, in bytes.
@@ -293,6 +390,7 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	memhdr_t *hdr;
 	void *given;
 	size_t blocksize = extrabytes + sizeof *hdr + size;
+	memblock_t *list = &taglists[TAGLIST(tag)];
 
 #ifdef ZDEBUG2
 	CONS_Debug(DBG_MEMORY, "Z_Malloc %s:%d\n", file, line);
@@ -319,9 +417,9 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	Z_calloc = false;
 #endif
 
-	block->next = head.next;
-	block->prev = &head;
-	head.next = block;
+	block->next = list->next;
+	block->prev = list;
+	list->next = block;
 	block->next->prev = block;
 
 	block->real = ptr;
@@ -334,6 +432,9 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 #endif
 	block->size = blocksize;
 	block->realsize = size;
+	tagusage[TAGLIST(tag)] += blocksize + sizeof *block;
+	totalblockallocs++;
+	totalblockbytes += size;
 
 #ifdef VALGRIND_CREATE_MEMPOOL
 	VALGRIND_CREATE_MEMPOOL(block, padsize, Z_calloc);
@@ -435,6 +536,9 @@ void *Z_ReallocAlign(void *ptr, size_t size, INT32 tag, void *user, INT32 alignb
 #endif
 	}
 
+	if (HDRID(ptr) == ZARENAID)
+		return Z_ArenaRealloc(ptr, size, tag, user, alignbits);
+
 #ifdef ZDEBUG
 	block = Ptr2Memblock2(ptr, "Z_Realloc", file, line);
 #else
@@ -476,6 +580,231 @@ void *Z_ReallocAlign(void *ptr, size_t size, INT32 tag, void *user, INT32 alignb
 	return rez;
 }
 
+/** Allocates a new slab for a pool and puts all of its slots
+  * on the pool's free list.
+  *
+  * \param pool The pool to grow.
+  */
+static void Z_PoolGrow(zpool_t *pool)
+{
+	size_t i;
+	UINT8 *slab;
+	poolhdr_t *hdr;
+
+	if (!pool->registered)
+	{
+		if (ZPOOL_HDRSIZE < sizeof (poolhdr_t) || sizeof (poolhdr_t) != sizeof (memhdr_t))
+			I_Error("Z_PoolGrow: bad pool header size");
+		if (pool->size < sizeof (void *))
+			I_Error("Z_PoolGrow: %s objects are too small to pool", pool->name);
+		if (pool->tag >= PU_PURGELEVEL)
+			I_Error("Z_PoolGrow: %s pool cannot be purgable", pool->name);
+
+		pool->slotsize = (ZPOOL_HDRSIZE + pool->size + ZPOOL_ALIGN - 1) & ~(ZPOOL_ALIGN - 1);
+		pool->slabslots = ZPOOL_SLABSIZE / pool->slotsize;
+		if (pool->slabslots < 16)
+			pool->slabslots = 16;
+		pool->next = pools;
+		pools = pool;
+		pool->registered = true;
+	}
+
+	slab = Z_MallocAlign(pool->slabslots * pool->slotsize, pool->tag, NULL, ZPOOL_ALIGNBITS);
+	pool->numslabs++;
+
+	// Link the slots in reverse, so they get handed out in address order.
+	for (i = pool->slabslots; i-- > 0;)
+	{
+		UINT8 *obj = slab + i*pool->slotsize + ZPOOL_HDRSIZE;
+		hdr = (poolhdr_t *)(obj - sizeof *hdr);
+		hdr->pool = pool;
+		hdr->id = ZPOOLID;
+		*(void **)obj = pool->freelist;
+		pool->freelist = obj;
+	}
+}
+
+/** Allocates an object from a fixed-size pool.
+  * The contents of the object are undefined; use Z_PoolCalloc
+  * if they need to be zeroed.
+  *
+  * \param pool The pool to allocate from.
+  * \return A pointer to the object, which can be freed with Z_Free.
+  * \sa Z_PoolGrow, Z_Free
+  */
+void *Z_PoolMalloc(zpool_t *pool)
+{
+	void *ptr;
+
+	if (!pool->freelist)
+		Z_PoolGrow(pool);
+
+	ptr = pool->freelist;
+	pool->freelist = *(void **)ptr;
+
+	pool->numallocs++;
+	totalpoolallocs++;
+	if (++pool->numused > pool->peakused)
+		pool->peakused = pool->numused;
+
+	return ptr;
+}
+
+/** Forgets about all of a pool's objects.
+  * The slabs themselves are zone blocks and are freed by the caller.
+  *
+  * \param pool The pool to reset.
+  * \sa Z_FreeTags
+  */
+static void Z_PoolReset(zpool_t *pool)
+{
+	pool->freelist = NULL;
+	pool->numslabs = pool->numused = pool->peakused = 0;
+	pool->numallocs = 0;
+}
+
+/** Allocates a new chunk for an arena.
+  *
+  * \param arena The arena to grow.
+  * \param chunksize Size of the chunk, in bytes.
+  * \return A pointer to the start of the chunk.
+  */
+static UINT8 *Z_ArenaGrow(zarena_t *arena, size_t chunksize)
+{
+	if (!arena->registered)
+	{
+		if (ZARENA_HDRSIZE < sizeof (arenahdr_t) || ZARENA_HDRSIZE % ZARENA_ALIGN)
+			I_Error("Z_ArenaGrow: bad arena header size");
+		if (arena->tag >= PU_PURGELEVEL)
+			I_Error("Z_ArenaGrow: %s arena cannot be purgable", arena->name);
+
+		arena->next = arenas;
+		arenas = arena;
+		arena->registered = true;
+	}
+
+	arena->numchunks++;
+	arena->chunkbytes += chunksize;
+	return Z_MallocAlign(chunksize, arena->tag, NULL, ZARENA_ALIGNBITS);
+}
+
+/** Carves memory out of an arena. Allocations are laid out
+  * one after the other, in the order they were made.
+  *
+  * \param arena The arena to allocate from.
+  * \param size Amount of memory to be allocated, in bytes.
+  * \return A pointer to the allocated memory, which is not zeroed.
+  * \sa Z_ArenaCalloc
+  */
+void *Z_ArenaAlloc(zarena_t *arena, size_t size)
+{
+	size_t need = (ZARENA_HDRSIZE + size + ZARENA_ALIGN - 1) & ~(size_t)(ZARENA_ALIGN - 1);
+	arenahdr_t *hdr;
+	UINT8 *ptr;
+
+	if (need < size)/* overflow check */
+		I_Error("You are allocating memory too large!");
+
+	if (need > ZARENA_CHUNKSIZE)
+	{
+		// Too big to share; give it a chunk of its own and keep using the current one.
+		ptr = Z_ArenaGrow(arena, need) + ZARENA_HDRSIZE;
+		arena->last = NULL;
+	}
+	else
+	{
+		// Whatever is left of a full chunk is simply skipped.
+		if (!arena->pos || (size_t)(arena->end - arena->pos) < need)
+		{
+			arena->pos = Z_ArenaGrow(arena, ZARENA_CHUNKSIZE);
+			arena->end = arena->pos + ZARENA_CHUNKSIZE;
+		}
+
+		ptr = arena->pos + ZARENA_HDRSIZE;
+		arena->pos += need;
+		arena->last = ptr;
+	}
+	arena->used += need;
+
+	hdr = (arenahdr_t *)(ptr - sizeof *hdr);
+	hdr->size = size;
+	hdr->arena = arena;
+	hdr->id = ZARENAID;
+
+	return ptr;
+}
+
+/** Carves zeroed memory out of an arena.
+  *
+  * \param arena The arena to allocate from.
+  * \param size Amount of memory to be allocated, in bytes.
+  * \return A pointer to the allocated memory.
+  * \sa Z_ArenaAlloc
+  */
+void *Z_ArenaCalloc(zarena_t *arena, size_t size)
+{
+	return memset(Z_ArenaAlloc(arena, size), 0, size);
+}
+
+/** Z_ReallocAlign for memory from an arena.
+  * The arena's most recent allocation grows in place if there is room;
+  * anything else gets copied to a new allocation, and the old memory
+  * stays unused until the arena is freed.
+  *
+  * \sa Z_ReallocAlign
+  */
+static void *Z_ArenaRealloc(void *ptr, size_t size, INT32 tag, void *user, INT32 alignbits)
+{
+	arenahdr_t *hdr = (arenahdr_t *)((UINT8 *)ptr - sizeof *hdr);
+	zarena_t *arena = hdr->arena;
+	size_t copysize = min(size, hdr->size);
+	void *rez;
+
+	// Arenas don't track users or finer alignments, so leave those to the zone.
+	if (tag != arena->tag || user != NULL || alignbits > 4)
+		rez = Z_MallocAlign(size, tag, user, alignbits);
+	else if (ptr == arena->last)
+	{
+		size_t oldneed = (ZARENA_HDRSIZE + hdr->size + ZARENA_ALIGN - 1) & ~(size_t)(ZARENA_ALIGN - 1);
+		size_t need = (ZARENA_HDRSIZE + size + ZARENA_ALIGN - 1) & ~(size_t)(ZARENA_ALIGN - 1);
+		UINT8 *start = (UINT8 *)ptr - ZARENA_HDRSIZE;
+
+		if (need >= size && (size_t)(arena->end - start) >= need)
+		{
+			arena->pos = start + need;
+			arena->used += need;
+			arena->used -= oldneed;
+			if (size > hdr->size)
+				memset((UINT8 *)ptr + hdr->size, 0x00, size - hdr->size);
+			hdr->size = size;
+			return ptr;
+		}
+		rez = Z_ArenaAlloc(arena, size);
+	}
+	else
+		rez = Z_ArenaAlloc(arena, size);
+
+	M_Memcpy(rez, ptr, copysize);
+
+	if (size > copysize)
+		memset((UINT8 *)rez + copysize, 0x00, size - copysize);
+
+	return rez;
+}
+
+/** Forgets about all of an arena's memory.
+  * The chunks themselves are zone blocks and are freed by the caller.
+  *
+  * \param arena The arena to reset.
+  * \sa Z_FreeTags
+  */
+static void Z_ArenaReset(zarena_t *arena)
+{
+	arena->pos = arena->end = NULL;
+	arena->last = NULL;
+	arena->numchunks = arena->chunkbytes = arena->used = 0;
+}
+
 /** Frees all memory for a given set of tags.
   *
   * \param lowtag The lowest tag to consider.
@@ -483,15 +812,47 @@ void *Z_ReallocAlign(void *ptr, size_t size, INT32 tag, void *user, INT32 alignb
   */
 void Z_FreeTags(INT32 lowtag, INT32 hightag)
 {
-	memblock_t *block, *next;
+	memblock_t *list, *block, *next;
+	zpool_t *pool;
+	zarena_t *arena;
+	INT32 tag;
 
-	Z_CheckHeap(420);
-	for (block = head.next; block != &head; block = next)
-	{
-		next = block->next; // get link before freeing
+	if (lowtag > hightag)
+		return;
 
-		if (block->tag >= lowtag && block->tag <= hightag)
+	// Pooled objects and arena allocations are released
+	// in bulk along with their slabs and chunks.
+	for (pool = pools; pool; pool = pool->next)
+		if (pool->tag >= lowtag && pool->tag <= hightag)
+			Z_PoolReset(pool);
+	for (arena = arenas; arena; arena = arena->next)
+		if (arena->tag >= lowtag && arena->tag <= hightag)
+			Z_ArenaReset(arena);
+
+	// Every block in these lists has the list's tag, so free them all.
+	for (tag = max(lowtag, 0); tag <= min(hightag, NUMTAGLISTS - 1); tag++)
+	{
+		list = &taglists[tag];
+		Z_CheckTagList(420, list);
+		for (block = list->next; block != list; block = next)
+		{
+			next = block->next; // get link before freeing
 			Z_Free((UINT8 *)block->hdr + sizeof *block->hdr);
+		}
+	}
+
+	// Unknown tags are all lumped together, so check each block.
+	if (lowtag < 0 || hightag >= NUMTAGLISTS)
+	{
+		list = &taglists[NUMTAGLISTS];
+		Z_CheckTagList(420, list);
+		for (block = list->next; block != list; block = next)
+		{
+			next = block->next; // get link before freeing
+
+			if (block->tag >= lowtag && block->tag <= hightag)
+				Z_Free((UINT8 *)block->hdr + sizeof *block->hdr);
+		}
 	}
 }
 
@@ -550,19 +911,21 @@ void Z_CheckMemCleanup(void)
 }
 
 
-/** Checks the heap, as well as the memhdr_ts, for any corruption or
-  * other problems.
-  * \param i Identifies from where in the code Z_CheckHeap was called.
+/** Checks one tag's block list, as well as the memhdr_ts,
+  * for any corruption or other problems.
+  * \param i Identifies from where in the code the check was called.
+  * \param list The head of the list to check.
   * \author Graue <graue@oceanbase.org>
+  * \sa Z_CheckHeap
   */
-void Z_CheckHeap(INT32 i)
+static void Z_CheckTagList(INT32 i, memblock_t *list)
 {
 	memblock_t *block;
 	memhdr_t *hdr;
 	UINT32 blocknumon = 0;
 	void *given;
 
-	for (block = head.next; block != &head; block = block->next)
+	for (block = list->next; block != list; block = block->next)
 	{
 		blocknumon++;
 		hdr = block->hdr;
@@ -655,6 +1018,19 @@ void Z_CheckHeap(INT32 i)
 	}
 }
 
+/** Checks the heap, as well as the memhdr_ts, for any corruption or
+  * other problems.
+  * \param i Identifies from where in the code Z_CheckHeap was called.
+  * \sa Z_CheckTagList
+  */
+void Z_CheckHeap(INT32 i)
+{
+	size_t j;
+
+	for (j = 0; j <= NUMTAGLISTS; j++)
+		Z_CheckTagList(i, &taglists[j]);
+}
+
 // ------------------------
 // Zone memory modification
 // ------------------------
@@ -708,6 +1084,22 @@ void Z_ChangeTag(void *ptr, INT32 tag)
 		I_Error("Internal memory management error: "
 			"tried to make block purgable but it has no owner");
 
+	if (TAGLIST(tag) != TAGLIST(block->tag))
+	{
+		memblock_t *list = &taglists[TAGLIST(tag)];
+
+		// Move the block over to its new tag's list.
+		tagusage[TAGLIST(block->tag)] -= block->size + sizeof *block;
+		block->prev->next = block->next;
+		block->next->prev = block->prev;
+
+		block->next = list->next;
+		block->prev = list;
+		list->next = block;
+		block->next->prev = block;
+		tagusage[TAGLIST(tag)] += block->size + sizeof *block;
+	}
+
 	block->tag = tag;
 }
 
@@ -768,13 +1160,20 @@ void Z_SetUser(void *ptr, void **newuser)
 size_t Z_TagsUsage(INT32 lowtag, INT32 hightag)
 {
 	size_t cnt = 0;
-	memblock_t *rover;
+	memblock_t *rover, *list = &taglists[NUMTAGLISTS];
+	INT32 tag;
+
+	for (tag = max(lowtag, 0); tag <= min(hightag, NUMTAGLISTS - 1); tag++)
+		cnt += tagusage[tag];
 
-	for (rover = head.next; rover != &head; rover = rover->next)
+	if (lowtag < 0 || hightag >= NUMTAGLISTS)
 	{
-		if (rover->tag < lowtag || rover->tag > hightag)
-			continue;
-		cnt += rover->size + sizeof *rover;
+		for (rover = list->next; rover != list; rover = rover->next)
+		{
+			if (rover->tag < lowtag || rover->tag > hightag)
+				continue;
+			cnt += rover->size + sizeof *rover;
+		}
 	}
 
 	return cnt;
@@ -784,12 +1183,28 @@ size_t Z_TagsUsage(INT32 lowtag, INT32 hightag)
 // Miscellaneous functions
 // -----------------------
 
+/** Gets how much has been allocated since startup. Take the difference
+  * between two calls to see what happened in between.
+  *
+  * \param blocks Set to the number of zone blocks allocated.
+  * \param bytes Set to the total size of those blocks, headers excluded.
+  * \param objects Set to the number of pooled objects handed out.
+  */
+void Z_GetAllocCounts(UINT32 *blocks, UINT64 *bytes, UINT32 *objects)
+{
+	*blocks = totalblockallocs;
+	*bytes = totalblockbytes;
+	*objects = totalpoolallocs;
+}
+
 /** The function called by the "memfree" console command.
   * Prints the memory being used by each part of the game to the console.
   */
 static void Command_Memfree_f(void)
 {
 	UINT32 freebytes, totalbytes;
+	zpool_t *pool;
+	zarena_t *arena;
 
 	Z_CheckHeap(-1);
 	CONS_Printf("\x82%s", M_GetText("Memory Info\n"));
@@ -815,6 +1230,23 @@ static void Command_Memfree_f(void)
 	}
 #endif
 
+	if (pools)
+	{
+		CONS_Printf("\x82%s", M_GetText("Object Pool Info\n"));
+		for (pool = pools; pool; pool = pool->next)
+			CONS_Printf(M_GetText("%-18s: %7s KB, %s/%s used, %s peak\n"), pool->name,
+				sizeu1((pool->numslabs * pool->slabslots * pool->slotsize)>>10),
+				sizeu2(pool->numused), sizeu3(pool->numslabs * pool->slabslots), sizeu4(pool->peakused));
+	}
+
+	if (arenas)
+	{
+		CONS_Printf("\x82%s", M_GetText("Arena Info\n"));
+		for (arena = arenas; arena; arena = arena->next)
+			CONS_Printf(M_GetText("%-18s: %7s KB, %s KB used in %s chunks\n"), arena->name,
+				sizeu1(arena->chunkbytes>>10), sizeu2(arena->used>>10), sizeu3(arena->numchunks));
+	}
+
 	CONS_Printf("\x82%s", M_GetText("System Memory Info\n"));
 	freebytes = I_GetFreeMem(&totalbytes);
 	CONS_Printf(M_GetText("    Total physical memory: %7u KB\n"), totalbytes>>10);
@@ -829,7 +1261,9 @@ static void Command_Memfree_f(void)
   */
 static void Command_Memdump_f(void)
 {
-	memblock_t *block;
+	memblock_t *list, *block;
+	zpool_t *pool;
+	zarena_t *arena;
 	INT32 mintag = 0, maxtag = INT32_MAX;
 	INT32 i;
 
@@ -839,12 +1273,23 @@ static void Command_Memdump_f(void)
 	if ((i = COM_CheckParm("-max")))
 		maxtag = atoi(COM_Argv(i + 1));
 
-	for (block = head.next; block != &head; block = block->next)
-		if (block->tag >= mintag && block->tag <= maxtag)
-		{
-			char *filename = strrchr(block->ownerfile, PATHSEP[0]);
-			CONS_Printf("[%3d] %s (%s) bytes @ %s:%d\n", block->tag, sizeu1(block->size), sizeu2(block->realsize), filename ? filename + 1 : block->ownerfile, block->ownerline);
-		}
+	for (list = taglists; list <= &taglists[NUMTAGLISTS]; list++)
+		for (block = list->next; block != list; block = block->next)
+			if (block->tag >= mintag && block->tag <= maxtag)
+			{
+				char *filename = strrchr(block->ownerfile, PATHSEP[0]);
+				CONS_Printf("[%3d] %s (%s) bytes @ %s:%d\n", block->tag, sizeu1(block->size), sizeu2(block->realsize), filename ? filename + 1 : block->ownerfile, block->ownerline);
+			}
+
+	for (pool = pools; pool; pool = pool->next)
+		if (pool->tag >= mintag && pool->tag <= maxtag)
+			CONS_Printf("[%3d] pool %s: %s slabs, %s/%s objects of %s bytes, %u allocations\n", pool->tag, pool->name,
+				sizeu1(pool->numslabs), sizeu2(pool->numused), sizeu3(pool->numslabs * pool->slabslots), sizeu4(pool->slotsize), pool->numallocs);
+
+	for (arena = arenas; arena; arena = arena->next)
+		if (arena->tag >= mintag && arena->tag <= maxtag)
+			CONS_Printf("[%3d] arena %s: %s chunks, %s of %s bytes used\n", arena->tag, arena->name,
+				sizeu1(arena->numchunks), sizeu2(arena->used), sizeu3(arena->chunkbytes));
 }
 #endif
 
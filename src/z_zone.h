@@ -107,6 +107,75 @@ void *Z_ReallocAlign(void *ptr, size_t size, INT32 tag, void *user, INT32 alignb
 #define Z_FreeTag(tagnum) Z_FreeTags(tagnum, tagnum)
 void Z_FreeTags(INT32 lowtag, INT32 hightag);
 
+//
+// Fixed-size object pools
+//
+// Objects that are allocated and freed constantly during play (mobjs,
+// sector nodes, ...) are carved out of cache-line aligned slabs instead of
+// getting a zone block each. Freed objects go on the pool's free list and
+// are handed out again first. Pooled memory is released with Z_Free like
+// any other zone memory, and all of a pool's slabs are released at once
+// when its tag is freed with Z_FreeTags.
+//
+typedef struct zpool_s
+{
+	const char *name;
+	size_t size; // size of one object, in bytes
+	INT32 tag; // purge tag of the slabs
+
+	size_t slotsize; // object + header, rounded up to a cache line
+	size_t slabslots; // objects per slab
+	void *freelist; // objects ready to be handed out
+
+	// statistics, shown by "memfree"
+	size_t numslabs; // slabs currently allocated
+	size_t numused; // objects currently handed out
+	size_t peakused; // highest numused since the last release
+	UINT32 numallocs; // total objects handed out since the last release
+
+	struct zpool_s *next; // next registered pool
+	boolean registered;
+} zpool_t;
+
+// Static initializer: zpool_t mypool = Z_POOL("my objects", sizeof (myobj_t), PU_LEVEL);
+#define Z_POOL(name, size, tag) {name, size, tag, 0, 0, NULL, 0, 0, 0, 0, NULL, false}
+
+void *Z_PoolMalloc(zpool_t *pool);
+#define Z_PoolCalloc(pool) memset(Z_PoolMalloc(pool), 0, (pool)->size)
+void Z_PoolFree(void *ptr);
+
+//
+// Bump allocators
+//
+// Data that is all loaded together and thrown away together (like the level
+// geometry loaded by P_LoadLevel) is carved out of big chunks one allocation
+// after the other, which keeps it contiguous and in load order. Z_Free does
+// nothing on arena memory and Z_Realloc copies it as needed; the memory is
+// only released when the arena's tag is freed with Z_FreeTags.
+//
+typedef struct zarena_s
+{
+	const char *name;
+	INT32 tag; // purge tag of the chunks
+
+	UINT8 *pos, *end; // free space left in the current chunk
+	void *last; // most recent allocation, which can grow in place
+
+	// statistics, shown by "memfree"
+	size_t numchunks; // chunks currently allocated
+	size_t chunkbytes; // total size of those chunks
+	size_t used; // bytes handed out, headers included
+
+	struct zarena_s *next; // next registered arena
+	boolean registered;
+} zarena_t;
+
+// Static initializer: zarena_t myarena = Z_ARENA("my data", PU_LEVEL);
+#define Z_ARENA(name, tag) {name, tag, NULL, NULL, NULL, 0, 0, 0, NULL, false}
+
+void *Z_ArenaAlloc(zarena_t *arena, size_t size);
+void *Z_ArenaCalloc(zarena_t *arena, size_t size);
+
 //
 // Utility functions
 //
@@ -138,6 +207,9 @@ void Z_SetUser(void *ptr, void **newuser);
 size_t Z_TagsUsage(INT32 lowtag, INT32 hightag);
 #define Z_TotalUsage() Z_TagsUsage(0, INT32_MAX)
 
+// Allocations made since startup
+void Z_GetAllocCounts(UINT32 *blocks, UINT64 *bytes, UINT32 *objects);
+
 //
 // Miscellaneous functions
 //